@@ -0,0 +1,133 @@
+// In this program, we compare `zstl::bit_vector` with `std::vector<bool>`
+//   on a membership mask of `N` bits with about 30% of them set:
+//   bulk AND / XOR, popcount, random access, and rank/select queries
+// `std::vector<bool>` has no bulk operations or rank/select, so those are written
+//   as the bit-by-bit loops a caller would otherwise need; its rank is a prefix
+//   std::count and is only timed for a handful of queries
+
+#include <ZSTL/bit_vector.hpp>
+
+#include <iostream>
+#include <iomanip>
+#include <chrono>
+#include <random>
+#include <string>
+#include <vector>
+#include <algorithm>
+#include <cstdint>
+
+
+static constexpr std::size_t N { 1uz << 26 };
+static constexpr std::size_t QUERIES { 1uz << 20 };
+
+using clock_type = std::chrono::steady_clock;
+
+template <typename Func>
+static double ms(Func &&func) {
+    auto start = clock_type::now();
+    func();
+    return std::chrono::duration<double, std::milli>(clock_type::now() - start).count();
+}
+
+static void report(const std::string &name, double zstl, double std) {
+    std::cout << std::setw(24) << name
+        << std::fixed << std::setprecision(2)
+        << std::setw(14) << zstl
+        << std::setw(18) << std << '\n';
+}
+
+
+int main() {
+    std::mt19937_64 rng(42u);
+    std::bernoulli_distribution bit(0.3);
+
+    zstl::bit_vector a(N), b(N);
+    std::vector<bool> sa(N), sb(N);
+    for (std::size_t i { 0uz }; i < N; ++i) {
+        bool x = bit(rng);
+        bool y = bit(rng);
+        a.set(i, x);
+        b.set(i, y);
+        sa[i] = x;
+        sb[i] = y;
+    }
+
+    std::vector<std::size_t> positions(QUERIES);
+    for (std::size_t &p : positions) {
+        p = rng() % N;
+    }
+    std::size_t sink { 0uz };
+
+    std::cout << "bits: " << N << ", milliseconds (queries: " << QUERIES << ")\n";
+    std::cout << std::setw(24) << "operation"
+        << std::setw(14) << "bit_vector"
+        << std::setw(18) << "vector<bool>" << '\n';
+
+    report(
+        "and",
+        ms([&] { a &= b; }),
+        ms([&] {
+            for (std::size_t i { 0uz }; i < N; ++i) {
+                sa[i] = sa[i] && sb[i];
+            }
+        })
+    );
+    report(
+        "xor",
+        ms([&] { a ^= b; }),
+        ms([&] {
+            for (std::size_t i { 0uz }; i < N; ++i) {
+                sa[i] = sa[i] != sb[i];
+            }
+        })
+    );
+    report(
+        "count",
+        ms([&] { sink += a.count(); }),
+        ms([&] { sink += static_cast<std::size_t>(std::count(sa.begin(), sa.end(), true)); })
+    );
+    report(
+        "random test",
+        ms([&] {
+            for (std::size_t p : positions) {
+                sink += a[p];
+            }
+        }),
+        ms([&] {
+            for (std::size_t p : positions) {
+                sink += sa[p];
+            }
+        })
+    );
+
+    double build = ms([&] { a.build_rank_select(); });
+    std::cout << std::setw(24) << "build rank/select" << std::fixed << std::setprecision(2)
+        << std::setw(14) << build << std::setw(18) << "-" << '\n';
+
+    double rank = ms([&] {
+        for (std::size_t p : positions) {
+            sink += a.rank1(p);
+        }
+    });
+    // a prefix count per query: time 16 of them and scale up
+    double stdRank = ms([&] {
+        for (std::size_t q { 0uz }; q < 16uz; ++q) {
+            auto end = sa.begin() + static_cast<std::ptrdiff_t>(positions[q]);
+            sink += static_cast<std::size_t>(std::count(sa.begin(), end, true));
+        }
+    }) * (QUERIES / 16uz);
+    report("rank1", rank, stdRank);
+
+    std::size_t ones = a.count();
+    double select = ms([&] {
+        for (std::size_t p : positions) {
+            sink += a.select1(p % ones);
+        }
+    });
+    std::cout << std::setw(24) << "select1" << std::fixed << std::setprecision(2)
+        << std::setw(14) << select << std::setw(18) << "-" << '\n';
+
+    std::cout << "(checksum " << sink << ")" << std::endl;
+
+    return 0;
+}
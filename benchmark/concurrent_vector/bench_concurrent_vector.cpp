@@ -0,0 +1,116 @@
+// In this program, we measure multi-threaded append throughput of
+//   `zstl::concurrent_vector` (lock-free fetch_add + CAS segment install)
+//   against `zstl::vector` guarded by a `std::mutex`
+// Every thread appends `N_PER_THREAD` integers; we report millions of appends per second
+
+#include <ZSTL/vector.hpp>
+#include <ZSTL/concurrent_vector.hpp>
+
+#include <iostream>
+#include <iomanip>
+#include <chrono>
+#include <mutex>
+#include <thread>
+#include <vector>
+#include <cstdint>
+
+
+static constexpr std::size_t N_PER_THREAD { 1uz << 21 };
+
+template <typename Func>
+static double run_threads(unsigned nThreads, Func &&func) {
+    auto start = std::chrono::steady_clock::now();
+    {
+        std::vector<std::jthread> threads;
+        for (unsigned t = 0; t < nThreads; ++t) {
+            threads.emplace_back(func, t);
+        }
+    }
+    auto stop = std::chrono::steady_clock::now();
+
+    return std::chrono::duration<double>(stop - start).count();
+}
+
+static double bench_mutex_vector(unsigned nThreads) {
+    zstl::vector<std::uint64_t> v;
+    std::mutex m;
+
+    double seconds = run_threads(
+        nThreads,
+        [&](unsigned t) {
+            for (std::size_t i { 0uz }; i < N_PER_THREAD; ++i) {
+                std::lock_guard lock(m);
+                v.push_back(t * N_PER_THREAD + i);
+            }
+        }
+    );
+
+    if (v.size() != nThreads * N_PER_THREAD) {
+        std::cerr << "mutex vector lost elements" << std::endl;
+    }
+    return seconds;
+}
+
+static double bench_concurrent_vector(unsigned nThreads) {
+    zstl::concurrent_vector<std::uint64_t> v;
+
+    double seconds = run_threads(
+        nThreads,
+        [&](unsigned t) {
+            for (std::size_t i { 0uz }; i < N_PER_THREAD; ++i) {
+                v.push_back(t * N_PER_THREAD + i);
+            }
+        }
+    );
+
+    if (v.size() != nThreads * N_PER_THREAD) {
+        std::cerr << "concurrent_vector lost elements" << std::endl;
+    }
+    return seconds;
+}
+
+static double bench_concurrent_vector_grow_by(unsigned nThreads) {
+    static constexpr std::size_t BATCH { 256uz };
+    zstl::concurrent_vector<std::uint64_t> v;
+
+    double seconds = run_threads(
+        nThreads,
+        [&](unsigned t) {
+            for (std::size_t i { 0uz }; i < N_PER_THREAD; i += BATCH) {
+                v.grow_by(BATCH, t);
+            }
+        }
+    );
+
+    if (v.size() != nThreads * N_PER_THREAD) {
+        std::cerr << "concurrent_vector::grow_by lost elements" << std::endl;
+    }
+    return seconds;
+}
+
+
+int main() {
+    unsigned maxThreads = std::thread::hardware_concurrency();
+    if (maxThreads == 0u) {
+        maxThreads = 4u;
+    }
+
+    std::cout << "appends per thread: " << N_PER_THREAD << '\n';
+    std::cout << std::setw(8) << "threads"
+        << std::setw(20) << "vector+mutex"
+        << std::setw(20) << "concurrent_vector"
+        << std::setw(20) << "grow_by(256)"
+        << "   (M appends/s)" << '\n';
+
+    for (unsigned nThreads = 1u; nThreads <= maxThreads; nThreads *= 2u) {
+        double total = static_cast<double>(nThreads * N_PER_THREAD) / 1e6;
+        std::cout << std::setw(8) << nThreads
+            << std::fixed << std::setprecision(1)
+            << std::setw(20) << total / bench_mutex_vector(nThreads)
+            << std::setw(20) << total / bench_concurrent_vector(nThreads)
+            << std::setw(20) << total / bench_concurrent_vector_grow_by(nThreads)
+            << '\n';
+    }
+
+    return 0;
+}
@@ -0,0 +1,93 @@
+// In this program, we compare `zstl::devector` with `zstl::vector` and `std::deque`
+//   as the buffer of a sliding window: `N` samples stream through a window of
+//   `WINDOW` elements (push_back + pop_front), and the window is summed every
+//   `STRIDE` samples, which is where a contiguous buffer pays off
+// `zstl::vector` has no pop_front; its front erase is the std::move of the whole
+//   window one slot down that `erase(begin())` would do
+
+#include <ZSTL/devector.hpp>
+#include <ZSTL/vector.hpp>
+
+#include <iostream>
+#include <iomanip>
+#include <chrono>
+#include <string>
+#include <deque>
+#include <numeric>
+#include <algorithm> // std::move
+#include <cstdint>
+#include <cstddef>
+
+
+static constexpr std::size_t N { 1uz << 24 };
+static constexpr std::size_t WINDOW { 1uz << 12 };
+static constexpr std::size_t STRIDE { 1uz << 10 };
+
+using clock_type = std::chrono::steady_clock;
+
+template <typename Func>
+static double ms(Func &&func) {
+    auto start = clock_type::now();
+    func();
+    return std::chrono::duration<double, std::milli>(clock_type::now() - start).count();
+}
+
+static void report(const std::string &name, double time) {
+    std::cout << std::setw(16) << name
+        << std::fixed << std::setprecision(2)
+        << std::setw(14) << time << '\n';
+}
+
+
+int main() {
+    std::uint64_t sink { 0u };
+
+    std::cout << "samples: " << N << ", window: " << WINDOW
+        << ", summed every " << STRIDE << " samples, milliseconds\n";
+    std::cout << std::setw(16) << "container" << std::setw(14) << "time" << '\n';
+
+    report("devector", ms([&] {
+        zstl::devector<std::uint64_t> window;
+        for (std::uint64_t i { 0u }; i < N; ++i) {
+            window.push_back(i);
+            if (window.size() > WINDOW) {
+                window.pop_front();
+            }
+            if (i % STRIDE == 0u) {
+                sink += std::accumulate(window.begin(), window.end(), std::uint64_t { 0u });
+            }
+        }
+    }));
+
+    report("deque", ms([&] {
+        std::deque<std::uint64_t> window;
+        for (std::uint64_t i { 0u }; i < N; ++i) {
+            window.push_back(i);
+            if (window.size() > WINDOW) {
+                window.pop_front();
+            }
+            if (i % STRIDE == 0u) {
+                sink += std::accumulate(window.begin(), window.end(), std::uint64_t { 0u });
+            }
+        }
+    }));
+
+    // a hundredth of the samples, scaled up: every front erase moves the whole window
+    report("vector", ms([&] {
+        zstl::vector<std::uint64_t> window;
+        for (std::uint64_t i { 0u }; i < N / 100u; ++i) {
+            window.push_back(i);
+            if (window.size() > WINDOW) {
+                std::move(window.begin() + 1, window.end(), window.begin());
+                window.pop_back();
+            }
+            if (i % STRIDE == 0u) {
+                sink += std::accumulate(window.begin(), window.end(), std::uint64_t { 0u });
+            }
+        }
+    }) * 100.0);
+
+    std::cout << "(checksum " << sink << ")" << std::endl;
+
+    return 0;
+}
@@ -0,0 +1,140 @@
+// In this program, we compare `zstl::hive` with the two ways of erasing from
+//   `zstl::vector` under churn: a population of `N` particles loses and gains
+//   `CHURN` random members per round, and every round ends with a full scan
+// - hive: erase through a handle (the iterator returned by insert), insert reuses the hole
+// - vector erase: shifts the tail down, keeps the order (written out with std::move,
+//   `zstl::vector::erase` is not implemented yet)
+// - vector swap-and-pop: moves the last element into the hole, so every outstanding
+//   pointer to that element is silently redirected
+
+#include <ZSTL/hive.hpp>
+#include <ZSTL/vector.hpp>
+
+#include <iostream>
+#include <iomanip>
+#include <chrono>
+#include <random>
+#include <string>
+#include <vector>
+#include <algorithm> // std::move
+#include <cstddef>
+
+
+static constexpr std::size_t N { 1uz << 17 };
+static constexpr std::size_t CHURN { 1uz << 10 };
+static constexpr std::size_t ROUNDS { 16uz };
+
+struct particle {
+    double x, y, z;
+    double vx, vy, vz;
+};
+
+using clock_type = std::chrono::steady_clock;
+
+template <typename Func>
+static double ms(Func &&func) {
+    auto start = clock_type::now();
+    func();
+    return std::chrono::duration<double, std::milli>(clock_type::now() - start).count();
+}
+
+static void report(const std::string &name, double churn, double scan) {
+    std::cout << std::setw(24) << name
+        << std::fixed << std::setprecision(2)
+        << std::setw(14) << churn
+        << std::setw(14) << scan << '\n';
+}
+
+static particle make(std::size_t i) {
+    double d = static_cast<double>(i);
+    return { d, d, d, 1.0, 1.0, 1.0 };
+}
+
+template <typename Container>
+static double scan(const Container &c) {
+    double sum { 0.0 };
+    for (const particle &p : c) {
+        sum += p.x + p.vx;
+    }
+    return sum;
+}
+
+
+int main() {
+    std::mt19937_64 rng(42u);
+    double sink { 0.0 };
+
+    std::cout << "particles: " << N << ", " << ROUNDS << " rounds of "
+        << CHURN << " erase + " << CHURN << " insert, milliseconds\n";
+    std::cout << std::setw(24) << "container"
+        << std::setw(14) << "churn"
+        << std::setw(14) << "scan" << '\n';
+
+    {
+        zstl::hive<particle> h;
+        std::vector<zstl::hive<particle>::iterator> handles;
+        for (std::size_t i { 0uz }; i < N; ++i) {
+            handles.push_back(h.insert(make(i)));
+        }
+
+        double churn { 0.0 }, scanned { 0.0 };
+        for (std::size_t r { 0uz }; r < ROUNDS; ++r) {
+            churn += ms([&] {
+                for (std::size_t k { 0uz }; k < CHURN; ++k) {
+                    std::size_t victim = rng() % N;
+                    h.erase(handles[victim]);
+                    handles[victim] = h.insert(make(victim));
+                }
+            });
+            scanned += ms([&] { sink += scan(h); });
+        }
+        report("hive", churn, scanned);
+    }
+
+    {
+        zstl::vector<particle> v;
+        for (std::size_t i { 0uz }; i < N; ++i) {
+            v.push_back(make(i));
+        }
+
+        double churn { 0.0 }, scanned { 0.0 };
+        for (std::size_t r { 0uz }; r < ROUNDS; ++r) {
+            churn += ms([&] {
+                for (std::size_t k { 0uz }; k < CHURN; ++k) {
+                    std::size_t victim = rng() % N;
+                    auto hole = v.begin() + static_cast<std::ptrdiff_t>(victim);
+                    std::move(hole + 1, v.end(), hole);
+                    v.pop_back();
+                    v.push_back(make(victim));
+                }
+            });
+            scanned += ms([&] { sink += scan(v); });
+        }
+        report("vector erase", churn, scanned);
+    }
+
+    {
+        zstl::vector<particle> v;
+        for (std::size_t i { 0uz }; i < N; ++i) {
+            v.push_back(make(i));
+        }
+
+        double churn { 0.0 }, scanned { 0.0 };
+        for (std::size_t r { 0uz }; r < ROUNDS; ++r) {
+            churn += ms([&] {
+                for (std::size_t k { 0uz }; k < CHURN; ++k) {
+                    std::size_t victim = rng() % N;
+                    v[victim] = v.back();
+                    v.pop_back();
+                    v.push_back(make(victim));
+                }
+            });
+            scanned += ms([&] { sink += scan(v); });
+        }
+        report("vector swap-and-pop", churn, scanned);
+    }
+
+    std::cout << "(checksum " << sink << ")" << std::endl;
+
+    return 0;
+}
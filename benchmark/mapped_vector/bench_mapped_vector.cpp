@@ -0,0 +1,122 @@
+// In this program, we measure the time-to-first-query of a dataset of fixed-size records:
+//   - read: open the file and read() everything into a `zstl::vector` (no zeroing pass),
+//     then look up one record
+//   - mmap: open the file as a `zstl::mapped_vector`, then look up the same record
+// The file is written once up front, so both runs see a warm page cache;
+//   a full scan afterwards shows the steady-state cost of faulting the pages in
+
+#include <ZSTL/vector.hpp>
+#include <ZSTL/mapped_vector.hpp>
+
+#include <iostream>
+#include <iomanip>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+
+
+struct Record {
+    std::uint64_t id { 0u };
+    double value { 0.0 };
+    float weights[4] {};
+};
+
+static constexpr std::size_t N_RECORDS { 1uz << 22 }; // 128 MiB
+static constexpr std::size_t QUERY_INDEX { N_RECORDS / 3uz };
+static const char *PATH = "bench_mapped_vector.bin";
+
+using clock_type = std::chrono::steady_clock;
+
+static double ms_since(clock_type::time_point start) {
+    return std::chrono::duration<double, std::milli>(clock_type::now() - start).count();
+}
+
+static void write_dataset() {
+    zstl::vector<Record> records;
+    records.resize_for_overwrite(N_RECORDS);
+    for (std::size_t i { 0uz }; i < N_RECORDS; ++i) {
+        records[i] = Record {
+            .id = i,
+            .value = static_cast<double>(i) * 0.5,
+            .weights = { 1.0f, 2.0f, 3.0f, 4.0f }
+        };
+    }
+    zstl::write_mapped_file<Record>(PATH, std::span<const Record>(records.data(), records.size()));
+}
+
+template <typename Container>
+static double scan(const Container &records) {
+    double sum { 0.0 };
+    for (const Record &r : records) {
+        sum += r.value;
+    }
+    return sum;
+}
+
+static void bench_read() {
+    auto start = clock_type::now();
+
+    std::FILE *file = std::fopen(PATH, "rb");
+    zstl::mapped_header header;
+    std::fread(&header, sizeof(header), 1uz, file);
+    std::fseek(file, static_cast<long>(header.data_offset), SEEK_SET);
+
+    zstl::vector<Record> records;
+    records.resize_and_overwrite(
+        header.count,
+        [file](Record *p, std::size_t n) {
+            return std::fread(p, sizeof(Record), n, file);
+        }
+    );
+    std::fclose(file);
+
+    std::uint64_t id = records[QUERY_INDEX].id;
+    double firstQuery = ms_since(start);
+
+    auto scanStart = clock_type::now();
+    double sum = scan(records);
+    double scanMs = ms_since(scanStart);
+
+    std::cout << std::setw(24) << "read into vector"
+        << std::setw(16) << firstQuery
+        << std::setw(16) << scanMs
+        << "   (id " << id << ", sum " << sum << ")\n";
+}
+
+static void bench_mmap(zstl::access_hint hint, const char *name) {
+    auto start = clock_type::now();
+
+    zstl::mapped_vector<Record> records(PATH, hint);
+    std::uint64_t id = records[QUERY_INDEX].id;
+    double firstQuery = ms_since(start);
+
+    auto scanStart = clock_type::now();
+    double sum = scan(records);
+    double scanMs = ms_since(scanStart);
+
+    std::cout << std::setw(24) << name
+        << std::setw(16) << firstQuery
+        << std::setw(16) << scanMs
+        << "   (id " << id << ", sum " << sum << ")\n";
+}
+
+
+int main() {
+    write_dataset();
+
+    std::cout << "records: " << N_RECORDS << " x " << sizeof(Record) << " bytes\n";
+    std::cout << std::fixed << std::setprecision(3)
+        << std::setw(24) << "method"
+        << std::setw(16) << "first query ms"
+        << std::setw(16) << "full scan ms" << '\n';
+
+    bench_read();
+    bench_mmap(zstl::access_hint::normal, "mmap");
+    bench_mmap(zstl::access_hint::sequential, "mmap (sequential)");
+    bench_mmap(zstl::access_hint::random, "mmap (random)");
+    bench_mmap(zstl::access_hint::willneed, "mmap (willneed)");
+
+    std::remove(PATH);
+
+    return 0;
+}
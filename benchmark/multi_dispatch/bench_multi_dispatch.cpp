@@ -0,0 +1,191 @@
+// In this program, we test `P` random pairs of shapes for overlap, the inner loop
+//   of a broad-phase collision pass, where the test depends on both dynamic types
+// - nested call: `a.call([&](auto *x) { return b.call([&](auto *y) { ... }); })`,
+//   N x M switches after inlining
+// - zstl::dispatch: one indirect call through the flattened (tag a, tag b) table
+// - virtual: classic double dispatch, `a.overlaps(b)` calls `b.overlaps_with(*this)`,
+//   two virtual calls per pair
+// Shapes are bounding circles, axis-aligned boxes and capsules; every pair of
+//   types has its own test
+
+#include <ZSTL/tagged_ptr.hpp>
+
+#include <iostream>
+#include <iomanip>
+#include <chrono>
+#include <memory>
+#include <random>
+#include <string>
+#include <vector>
+#include <cmath>
+#include <utility>
+#include <algorithm>
+#include <cstdint>
+#include <cstddef>
+
+
+static constexpr std::size_t SHAPES { 1uz << 12 };
+static constexpr std::size_t P { 1uz << 22 };
+static constexpr std::size_t REPEAT { 8uz };
+
+struct Circle { double x, y, r; };
+struct Box { double x0, y0, x1, y1; };
+struct Capsule { double x0, y0, x1, y1, r; };
+
+static double clamp_distance(double x, double y, const Box &b) {
+    double dx = x - std::clamp(x, b.x0, b.x1);
+    double dy = y - std::clamp(y, b.y0, b.y1);
+    return dx * dx + dy * dy;
+}
+
+static double segment_distance(double x, double y, const Capsule &c) {
+    double vx = c.x1 - c.x0, vy = c.y1 - c.y0;
+    double t = std::clamp(((x - c.x0) * vx + (y - c.y0) * vy) / (vx * vx + vy * vy), 0.0, 1.0);
+    double dx = x - (c.x0 + t * vx), dy = y - (c.y0 + t * vy);
+    return dx * dx + dy * dy;
+}
+
+static bool overlap(const Circle &a, const Circle &b) {
+    double dx = a.x - b.x, dy = a.y - b.y, r = a.r + b.r;
+    return dx * dx + dy * dy <= r * r;
+}
+static bool overlap(const Circle &a, const Box &b) { return clamp_distance(a.x, a.y, b) <= a.r * a.r; }
+static bool overlap(const Box &a, const Circle &b) { return overlap(b, a); }
+static bool overlap(const Box &a, const Box &b) {
+    return a.x0 <= b.x1 && b.x0 <= a.x1 && a.y0 <= b.y1 && b.y0 <= a.y1;
+}
+static bool overlap(const Circle &a, const Capsule &b) {
+    double r = a.r + b.r;
+    return segment_distance(a.x, a.y, b) <= r * r;
+}
+static bool overlap(const Capsule &a, const Circle &b) { return overlap(b, a); }
+static bool overlap(const Box &a, const Capsule &b) {
+    // conservative: the capsule's end caps against the box
+    return clamp_distance(b.x0, b.y0, a) <= b.r * b.r || clamp_distance(b.x1, b.y1, a) <= b.r * b.r;
+}
+static bool overlap(const Capsule &a, const Box &b) { return overlap(b, a); }
+static bool overlap(const Capsule &a, const Capsule &b) {
+    double r = a.r + b.r;
+    return segment_distance(a.x0, a.y0, b) <= r * r || segment_distance(a.x1, a.y1, b) <= r * r;
+}
+
+using shape_ptr = zstl::tagged_ptr<Circle, Box, Capsule>;
+
+
+// virtual double dispatch over the same shapes
+struct Shape {
+    virtual ~Shape() = default;
+    virtual bool overlaps(const Shape &other) const = 0;
+    virtual bool overlaps_with(const Circle &other) const = 0;
+    virtual bool overlaps_with(const Box &other) const = 0;
+    virtual bool overlaps_with(const Capsule &other) const = 0;
+};
+
+template <typename T>
+struct virtual_shape : Shape {
+    T shape;
+    explicit virtual_shape(const T &shape) : shape(shape) {}
+    bool overlaps(const Shape &other) const override { return other.overlaps_with(this->shape); }
+    bool overlaps_with(const Circle &other) const override { return overlap(other, this->shape); }
+    bool overlaps_with(const Box &other) const override { return overlap(other, this->shape); }
+    bool overlaps_with(const Capsule &other) const override { return overlap(other, this->shape); }
+};
+
+
+using clock_type = std::chrono::steady_clock;
+
+template <typename Func>
+static double ms(Func &&func) {
+    std::size_t hits { 0uz };
+    auto start = clock_type::now();
+    for (std::size_t r { 0uz }; r < REPEAT; ++r) {
+        hits += func();
+    }
+    double time = std::chrono::duration<double, std::milli>(clock_type::now() - start).count() / REPEAT;
+    if (hits == 0uz) {
+        std::cerr << "no overlaps" << std::endl;
+    }
+    return time;
+}
+
+static void report(const std::string &name, double time) {
+    std::cout << std::setw(20) << name
+        << std::fixed << std::setprecision(2)
+        << std::setw(12) << time
+        << std::setw(12) << time * 1e6 / P << '\n';
+}
+
+
+int main() {
+    std::mt19937_64 rng(42u);
+    std::uniform_real_distribution<double> pos(0.0, 100.0);
+    std::uniform_real_distribution<double> len(1.0, 8.0);
+
+    std::vector<Circle> circles;
+    std::vector<Box> boxes;
+    std::vector<Capsule> capsules;
+    circles.reserve(SHAPES);
+    boxes.reserve(SHAPES);
+    capsules.reserve(SHAPES);
+    std::vector<shape_ptr> shapes;
+    std::vector<std::unique_ptr<Shape>> virtuals;
+    for (std::size_t i { 0uz }; i < SHAPES; ++i) {
+        double x = pos(rng), y = pos(rng);
+        switch (rng() % 3u) {
+            case 0u:
+                shapes.emplace_back(&circles.emplace_back(x, y, len(rng)));
+                virtuals.push_back(std::make_unique<virtual_shape<Circle>>(circles.back()));
+                break;
+            case 1u:
+                shapes.emplace_back(&boxes.emplace_back(x, y, x + len(rng), y + len(rng)));
+                virtuals.push_back(std::make_unique<virtual_shape<Box>>(boxes.back()));
+                break;
+            default:
+                shapes.emplace_back(&capsules.emplace_back(x, y, x + len(rng), y + len(rng), len(rng) / 4.0));
+                virtuals.push_back(std::make_unique<virtual_shape<Capsule>>(capsules.back()));
+                break;
+        }
+    }
+
+    std::vector<std::pair<std::uint32_t, std::uint32_t>> pairs(P);
+    for (auto &[a, b] : pairs) {
+        a = static_cast<std::uint32_t>(rng() % SHAPES);
+        b = static_cast<std::uint32_t>(rng() % SHAPES);
+    }
+
+    std::cout << "pairs: " << P << ", shapes: " << SHAPES << '\n';
+    std::cout << std::setw(20) << "" << std::setw(12) << "ms" << std::setw(12) << "ns/pair" << '\n';
+
+    report("nested call", ms([&]() {
+        std::size_t hits { 0uz };
+        for (auto [a, b] : pairs) {
+            const shape_ptr &x = shapes[a], &y = shapes[b];
+            hits += x.call([&y](const auto *s) {
+                return y.call([s](const auto *t) { return overlap(*s, *t); });
+            });
+        }
+        return hits;
+    }));
+
+    report("zstl::dispatch", ms([&]() {
+        std::size_t hits { 0uz };
+        for (auto [a, b] : pairs) {
+            hits += zstl::dispatch(
+                [](const auto *s, const auto *t) { return overlap(*s, *t); },
+                std::as_const(shapes[a]),
+                std::as_const(shapes[b])
+            );
+        }
+        return hits;
+    }));
+
+    report("virtual", ms([&]() {
+        std::size_t hits { 0uz };
+        for (auto [a, b] : pairs) {
+            hits += virtuals[a]->overlaps(*virtuals[b]);
+        }
+        return hits;
+    }));
+
+    return 0;
+}
@@ -0,0 +1,109 @@
+// In this program, we measure the compression ratio and scan throughput of
+//   `zstl::packed_int_vector` against a plain `zstl::vector<uint64_t>`
+// Inputs are `N` values of three shapes: sorted IDs with small random gaps,
+//   unsorted values within a narrow range, and full-range random values
+// Scan throughput is decoded bytes (8 per value) per second while summing all values
+
+#include <ZSTL/vector.hpp>
+#include <ZSTL/simd.hpp>
+#include <ZSTL/packed_int_vector.hpp>
+
+#include <iostream>
+#include <iomanip>
+#include <chrono>
+#include <random>
+#include <string>
+#include <cstdint>
+
+
+static constexpr std::size_t N { 1uz << 24 };
+static constexpr std::size_t QUERIES { 1uz << 20 };
+
+using clock_type = std::chrono::steady_clock;
+
+template <typename Func>
+static double seconds(Func &&func) {
+    auto start = clock_type::now();
+    func();
+    return std::chrono::duration<double>(clock_type::now() - start).count();
+}
+
+static void run(const std::string &name, const zstl::vector<std::uint64_t> &values, std::uint64_t &sink) {
+    zstl::packed_int_vector packed;
+    double build = seconds([&] {
+        packed.append(std::span<const std::uint64_t>(values.data(), values.size()));
+    });
+
+    double raw = static_cast<double>(values.size() * sizeof(std::uint64_t));
+    std::cout << name << ": " << std::fixed << std::setprecision(1)
+        << raw / 1e6 << " MB -> " << static_cast<double>(packed.memory_bytes()) / 1e6 << " MB"
+        << ", ratio " << std::setprecision(2) << raw / static_cast<double>(packed.memory_bytes())
+        << ", build " << std::setprecision(1) << raw / build / 1e9 << " GB/s\n";
+
+    double plain = seconds([&] {
+        std::uint64_t s { 0u };
+        for (std::uint64_t x : values) {
+            s += x;
+        }
+        sink += s;
+    });
+    std::cout << std::setw(20) << "zstl::vector scan" << std::setw(10) << raw / plain / 1e9 << " GB/s\n";
+
+    for (auto l : { zstl::simd::level::scalar, zstl::simd::level::sse2, zstl::simd::level::avx2, zstl::simd::level::avx512 }) {
+        if (l > zstl::simd::detected_level()) {
+            continue;
+        }
+        double scan = seconds([&] {
+            std::uint64_t s { 0u };
+            packed.for_each_block(
+                [&](std::span<const std::uint64_t> block) {
+                    for (std::uint64_t x : block) {
+                        s += x;
+                    }
+                },
+                l
+            );
+            sink += s;
+        });
+        std::cout << std::setw(14) << zstl::simd::level_name(l) << " scan"
+            << std::setw(10) << raw / scan / 1e9 << " GB/s\n";
+    }
+
+    std::mt19937_64 rng(7u);
+    double random = seconds([&] {
+        for (std::size_t q { 0uz }; q < QUERIES; ++q) {
+            sink += packed[rng() % N];
+        }
+    });
+    std::cout << std::setw(20) << "random access" << std::setw(10)
+        << random / static_cast<double>(QUERIES) * 1e9 << " ns\n";
+}
+
+
+int main() {
+    std::mt19937_64 rng(42u);
+    zstl::vector<std::uint64_t> values;
+    values.resize_for_overwrite(N);
+    std::uint64_t sink { 0u };
+
+    std::uint64_t id { 1u << 30 };
+    for (std::uint64_t &x : values) {
+        id += 1u + rng() % 64u;
+        x = id;
+    }
+    run("sorted ids", values, sink);
+
+    for (std::uint64_t &x : values) {
+        x = (1ull << 40) + rng() % 100000u;
+    }
+    run("narrow range", values, sink);
+
+    for (std::uint64_t &x : values) {
+        x = rng();
+    }
+    run("random", values, sink);
+
+    std::cout << "(checksum " << sink << ")" << std::endl;
+
+    return 0;
+}
@@ -0,0 +1,98 @@
+// In this program, we measure how `zstl::parallel_sort`, `zstl::parallel_reduce`
+//   and `zstl::parallel_inclusive_scan` scale with the number of threads,
+//   against single-threaded `std::sort`, `std::reduce` and `std::inclusive_scan`
+// Inputs are `N` random 64-bit integers held in `zstl::vector`
+
+#include <ZSTL/vector.hpp>
+#include <ZSTL/thread_pool.hpp>
+#include <ZSTL/parallel_algorithm.hpp>
+
+#include <iostream>
+#include <iomanip>
+#include <chrono>
+#include <random>
+#include <string>
+#include <thread>
+#include <numeric>
+#include <algorithm>
+#include <cstdint>
+
+
+static constexpr std::size_t N { 1uz << 24 };
+
+using clock_type = std::chrono::steady_clock;
+
+template <typename Func>
+static double ms(Func &&func) {
+    auto start = clock_type::now();
+    func();
+    return std::chrono::duration<double, std::milli>(clock_type::now() - start).count();
+}
+
+static void report(const std::string &name, double sort, double reduce, double scan) {
+    std::cout << std::setw(16) << name
+        << std::fixed << std::setprecision(1)
+        << std::setw(12) << sort
+        << std::setw(12) << reduce
+        << std::setw(12) << scan << '\n';
+}
+
+
+int main() {
+    zstl::vector<std::uint64_t> input;
+    input.resize_for_overwrite(N);
+    std::mt19937_64 rng(42u);
+    for (std::uint64_t &x : input) {
+        x = rng();
+    }
+
+    zstl::vector<std::uint64_t> work;
+    zstl::vector<std::uint64_t> out;
+    out.resize_for_overwrite(N);
+    std::uint64_t sink { 0u };
+
+    std::cout << "elements: " << N << " uint64, milliseconds\n";
+    std::cout << std::setw(16) << "threads"
+        << std::setw(12) << "sort"
+        << std::setw(12) << "reduce"
+        << std::setw(12) << "scan" << '\n';
+
+    {
+        work = input;
+        double sort = ms([&] {
+            std::sort(work.begin(), work.end());
+        });
+        double reduce = ms([&] {
+            sink += std::reduce(input.begin(), input.end(), std::uint64_t { 0u });
+        });
+        double scan = ms([&] {
+            std::inclusive_scan(input.begin(), input.end(), out.begin());
+        });
+        report("std (1 thread)", sort, reduce, scan);
+    }
+
+    unsigned counts[] { 1u, 2u, 4u, std::thread::hardware_concurrency() };
+    for (unsigned nThreads : counts) {
+        zstl::thread_pool pool(nThreads);
+        zstl::parallel_policy policy { .pool = &pool };
+
+        work = input;
+        double sort = ms([&] {
+            zstl::parallel_sort(policy, work);
+        });
+        if (!std::is_sorted(work.begin(), work.end())) {
+            std::cerr << "parallel_sort failed" << std::endl;
+        }
+        double reduce = ms([&] {
+            sink += zstl::parallel_reduce(policy, input, std::uint64_t { 0u });
+        });
+        double scan = ms([&] {
+            zstl::parallel_inclusive_scan(policy, input, out);
+        });
+        report("zstl x" + std::to_string(nThreads), sort, reduce, scan);
+    }
+
+    std::cout << "(checksum " << sink + out[N - 1uz] << ")" << std::endl;
+
+    return 0;
+}
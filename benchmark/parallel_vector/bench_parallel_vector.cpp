@@ -0,0 +1,94 @@
+// In this program, we measure the bandwidth of building large `zstl::vector`s:
+//   - fill: vector(count, value)
+//   - copy: vector(other)
+//   - transform: assign_transformed(first, last, op)
+// serially and with `zstl::par` on thread pools of 1, 4 and all hardware threads
+// Every run allocates a fresh vector, so page faults (first touch) are part of the cost
+
+#include <ZSTL/vector.hpp>
+#include <ZSTL/thread_pool.hpp>
+
+#include <iostream>
+#include <iomanip>
+#include <chrono>
+#include <thread>
+#include <string>
+
+
+static constexpr std::size_t N { 1uz << 25 }; // 256 MiB of doubles
+static constexpr double BYTES { static_cast<double>(N * sizeof(double)) };
+
+using clock_type = std::chrono::steady_clock;
+
+template <typename Func>
+static double gb_per_s(Func &&func) {
+    auto start = clock_type::now();
+    func();
+    double seconds = std::chrono::duration<double>(clock_type::now() - start).count();
+    return BYTES / seconds / 1e9;
+}
+
+static void report(const char *name, double fill, double copy, double transform) {
+    std::cout << std::setw(16) << name
+        << std::fixed << std::setprecision(2)
+        << std::setw(12) << fill
+        << std::setw(12) << copy
+        << std::setw(12) << transform << '\n';
+}
+
+
+int main() {
+    zstl::vector<double> source(zstl::par, N, 1.5);
+
+    std::cout << "elements: " << N << " doubles, GB/s of destination written\n";
+    std::cout << std::setw(16) << "threads"
+        << std::setw(12) << "fill"
+        << std::setw(12) << "copy"
+        << std::setw(12) << "transform" << '\n';
+
+    {
+        double fill = gb_per_s([] {
+            zstl::vector<double> v(N, 2.0);
+        });
+        double copy = gb_per_s([&] {
+            zstl::vector<double> v(source);
+        });
+        double transform = gb_per_s([&] {
+            zstl::vector<double> v;
+            v.resize_for_overwrite(N);
+            for (std::size_t i { 0uz }; i < N; ++i) {
+                v[i] = source[i] * 2.0 + 1.0;
+            }
+        });
+        report("serial", fill, copy, transform);
+    }
+
+    unsigned counts[] { 1u, 4u, std::thread::hardware_concurrency() };
+    for (unsigned nThreads : counts) {
+        zstl::thread_pool pool(nThreads);
+        zstl::parallel_policy policy { .pool = &pool };
+
+        double fill = gb_per_s([&] {
+            zstl::vector<double> v(policy, N, 2.0);
+        });
+        double copy = gb_per_s([&] {
+            zstl::vector<double> v(policy, source);
+        });
+        double transform = gb_per_s([&] {
+            zstl::vector<double> v;
+            v.assign_transformed(
+                policy,
+                source.begin(),
+                source.end(),
+                [](double x) {
+                    return x * 2.0 + 1.0;
+                }
+            );
+        });
+
+        std::string name = "par x" + std::to_string(nThreads);
+        report(name.c_str(), fill, copy, transform);
+    }
+
+    return 0;
+}
@@ -0,0 +1,144 @@
+// In this program, we sum `get_area()` over `M` shapes of random types stored
+//   three ways
+// - virtual: `std::vector<std::unique_ptr<Shape>>`, one heap allocation and one
+//   virtual call per shape
+// - tagged_ptr: `std::vector<tagged_ptr<Circle, RightTriangle, Rectangle>>` to
+//   shapes allocated one by one, `call` per element
+// - poly_collection: the shapes by value, one `zstl::vector` per type, and
+//   `for_each` walking one segment after the other
+// The shapes are created in random type order, so the individually allocated
+//   ones are interleaved in memory as they would be in a long-running program
+
+#include <ZSTL/tagged_ptr.hpp>
+#include <ZSTL/poly_collection.hpp>
+
+#include <iostream>
+#include <iomanip>
+#include <chrono>
+#include <memory>
+#include <random>
+#include <string>
+#include <vector>
+#include <numbers>
+#include <cstddef>
+
+
+static constexpr std::size_t M { 1uz << 22 };
+static constexpr std::size_t REPEAT { 8uz };
+
+struct Shape {
+    virtual ~Shape() = default;
+    virtual double get_area() const = 0;
+};
+
+struct Circle {
+    double radius { 0.0 };
+    double get_area() const { return std::numbers::pi * radius * radius; }
+};
+
+struct RightTriangle {
+    double base { 0.0 };
+    double height { 0.0 };
+    double get_area() const { return 0.5 * base * height; }
+};
+
+struct Rectangle {
+    double width { 0.0 };
+    double height { 0.0 };
+    double get_area() const { return width * height; }
+};
+
+// the same shapes behind a virtual interface
+template <typename T>
+struct virtual_shape : Shape {
+    T shape;
+    explicit virtual_shape(const T &shape) : shape(shape) {}
+    double get_area() const override { return this->shape.get_area(); }
+};
+
+using shape_ptr = zstl::tagged_ptr<Circle, RightTriangle, Rectangle>;
+using shape_collection = zstl::poly_collection<Circle, RightTriangle, Rectangle>;
+
+using clock_type = std::chrono::steady_clock;
+
+static volatile double sink;
+
+template <typename Func>
+static double ms(Func &&func) {
+    auto start = clock_type::now();
+    for (std::size_t r { 0uz }; r < REPEAT; ++r) {
+        sink = func();
+    }
+    return std::chrono::duration<double, std::milli>(clock_type::now() - start).count() / REPEAT;
+}
+
+static void report(const std::string &name, double time) {
+    std::cout << std::setw(20) << name
+        << std::fixed << std::setprecision(2)
+        << std::setw(12) << time << '\n';
+}
+
+
+int main() {
+    std::mt19937_64 rng(42u);
+    std::uniform_real_distribution<double> length(0.5, 2.0);
+
+    std::vector<std::unique_ptr<Shape>> virtuals;
+    std::vector<std::unique_ptr<Circle>> circles;
+    std::vector<std::unique_ptr<RightTriangle>> triangles;
+    std::vector<std::unique_ptr<Rectangle>> rectangles;
+    std::vector<shape_ptr> tagged;
+    shape_collection collection;
+
+    for (std::size_t i { 0uz }; i < M; ++i) {
+        switch (rng() % 3u) {
+            case 0u: {
+                Circle c { length(rng) };
+                virtuals.push_back(std::make_unique<virtual_shape<Circle>>(c));
+                tagged.emplace_back(circles.emplace_back(std::make_unique<Circle>(c)).get());
+                collection.insert(c);
+                break;
+            }
+            case 1u: {
+                RightTriangle t { length(rng), length(rng) };
+                virtuals.push_back(std::make_unique<virtual_shape<RightTriangle>>(t));
+                tagged.emplace_back(triangles.emplace_back(std::make_unique<RightTriangle>(t)).get());
+                collection.insert(t);
+                break;
+            }
+            default: {
+                Rectangle r { length(rng), length(rng) };
+                virtuals.push_back(std::make_unique<virtual_shape<Rectangle>>(r));
+                tagged.emplace_back(rectangles.emplace_back(std::make_unique<Rectangle>(r)).get());
+                collection.insert(r);
+                break;
+            }
+        }
+    }
+
+    std::cout << "shapes: " << M << "   (ms per pass)" << '\n';
+
+    report("virtual", ms([&]() {
+        double sum { 0.0 };
+        for (const auto &s : virtuals) {
+            sum += s->get_area();
+        }
+        return sum;
+    }));
+
+    report("tagged_ptr", ms([&]() {
+        double sum { 0.0 };
+        for (shape_ptr p : tagged) {
+            sum += p.call([](const auto *s) { return s->get_area(); });
+        }
+        return sum;
+    }));
+
+    report("poly_collection", ms([&]() {
+        double sum { 0.0 };
+        std::as_const(collection).for_each([&sum](const auto *s) { sum += s->get_area(); });
+        return sum;
+    }));
+
+    return 0;
+}
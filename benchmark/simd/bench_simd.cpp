@@ -0,0 +1,88 @@
+// In this program, we measure the throughput (GB/s) of the `zstl::simd` kernels
+//   at every ISA level the CPU supports, from the scalar fallback up to AVX-512
+// Inputs are `N` random int32_t / float / double values held in `zstl::vector`,
+//   sized to stay in L2 so the numbers reflect the kernels rather than DRAM
+// Note: the scalar fallback is plain loops, so the compiler may still auto-vectorize
+//   the simpler ones (count, sum) at the build's baseline ISA
+
+#include <ZSTL/vector.hpp>
+#include <ZSTL/simd.hpp>
+
+#include <iostream>
+#include <iomanip>
+#include <chrono>
+#include <random>
+#include <string>
+#include <cstdint>
+
+
+static constexpr std::size_t N { 1uz << 16 };
+static constexpr int REPEAT { 2000 };
+
+using clock_type = std::chrono::steady_clock;
+
+template <typename Func>
+static double gbps(std::size_t bytes, Func &&func) {
+    auto start = clock_type::now();
+    for (int r = 0; r < REPEAT; ++r) {
+        func();
+    }
+    double s = std::chrono::duration<double>(clock_type::now() - start).count();
+    return static_cast<double>(bytes) * REPEAT / s / 1e9;
+}
+
+template <typename T>
+static void run(const std::string &name, double &sink) {
+    zstl::vector<T> data;
+    data.resize_for_overwrite(N);
+    std::mt19937 rng(42u);
+    for (T &x : data) {
+        x = static_cast<T>(static_cast<int>(rng() % 1000000u));
+    }
+    // a key that is not present, so find scans the whole range
+    T missing = static_cast<T>(-1);
+    std::size_t bytes = N * sizeof(T);
+
+    for (auto l : { zstl::simd::level::scalar, zstl::simd::level::sse2, zstl::simd::level::avx2, zstl::simd::level::avx512 }) {
+        if (l > zstl::simd::detected_level()) {
+            continue;
+        }
+        double find = gbps(bytes, [&] { sink += zstl::simd::find(data, missing, l); });
+        double count = gbps(bytes, [&] { sink += zstl::simd::count(data, missing, l); });
+        double min = gbps(bytes, [&] { sink += zstl::simd::min(data, l); });
+        double max = gbps(bytes, [&] { sink += zstl::simd::max(data, l); });
+        double sum = gbps(bytes, [&] { sink += zstl::simd::sum(data, l); });
+
+        std::cout << std::setw(8) << name
+            << std::setw(8) << zstl::simd::level_name(l)
+            << std::fixed << std::setprecision(1)
+            << std::setw(10) << find
+            << std::setw(10) << count
+            << std::setw(10) << min
+            << std::setw(10) << max
+            << std::setw(10) << sum << '\n';
+    }
+}
+
+
+int main() {
+    double sink { 0.0 };
+
+    std::cout << "elements: " << N << ", GB/s, detected level: "
+        << zstl::simd::level_name(zstl::simd::detected_level()) << '\n';
+    std::cout << std::setw(8) << "type"
+        << std::setw(8) << "level"
+        << std::setw(10) << "find"
+        << std::setw(10) << "count"
+        << std::setw(10) << "min"
+        << std::setw(10) << "max"
+        << std::setw(10) << "sum" << '\n';
+
+    run<std::int32_t>("int32", sink);
+    run<float>("float", sink);
+    run<double>("double", sink);
+
+    std::cout << "(checksum " << sink << ")" << std::endl;
+
+    return 0;
+}
@@ -0,0 +1,99 @@
+// In this program, we measure `zstl::simd::filter_into` / `filter_indices_into`
+//   against a `push_back` loop at several selectivities
+// Inputs are `N` uniformly random int32_t values held in `zstl::vector`, filtered by
+//   `greater{threshold}` with the threshold chosen to keep the given fraction;
+//   throughput is in millions of input elements per second
+
+#include <ZSTL/vector.hpp>
+#include <ZSTL/simd.hpp>
+#include <ZSTL/simd_filter.hpp>
+
+#include <iostream>
+#include <iomanip>
+#include <chrono>
+#include <random>
+#include <string>
+#include <cstdint>
+
+
+static constexpr std::size_t N { 1uz << 20 };
+static constexpr int REPEAT { 50 };
+
+using clock_type = std::chrono::steady_clock;
+
+template <typename Func>
+static double meps(Func &&func) {
+    auto start = clock_type::now();
+    for (int r = 0; r < REPEAT; ++r) {
+        func();
+    }
+    double s = std::chrono::duration<double>(clock_type::now() - start).count();
+    return static_cast<double>(N) * REPEAT / s / 1e6;
+}
+
+
+int main() {
+    zstl::vector<std::int32_t> input;
+    input.resize_for_overwrite(N);
+    std::mt19937 rng(42u);
+    for (std::int32_t &x : input) {
+        x = static_cast<std::int32_t>(rng() % 1000000u);
+    }
+
+    std::size_t sink { 0uz };
+    zstl::vector<std::int32_t> out;
+    zstl::vector<std::uint32_t> indices;
+
+    std::cout << "elements: " << N << " int32, million elements per second\n";
+    std::cout << std::setw(10) << "selected"
+        << std::setw(12) << "push_back";
+    zstl::simd::level levels[] {
+        zstl::simd::level::scalar, zstl::simd::level::avx2, zstl::simd::level::avx512
+    };
+    for (auto l : levels) {
+        if (l <= zstl::simd::detected_level()) {
+            std::cout << std::setw(12) << zstl::simd::level_name(l);
+        }
+    }
+    std::cout << std::setw(12) << "indices" << '\n';
+
+    for (double fraction : { 0.01, 0.10, 0.50, 0.90, 0.99 }) {
+        auto threshold = static_cast<std::int32_t>(1000000.0 * (1.0 - fraction));
+        zstl::simd::greater pred { threshold };
+
+        std::cout << std::setw(9) << std::fixed << std::setprecision(0) << fraction * 100.0 << '%';
+        std::cout << std::setprecision(1);
+
+        double loop = meps([&] {
+            out.clear();
+            for (std::int32_t x : input) {
+                if (x > threshold) {
+                    out.push_back(x);
+                }
+            }
+            sink += out.size();
+        });
+        std::cout << std::setw(12) << loop;
+
+        for (auto l : levels) {
+            if (l > zstl::simd::detected_level()) {
+                continue;
+            }
+            double simd = meps([&] {
+                out.clear();
+                sink += zstl::simd::filter_into(input, out, pred, l);
+            });
+            std::cout << std::setw(12) << simd;
+        }
+
+        double idx = meps([&] {
+            indices.clear();
+            sink += zstl::simd::filter_indices_into(input, indices, pred);
+        });
+        std::cout << std::setw(12) << idx << '\n';
+    }
+
+    std::cout << "(checksum " << sink << ")" << std::endl;
+
+    return 0;
+}
@@ -0,0 +1,137 @@
+// In this program, we compare traversing references to heterogeneous shapes held
+//   as 8-byte `tagged_ptr<Circle, RightTriangle, Rectangle>` against 4-byte
+//   `tagged_handle`s into the same `tagged_arena`
+// The shapes live in one arena in creation order; every shape is referenced
+//   `REFS` times from a shuffled reference list, as the nodes of a scene graph are
+//   referenced from many places. We sum `get_area()` over the whole list
+// Both versions read the same shapes at the same addresses, so the difference is
+//   the reference list itself: half the bytes to stream, and twice as many
+//   references per cache line. We report ns per reference for growing scenes
+
+#include <ZSTL/tagged_ptr.hpp>
+#include <ZSTL/tagged_handle.hpp>
+
+#include <iostream>
+#include <iomanip>
+#include <chrono>
+#include <random>
+#include <vector>
+#include <numbers>
+#include <algorithm>
+#include <cstddef>
+
+
+static constexpr std::size_t REFS { 4uz };
+static constexpr std::size_t MIN_SHAPES { 1uz << 12 };
+static constexpr std::size_t MAX_SHAPES { 1uz << 22 };
+static constexpr std::size_t TOTAL_REFS { 1uz << 26 };
+
+struct Circle {
+    double radius { 0.0 };
+    double get_area() const { return std::numbers::pi * radius * radius; }
+};
+
+struct RightTriangle {
+    double base { 0.0 };
+    double height { 0.0 };
+    double get_area() const { return 0.5 * base * height; }
+};
+
+struct Rectangle {
+    double width { 0.0 };
+    double height { 0.0 };
+    double get_area() const { return width * height; }
+};
+
+using shape_ptr = zstl::tagged_ptr<Circle, RightTriangle, Rectangle>;
+using shape_handle = zstl::tagged_handle<Circle, RightTriangle, Rectangle>;
+
+using clock_type = std::chrono::steady_clock;
+
+static volatile double sink;
+
+// ns per reference, over about TOTAL_REFS references
+template <typename Func>
+static double ns_per_ref(std::size_t nRefs, Func &&func) {
+    std::size_t repeat = std::max(TOTAL_REFS / nRefs, 1uz);
+    func(); // warm up
+    auto start = clock_type::now();
+    for (std::size_t r { 0uz }; r < repeat; ++r) {
+        sink = func();
+    }
+    std::chrono::duration<double, std::nano> elapsed = clock_type::now() - start;
+    return elapsed.count() / static_cast<double>(repeat * nRefs);
+}
+
+
+int main() {
+    std::mt19937_64 rng(42u);
+    std::uniform_real_distribution<double> length(0.5, 2.0);
+
+    std::cout << "references per shape: " << REFS
+        << ", sizeof(tagged_ptr): " << sizeof(shape_ptr)
+        << ", sizeof(tagged_handle): " << sizeof(shape_handle) << '\n';
+    std::cout << std::setw(10) << "shapes"
+        << std::setw(14) << "refs (MiB)"
+        << std::setw(14) << "tagged_ptr"
+        << std::setw(16) << "tagged_handle"
+        << "   (ns/ref)" << '\n';
+
+    for (std::size_t nShapes = MIN_SHAPES; nShapes <= MAX_SHAPES; nShapes *= 4uz) {
+        zstl::tagged_arena arena(nShapes * 2uz * sizeof(double));
+
+        std::vector<shape_handle> handles;
+        handles.reserve(nShapes * REFS);
+        for (std::size_t i { 0uz }; i < nShapes; ++i) {
+            shape_handle h;
+            switch (rng() % 3u) {
+                case 0u: h = shape_handle::make<Circle>(arena, length(rng)); break;
+                case 1u: h = shape_handle::make<RightTriangle>(arena, length(rng), length(rng)); break;
+                default: h = shape_handle::make<Rectangle>(arena, length(rng), length(rng)); break;
+            }
+            handles.insert(handles.end(), REFS, h);
+        }
+        std::shuffle(handles.begin(), handles.end(), rng);
+
+        std::vector<shape_ptr> ptrs;
+        ptrs.reserve(handles.size());
+        for (shape_handle h : handles) {
+            ptrs.push_back(h.get(arena));
+        }
+
+        const zstl::tagged_arena &scene = arena;
+        auto area = [](const auto *s) { return s->get_area(); };
+
+        double ptrTime = ns_per_ref(
+            ptrs.size(),
+            [&]() {
+                double sum { 0.0 };
+                for (shape_ptr p : ptrs) {
+                    sum += p.call(area);
+                }
+                return sum;
+            }
+        );
+        double handleTime = ns_per_ref(
+            handles.size(),
+            [&]() {
+                double sum { 0.0 };
+                for (shape_handle h : handles) {
+                    sum += h.call(scene, area);
+                }
+                return sum;
+            }
+        );
+
+        std::cout << std::setw(10) << nShapes
+            << std::fixed << std::setprecision(1)
+            << std::setw(7) << static_cast<double>(ptrs.size() * sizeof(shape_ptr)) / (1 << 20)
+            << '/' << std::setw(6) << static_cast<double>(handles.size() * sizeof(shape_handle)) / (1 << 20)
+            << std::setprecision(2)
+            << std::setw(14) << ptrTime
+            << std::setw(16) << handleTime
+            << '\n';
+    }
+
+    return 0;
+}
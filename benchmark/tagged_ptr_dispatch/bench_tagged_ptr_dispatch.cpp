@@ -0,0 +1,158 @@
+// In this program, we compare the dispatch of `zstl::tagged_ptr::call` with
+//   virtual functions and `std::visit` for 2 up to 31 types (the most a 5-bit tag
+//   can name next to nullptr): `M` pointers to objects of uniformly random types
+//   are visited in order and the results summed
+// Both forms of `call` are timed on their own, so that
+//   `detail::tagged_ptr::SWITCH_DISPATCH_MAX` can be checked:
+// - switch: the recursive switch chain, one compare per type skipped
+// - table:  one indirect call through a table of per-type thunks
+// - call:   what `tagged_ptr::call` picks for that number of types
+
+#include <ZSTL/tagged_ptr.hpp>
+
+#include <iostream>
+#include <iomanip>
+#include <chrono>
+#include <random>
+#include <memory>
+#include <vector>
+#include <variant>
+#include <tuple>
+#include <utility>
+#include <cstddef>
+
+
+static constexpr std::size_t M { 1uz << 22 };
+static constexpr std::size_t REPEAT { 4uz };
+
+using clock_type = std::chrono::steady_clock;
+
+template <typename Func>
+static double ns_per_call(Func &&func) {
+    auto start = clock_type::now();
+    for (std::size_t r { 0uz }; r < REPEAT; ++r) {
+        func();
+    }
+    double ns = std::chrono::duration<double, std::nano>(clock_type::now() - start).count();
+    return ns / static_cast<double>(M * REPEAT);
+}
+
+struct virtual_base {
+    virtual ~virtual_base() = default;
+    virtual double get() const = 0;
+};
+
+template <std::size_t I>
+struct shape {
+    double value { 1.0 };
+    double get() const { return this->value * static_cast<double>(I + 1uz); }
+};
+
+template <std::size_t I>
+struct virtual_shape : virtual_base {
+    double value { 1.0 };
+    double get() const override { return this->value * static_cast<double>(I + 1uz); }
+};
+
+static double sink { 0.0 };
+
+template <std::size_t... Is>
+static void run(std::index_sequence<Is...>) {
+    constexpr std::size_t N = sizeof...(Is);
+    using tagged = zstl::tagged_ptr<shape<Is>...>;
+    using variant = std::variant<const shape<Is> *...>;
+
+    std::mt19937_64 rng(42u);
+    std::vector<std::size_t> kinds(M);
+    for (std::size_t &k : kinds) {
+        k = rng() % N;
+    }
+
+    // one object per pointer, so every variant touches the same amount of memory
+    std::tuple<std::vector<shape<Is>>...> objects { std::vector<shape<Is>>(M)... };
+    std::vector<std::unique_ptr<virtual_base>> virtuals;
+    std::vector<tagged> tagged_ptrs;
+    std::vector<variant> variants;
+    virtuals.reserve(M);
+    tagged_ptrs.reserve(M);
+    variants.reserve(M);
+    for (std::size_t i { 0uz }; i < M; ++i) {
+        std::size_t k = kinds[i];
+        ((k == Is ? (
+            tagged_ptrs.emplace_back(&std::get<Is>(objects)[i]),
+            variants.emplace_back(&std::get<Is>(objects)[i]),
+            virtuals.push_back(std::make_unique<virtual_shape<Is>>()),
+            0
+        ) : 0), ...);
+    }
+
+    auto get = [](const auto *p) { return p->get(); };
+
+    double viaSwitch = ns_per_call([&] {
+        double sum { 0.0 };
+        for (const tagged &p : tagged_ptrs) {
+            sum += zstl::detail::tagged_ptr::dispatch_call<decltype(get) &, shape<Is>...>(get, p.ptr(), p.tag() - 1uz);
+        }
+        sink += sum;
+    });
+    double viaTable = ns_per_call([&] {
+        using table = zstl::detail::tagged_ptr::call_table<decltype(get), const void *, shape<Is>...>;
+        double sum { 0.0 };
+        for (const tagged &p : tagged_ptrs) {
+            sum += table::thunks[p.tag() - 1uz](get, p.ptr());
+        }
+        sink += sum;
+    });
+    double viaCall = ns_per_call([&] {
+        double sum { 0.0 };
+        for (const tagged &p : tagged_ptrs) {
+            sum += p.call(get);
+        }
+        sink += sum;
+    });
+    double viaVirtual = ns_per_call([&] {
+        double sum { 0.0 };
+        for (const auto &p : virtuals) {
+            sum += p->get();
+        }
+        sink += sum;
+    });
+    double viaVisit = ns_per_call([&] {
+        double sum { 0.0 };
+        for (const variant &v : variants) {
+            sum += std::visit(get, v);
+        }
+        sink += sum;
+    });
+
+    std::cout << std::setw(6) << N
+        << std::fixed << std::setprecision(2)
+        << std::setw(10) << viaSwitch
+        << std::setw(10) << viaTable
+        << std::setw(10) << viaCall
+        << std::setw(10) << viaVirtual
+        << std::setw(10) << viaVisit << '\n';
+}
+
+
+int main() {
+    std::cout << "pointers: " << M << ", ns per call\n";
+    std::cout << std::setw(6) << "types"
+        << std::setw(10) << "switch"
+        << std::setw(10) << "table"
+        << std::setw(10) << "call"
+        << std::setw(10) << "virtual"
+        << std::setw(10) << "visit" << '\n';
+
+    run(std::make_index_sequence<2uz>());
+    run(std::make_index_sequence<3uz>());
+    run(std::make_index_sequence<4uz>());
+    run(std::make_index_sequence<6uz>());
+    run(std::make_index_sequence<8uz>());
+    run(std::make_index_sequence<16uz>());
+    run(std::make_index_sequence<31uz>());
+
+    std::cout << "(checksum " << sink << ")" << std::endl;
+
+    return 0;
+}
@@ -0,0 +1,127 @@
+// In this program, we sum `get_area()` over `M` shapes of random types held as
+//   `tagged_ptr<Circle, RightTriangle, Rectangle>` (the shapes of test_tagged_ptr.cpp)
+// - random order: `call` per element, the indirect branch is unpredictable
+// - grouped: `tagged_ptr_groups` sorts by tag first, then one direct loop per type;
+//   timed with the grouping included and with it done once up front
+// - sorted input: `call` per element on a collection that is already ordered by
+//   type, the best case for the branch predictor
+
+#include <ZSTL/tagged_ptr.hpp>
+#include <ZSTL/tagged_ptr_groups.hpp>
+
+#include <iostream>
+#include <iomanip>
+#include <chrono>
+#include <random>
+#include <string>
+#include <vector>
+#include <numbers>
+#include <algorithm>
+#include <cstddef>
+
+
+static constexpr std::size_t M { 1uz << 22 };
+static constexpr std::size_t REPEAT { 8uz };
+
+struct Circle {
+    double radius { 0.0 };
+    double get_area() const { return std::numbers::pi * radius * radius; }
+};
+
+struct RightTriangle {
+    double base { 0.0 };
+    double height { 0.0 };
+    double get_area() const { return 0.5 * base * height; }
+};
+
+struct Rectangle {
+    double width { 0.0 };
+    double height { 0.0 };
+    double get_area() const { return width * height; }
+};
+
+using shape_ptr = zstl::tagged_ptr<Circle, RightTriangle, Rectangle>;
+
+using clock_type = std::chrono::steady_clock;
+
+template <typename Func>
+static double ms(Func &&func) {
+    auto start = clock_type::now();
+    for (std::size_t r { 0uz }; r < REPEAT; ++r) {
+        func();
+    }
+    return std::chrono::duration<double, std::milli>(clock_type::now() - start).count() / REPEAT;
+}
+
+static void report(const std::string &name, double time) {
+    std::cout << std::setw(28) << name
+        << std::fixed << std::setprecision(2)
+        << std::setw(12) << time << '\n';
+}
+
+
+int main() {
+    std::mt19937_64 rng(42u);
+    std::uniform_real_distribution<double> length(0.5, 2.0);
+
+    std::vector<Circle> circles(M);
+    std::vector<RightTriangle> triangles(M);
+    std::vector<Rectangle> rectangles(M);
+    std::vector<shape_ptr> shapes;
+    shapes.reserve(M);
+    for (std::size_t i { 0uz }; i < M; ++i) {
+        circles[i] = { length(rng) };
+        triangles[i] = { length(rng), length(rng) };
+        rectangles[i] = { length(rng), length(rng) };
+        switch (rng() % 3u) {
+            case 0u: shapes.emplace_back(&circles[i]); break;
+            case 1u: shapes.emplace_back(&triangles[i]); break;
+            default: shapes.emplace_back(&rectangles[i]); break;
+        }
+    }
+
+    std::vector<shape_ptr> sorted = shapes;
+    std::stable_sort(
+        sorted.begin(), sorted.end(),
+        [](const shape_ptr &a, const shape_ptr &b) { return a.tag() < b.tag(); }
+    );
+
+    auto area = [](const auto *s) { return s->get_area(); };
+    double sink { 0.0 };
+
+    std::cout << "shapes: " << M << ", milliseconds per pass\n";
+
+    report("random order call", ms([&] {
+        double sum { 0.0 };
+        for (const shape_ptr &s : shapes) {
+            sum += s.call(area);
+        }
+        sink += sum;
+    }));
+
+    zstl::tagged_ptr_groups<Circle, RightTriangle, Rectangle> groups;
+    report("grouped (incl. grouping)", ms([&] {
+        double sum { 0.0 };
+        groups.assign(shapes);
+        groups.for_each([&](const auto *s) { sum += s->get_area(); });
+        sink += sum;
+    }));
+
+    report("grouped (grouping reused)", ms([&] {
+        double sum { 0.0 };
+        groups.for_each([&](const auto *s) { sum += s->get_area(); });
+        sink += sum;
+    }));
+
+    report("sorted input call", ms([&] {
+        double sum { 0.0 };
+        for (const shape_ptr &s : sorted) {
+            sum += s.call(area);
+        }
+        sink += sum;
+    }));
+
+    std::cout << "(checksum " << sink << ")" << std::endl;
+
+    return 0;
+}
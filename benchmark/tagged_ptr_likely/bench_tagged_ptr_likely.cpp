@@ -0,0 +1,143 @@
+// In this program, we time `tagged_ptr::call` against `call_likely` on skewed
+//   collections, where two types account for `HOT_SHARE` of the pointers and the
+//   remaining types share the rest, for 4 up to 31 types
+// - call:          the switch chain or the thunk table, as for uniform collections
+// - profile:       call, plus what ZSTL_TAGGED_PTR_PROFILE adds to it (one
+//   dispatch_profile::record per call); its ranking() picks the hot types below
+// - likely(hot):   call_likely with the two hot types from the profile
+// - likely(cold):  call_likely with two rare types, the cost of a stale ordering
+
+#include <ZSTL/tagged_ptr.hpp>
+#include <ZSTL/dispatch_profile.hpp>
+
+#include <iostream>
+#include <iomanip>
+#include <chrono>
+#include <random>
+#include <tuple>
+#include <vector>
+#include <utility>
+#include <cstddef>
+
+
+static constexpr std::size_t M { 1uz << 22 };
+static constexpr std::size_t REPEAT { 4uz };
+static constexpr double HOT_SHARE { 0.92 };
+
+using clock_type = std::chrono::steady_clock;
+
+template <typename Func>
+static double ns_per_call(Func &&func) {
+    auto start = clock_type::now();
+    for (std::size_t r { 0uz }; r < REPEAT; ++r) {
+        func();
+    }
+    double ns = std::chrono::duration<double, std::nano>(clock_type::now() - start).count();
+    return ns / static_cast<double>(M * REPEAT);
+}
+
+template <std::size_t I>
+struct shape {
+    double value { 1.0 };
+    double get() const { return this->value * static_cast<double>(I + 1uz); }
+};
+
+static double sink { 0.0 };
+
+template <std::size_t... Is>
+static void run(std::index_sequence<Is...>) {
+    constexpr std::size_t N = sizeof...(Is);
+    using tagged = zstl::tagged_ptr<shape<Is>...>;
+    using profile = zstl::dispatch_profile<shape<Is>...>;
+
+    // the hot types sit in the middle of the list, so that call gains nothing
+    //   from their position
+    constexpr std::size_t HOT_A = N / 2uz, HOT_B = N / 2uz + 1uz;
+
+    std::mt19937_64 rng(42u);
+    std::uniform_real_distribution<double> u(0.0, 1.0);
+    std::vector<std::size_t> kinds(M);
+    for (std::size_t &k : kinds) {
+        double x = u(rng);
+        k = x < HOT_SHARE * 0.75 ? HOT_A
+            : x < HOT_SHARE ? HOT_B
+            : rng() % N;
+    }
+
+    std::tuple<std::vector<shape<Is>>...> objects { std::vector<shape<Is>>(M)... };
+    std::vector<tagged> tagged_ptrs;
+    tagged_ptrs.reserve(M);
+    for (std::size_t i { 0uz }; i < M; ++i) {
+        std::size_t k = kinds[i];
+        ((k == Is ? (tagged_ptrs.emplace_back(&std::get<Is>(objects)[i]), 0) : 0), ...);
+    }
+
+    auto get = [](const auto *p) { return p->get(); };
+
+    double viaCall = ns_per_call([&] {
+        double sum { 0.0 };
+        for (const tagged &p : tagged_ptrs) {
+            sum += p.call(get);
+        }
+        sink += sum;
+    });
+    profile::reset();
+    double viaProfile = ns_per_call([&] {
+        double sum { 0.0 };
+        for (const tagged &p : tagged_ptrs) {
+            profile::record(p.tag());
+            sum += p.call(get);
+        }
+        sink += sum;
+    });
+    auto ranking = profile::ranking();
+    if (ranking[0uz] != HOT_A + 1uz || ranking[1uz] != HOT_B + 1uz) {
+        std::cerr << "profile ranking does not match the distribution" << std::endl;
+    }
+
+    using hot_a = std::tuple_element_t<HOT_A, std::tuple<shape<Is>...>>;
+    using hot_b = std::tuple_element_t<HOT_B, std::tuple<shape<Is>...>>;
+    using cold_a = shape<0uz>;
+    using cold_b = std::tuple_element_t<N - 1uz, std::tuple<shape<Is>...>>;
+
+    double viaHot = ns_per_call([&] {
+        double sum { 0.0 };
+        for (const tagged &p : tagged_ptrs) {
+            sum += p.template call_likely<hot_a, hot_b>(get);
+        }
+        sink += sum;
+    });
+    double viaCold = ns_per_call([&] {
+        double sum { 0.0 };
+        for (const tagged &p : tagged_ptrs) {
+            sum += p.template call_likely<cold_a, cold_b>(get);
+        }
+        sink += sum;
+    });
+
+    std::cout << std::setw(6) << N
+        << std::fixed << std::setprecision(2)
+        << std::setw(10) << viaCall
+        << std::setw(10) << viaProfile
+        << std::setw(14) << viaHot
+        << std::setw(14) << viaCold << '\n';
+}
+
+
+int main() {
+    std::cout << "pointers: " << M << ", hot share: " << HOT_SHARE << ", ns per call\n";
+    std::cout << std::setw(6) << "types"
+        << std::setw(10) << "call"
+        << std::setw(10) << "profile"
+        << std::setw(14) << "likely(hot)"
+        << std::setw(14) << "likely(cold)" << '\n';
+
+    run(std::make_index_sequence<4uz>());
+    run(std::make_index_sequence<8uz>());
+    run(std::make_index_sequence<16uz>());
+    run(std::make_index_sequence<31uz>());
+
+    std::cout << "(checksum " << sink << ")" << std::endl;
+
+    return 0;
+}
@@ -0,0 +1,165 @@
+#pragma once
+
+#include "tagged_ptr.hpp"
+
+#include <atomic>
+#include <cstdint>
+#include <cstddef>
+#include <stdexcept>
+
+
+// atomic_tagged_ptr
+// A `tagged_ptr<Ts...>` that can be shared between threads: load/store/exchange
+//   and compare_exchange on one 64-bit word, so it is lock-free wherever
+//   std::atomic<std::uintptr_t> is
+// The word keeps the tagged_ptr layout (type tag in the top bits, address below)
+//   and uses the address bits above ADDRESS_BITS, unused by user-space pointers
+//   on 4-level paging, as a generation counter against ABA:
+//   [ tag : 5 | generation : 11 | address : 48 ]
+// Every successful store/exchange/compare_exchange bumps the generation, so a
+//   compare_exchange that expects a snapshot fails if the pointer was swapped out
+//   and back in between, as long as it did not happen a multiple of 2^11 times
+// The counter lives in the high bits rather than in low alignment bits so that
+//   the pointee types may be incomplete (nodes that point to each other); a host
+//   with wider user-space addresses (5-level paging) is refused with
+//   std::runtime_error when an atomic_tagged_ptr is constructed
+namespace zstl {
+
+template <typename... Ts>
+class atomic_tagged_ptr {
+public:
+    using value_type = tagged_ptr<Ts...>;
+
+    static constexpr std::uint64_t ADDRESS_BITS { 48uz };
+    static constexpr std::uint64_t GENERATION_BITS = value_type::ADDRESS_BITS - ADDRESS_BITS;
+
+    static constexpr bool is_always_lock_free = std::atomic<std::uintptr_t>::is_always_lock_free;
+
+private:
+    static constexpr std::uintptr_t GENERATION_MASK =
+        ((std::uintptr_t { 1u } << GENERATION_BITS) - 1u) << ADDRESS_BITS;
+
+    std::atomic<std::uintptr_t> word { 0u };
+
+    // called by the constructors rather than from a static initializer, so that
+    //   the error can be caught; the host is probed only once
+    static void check_address_space() {
+        if (user_address_bits() > ADDRESS_BITS) [[unlikely]] {
+            throw std::runtime_error(
+                "atomic_tagged_ptr: user-space addresses overlap the generation counter"
+            );
+        }
+    }
+
+public:
+    // A loaded value together with its generation; the `expected` argument of
+    //   compare_exchange, so that ABA is detected
+    class snapshot {
+    private:
+        std::uintptr_t word { 0u };
+
+        friend class atomic_tagged_ptr;
+
+        explicit snapshot(std::uintptr_t word) noexcept
+            : word(word)
+        {}
+
+    public:
+        snapshot() = default;
+
+        value_type get() const noexcept {
+            return value_type::from_raw(this->word & ~GENERATION_MASK);
+        }
+
+        std::uint64_t generation() const noexcept {
+            return static_cast<std::uint64_t>((this->word & GENERATION_MASK) >> ADDRESS_BITS);
+        }
+
+        friend bool operator==(const snapshot &, const snapshot &) = default;
+    };
+
+    // Constructor
+    atomic_tagged_ptr() {
+        check_address_space();
+    }
+
+    atomic_tagged_ptr(value_type desired)
+        : word(compose(desired, 0u))
+    {
+        check_address_space();
+    }
+
+    atomic_tagged_ptr(const atomic_tagged_ptr &) = delete;
+    atomic_tagged_ptr &operator=(const atomic_tagged_ptr &) = delete;
+
+    bool is_lock_free() const noexcept {
+        return this->word.is_lock_free();
+    }
+
+    value_type load(std::memory_order order = std::memory_order_seq_cst) const noexcept {
+        return this->load_snapshot(order).get();
+    }
+
+    snapshot load_snapshot(std::memory_order order = std::memory_order_seq_cst) const noexcept {
+        return snapshot(this->word.load(order));
+    }
+
+    void store(value_type desired, std::memory_order order = std::memory_order_seq_cst) noexcept {
+        this->exchange(desired, order);
+    }
+
+    value_type exchange(value_type desired, std::memory_order order = std::memory_order_seq_cst) noexcept {
+        std::uintptr_t current = this->word.load(std::memory_order_relaxed);
+        while (!this->word.compare_exchange_weak(
+            current,
+            next_word(current, desired),
+            order,
+            std::memory_order_relaxed
+        )) {}
+
+        return snapshot(current).get();
+    }
+
+    // Replaces the value with `desired` if it still is `expected`, generation
+    //   included; otherwise loads the current value into `expected`
+    bool compare_exchange_weak(
+        snapshot &expected,
+        value_type desired,
+        std::memory_order success = std::memory_order_seq_cst,
+        std::memory_order failure = std::memory_order_seq_cst
+    ) noexcept {
+        return this->word.compare_exchange_weak(
+            expected.word,
+            next_word(expected.word, desired),
+            success,
+            failure
+        );
+    }
+
+    bool compare_exchange_strong(
+        snapshot &expected,
+        value_type desired,
+        std::memory_order success = std::memory_order_seq_cst,
+        std::memory_order failure = std::memory_order_seq_cst
+    ) noexcept {
+        return this->word.compare_exchange_strong(
+            expected.word,
+            next_word(expected.word, desired),
+            success,
+            failure
+        );
+    }
+
+private:
+    static std::uintptr_t compose(value_type p, std::uint64_t generation) noexcept {
+        // DCHECK_EQ(p.raw() & GENERATION_MASK, 0u);  // address wider than ADDRESS_BITS
+        return p.raw() | ((static_cast<std::uintptr_t>(generation) << ADDRESS_BITS) & GENERATION_MASK);
+    }
+
+    // `desired`, one generation after `current`
+    static std::uintptr_t next_word(std::uintptr_t current, value_type desired) noexcept {
+        return compose(desired, snapshot(current).generation() + 1u);
+    }
+};
+
+} // namespace zstl end
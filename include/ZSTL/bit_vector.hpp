@@ -0,0 +1,490 @@
+#pragma once
+
+#include "memory_resource.hpp"
+#include "vector.hpp"
+#include "simd.hpp" // zstl::simd::detected_level, zstl::simd::detail::vec_t
+
+#include <bit> // std::popcount, std::countr_zero
+#include <span>
+#include <algorithm> // std::min
+#include <cstdint>
+#include <cstddef>
+#include <cstring>
+#include <stdexcept>
+
+#ifdef ZSTL_SIMD_X86
+#include <immintrin.h>
+#endif
+
+
+// Packed vector of bits stored in 64-bit words from a `memory_resource`
+// - bulk AND/OR/XOR/ANDNOT between equally sized bit_vectors run on SSE2/AVX2/AVX-512
+//   registers (picked at runtime like the zstl::simd kernels)
+// - count() uses AVX-512 VPOPCNTDQ or the POPCNT instruction when available
+// - build_rank_select() adds a succinct index (about 5% of the bits):
+//   absolute counts every 4096 bits (superblocks), counts relative to the superblock
+//   every 512 bits (blocks), and the superblock of every 4096th set bit;
+//   rank1() is then O(1) (at most 8 word popcounts) and select1() searches only the
+//   superblocks between two samples before scanning at most 8 blocks and 8 words
+// Any modification invalidates the index until build_rank_select() is called again
+// Bits past size() in the last word are always zero
+namespace zstl {
+
+namespace detail::bit_vector {
+
+using word_type = std::uint64_t;
+
+inline constexpr std::size_t WORD_BITS { 64uz };
+inline constexpr std::size_t BLOCK_WORDS { 8uz };          // 512 bits
+inline constexpr std::size_t SUPERBLOCK_WORDS { 64uz };    // 4096 bits
+inline constexpr std::size_t SELECT_SAMPLE { 4096uz };     // set bits between samples
+
+enum class bitwise_op {
+    and_,
+    or_,
+    xor_,
+    and_not
+};
+
+template <bitwise_op Op, typename W>
+[[gnu::always_inline]] inline void combine(W &a, const W &b) noexcept {
+    if constexpr (Op == bitwise_op::and_) {
+        a &= b;
+    } else if constexpr (Op == bitwise_op::or_) {
+        a |= b;
+    } else if constexpr (Op == bitwise_op::xor_) {
+        a ^= b;
+    } else {
+        a &= ~b;
+    }
+}
+
+template <bitwise_op Op>
+void bitwise_scalar(word_type *dst, const word_type *src, std::size_t n) noexcept {
+    for (std::size_t i { 0uz }; i < n; ++i) {
+        combine<Op>(dst[i], src[i]);
+    }
+}
+
+inline std::size_t popcount_scalar(const word_type *w, std::size_t n) noexcept {
+    std::size_t c { 0uz };
+    for (std::size_t i { 0uz }; i < n; ++i) {
+        c += static_cast<std::size_t>(std::popcount(w[i]));
+    }
+    return c;
+}
+
+
+#ifdef ZSTL_SIMD_X86
+
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wpsabi"
+
+template <bitwise_op Op, std::size_t Bytes>
+[[gnu::always_inline]] inline void bitwise_kernel(word_type *dst, const word_type *src, std::size_t n) noexcept {
+    using V = zstl::simd::detail::vec_t<word_type, Bytes>;
+    constexpr std::size_t L = Bytes / sizeof(word_type);
+
+    std::size_t i { 0uz };
+    for (; i + L <= n; i += L) {
+        V a = zstl::simd::detail::load<V>(dst + i);
+        V b = zstl::simd::detail::load<V>(src + i);
+        combine<Op>(a, b);
+        std::memcpy(dst + i, &a, Bytes);
+    }
+    bitwise_scalar<Op>(dst + i, src + i, n - i);
+}
+
+template <bitwise_op Op>
+[[gnu::target("sse2")]] void bitwise_sse2(word_type *dst, const word_type *src, std::size_t n) noexcept {
+    bitwise_kernel<Op, 16uz>(dst, src, n);
+}
+
+template <bitwise_op Op>
+[[gnu::target("avx2")]] void bitwise_avx2(word_type *dst, const word_type *src, std::size_t n) noexcept {
+    bitwise_kernel<Op, 32uz>(dst, src, n);
+}
+
+template <bitwise_op Op>
+[[gnu::target("avx512f,avx512bw,avx512dq,avx512vl")]]
+void bitwise_avx512(word_type *dst, const word_type *src, std::size_t n) noexcept {
+    bitwise_kernel<Op, 64uz>(dst, src, n);
+}
+
+[[gnu::target("popcnt")]]
+inline std::size_t popcount_popcnt(const word_type *w, std::size_t n) noexcept {
+    std::size_t c { 0uz };
+    for (std::size_t i { 0uz }; i < n; ++i) {
+        c += static_cast<std::size_t>(__builtin_popcountll(w[i]));
+    }
+    return c;
+}
+
+[[gnu::target("popcnt,avx512f,avx512vpopcntdq")]]
+inline std::size_t popcount_avx512(const word_type *w, std::size_t n) noexcept {
+    __m512i acc0 = _mm512_setzero_si512();
+    __m512i acc1 = _mm512_setzero_si512();
+    std::size_t i { 0uz };
+    for (; i + 16uz <= n; i += 16uz) {
+        acc0 = _mm512_add_epi64(acc0, _mm512_popcnt_epi64(_mm512_loadu_si512(w + i)));
+        acc1 = _mm512_add_epi64(acc1, _mm512_popcnt_epi64(_mm512_loadu_si512(w + i + 8uz)));
+    }
+    alignas(64) std::uint64_t lanes[8];
+    _mm512_store_si512(lanes, _mm512_add_epi64(acc0, acc1));
+    std::size_t c { 0uz };
+    for (std::uint64_t lane : lanes) {
+        c += static_cast<std::size_t>(lane);
+    }
+    for (; i < n; ++i) {
+        c += static_cast<std::size_t>(__builtin_popcountll(w[i]));
+    }
+    return c;
+}
+
+#pragma GCC diagnostic pop
+
+#endif // ZSTL_SIMD_X86
+
+
+template <bitwise_op Op>
+void bitwise(word_type *dst, const word_type *src, std::size_t n) noexcept {
+#ifdef ZSTL_SIMD_X86
+    switch (zstl::simd::detected_level()) {
+        case zstl::simd::level::avx512: return bitwise_avx512<Op>(dst, src, n);
+        case zstl::simd::level::avx2: return bitwise_avx2<Op>(dst, src, n);
+        case zstl::simd::level::sse2: return bitwise_sse2<Op>(dst, src, n);
+        case zstl::simd::level::scalar: break;
+    }
+#endif
+    bitwise_scalar<Op>(dst, src, n);
+}
+
+inline std::size_t popcount(const word_type *w, std::size_t n) noexcept {
+#ifdef ZSTL_SIMD_X86
+    using popcount_fn = std::size_t (*)(const word_type *, std::size_t);
+    static const popcount_fn best = [] () -> popcount_fn {
+        __builtin_cpu_init();
+        if (__builtin_cpu_supports("avx512vpopcntdq") && __builtin_cpu_supports("popcnt")) {
+            return popcount_avx512;
+        }
+        if (__builtin_cpu_supports("popcnt")) {
+            return popcount_popcnt;
+        }
+        return popcount_scalar;
+    }();
+    return best(w, n);
+#else
+    return popcount_scalar(w, n);
+#endif
+}
+
+// position of the set bit of rank `r` (0-based) in `w`, which has more than `r` set bits
+inline std::size_t select_in_word(word_type w, std::size_t r) noexcept {
+#ifdef __BMI2__
+    return static_cast<std::size_t>(std::countr_zero(_pdep_u64(word_type { 1u } << r, w)));
+#else
+    // skip whole bytes first, then clear the remaining lower set bits
+    std::size_t shift { 0uz };
+    for (;;) {
+        std::size_t c = static_cast<std::size_t>(std::popcount(static_cast<std::uint8_t>(w >> shift)));
+        if (c > r) { break; }
+        r -= c;
+        shift += 8uz;
+    }
+    word_type rest = w >> shift;
+    for (; r != 0uz; --r) {
+        rest &= rest - 1u;
+    }
+    return shift + static_cast<std::size_t>(std::countr_zero(rest));
+#endif
+}
+
+} // namespace detail::bit_vector end
+
+
+class bit_vector {
+public:
+    using word_type = detail::bit_vector::word_type;
+    using size_type = std::size_t;
+    using allocator_type = pmr::polymorphic_allocator<word_type>;
+
+private:
+    static constexpr size_type WORD_BITS = detail::bit_vector::WORD_BITS;
+
+    zstl::vector<word_type> storage;
+    size_type nBits { 0uz };
+
+    // rank/select index, see build_rank_select()
+    zstl::vector<std::uint64_t> superCounts;
+    zstl::vector<std::uint16_t> blockCounts;
+    zstl::vector<std::uint32_t> selectSamples;
+    size_type nOnes { 0uz };
+    bool indexed { false };
+
+public:
+    bit_vector() = default;
+
+    explicit bit_vector(const allocator_type &alloc)
+        : storage(alloc)
+        , superCounts(pmr::polymorphic_allocator<std::uint64_t>(alloc.resource()))
+        , blockCounts(pmr::polymorphic_allocator<std::uint16_t>(alloc.resource()))
+        , selectSamples(pmr::polymorphic_allocator<std::uint32_t>(alloc.resource()))
+    {}
+
+    explicit bit_vector(
+        size_type count,
+        bool value = false,
+        const allocator_type &alloc = allocator_type()
+    )
+        : bit_vector(alloc)
+    {
+        this->resize(count, value);
+    }
+
+    bit_vector(const bit_vector &other) = default;
+    bit_vector(bit_vector &&other) noexcept = default;
+    bit_vector &operator=(const bit_vector &other) = default;
+    bit_vector &operator=(bit_vector &&other) noexcept = default;
+
+    allocator_type get_allocator() const noexcept {
+        return this->storage.get_allocator();
+    }
+
+    // Element access
+    bool operator[](size_type pos) const noexcept {
+        // DCHECK_LT(pos, nBits);
+        return (this->storage[pos / WORD_BITS] >> (pos % WORD_BITS)) & 1u;
+    }
+
+    bool test(size_type pos) const {
+        if (pos >= this->nBits) [[unlikely]] {
+            throw std::out_of_range("bit_vector::test");
+        }
+        return (*this)[pos];
+    }
+
+    // Capacity
+    size_type size() const noexcept {
+        return this->nBits;
+    }
+
+    bool empty() const noexcept {
+        return this->nBits == 0uz;
+    }
+
+    size_type word_count() const noexcept {
+        return this->storage.size();
+    }
+
+    std::span<const word_type> words() const noexcept {
+        return std::span<const word_type>(this->storage.data(), this->storage.size());
+    }
+
+    void reserve(size_type bits) {
+        this->storage.reserve((bits + WORD_BITS - 1uz) / WORD_BITS);
+    }
+
+    // Modifiers
+    void set(size_type pos, bool value = true) noexcept {
+        // DCHECK_LT(pos, nBits);
+        word_type bit = word_type { 1u } << (pos % WORD_BITS);
+        word_type &w = this->storage[pos / WORD_BITS];
+        w = value ? (w | bit) : (w & ~bit);
+        this->indexed = false;
+    }
+
+    void reset(size_type pos) noexcept {
+        this->set(pos, false);
+    }
+
+    void flip(size_type pos) noexcept {
+        // DCHECK_LT(pos, nBits);
+        this->storage[pos / WORD_BITS] ^= word_type { 1u } << (pos % WORD_BITS);
+        this->indexed = false;
+    }
+
+    void push_back(bool value) {
+        if (this->nBits % WORD_BITS == 0uz) {
+            this->storage.push_back(word_type { 0u });
+        }
+        ++(this->nBits);
+        this->set(this->nBits - 1uz, value);
+    }
+
+    void resize(size_type count, bool value = false) {
+        size_type oldBits = this->nBits;
+        size_type nWords = (count + WORD_BITS - 1uz) / WORD_BITS;
+        this->storage.resize(nWords, value ? ~word_type { 0u } : word_type { 0u });
+        this->nBits = count;
+
+        // the bits of the old last word past the old size were zero
+        if (value && count > oldBits && oldBits % WORD_BITS != 0uz) {
+            this->storage[oldBits / WORD_BITS] |= ~word_type { 0u } << (oldBits % WORD_BITS);
+        }
+        this->clear_tail();
+        this->indexed = false;
+    }
+
+    void clear() noexcept {
+        this->storage.clear();
+        this->nBits = 0uz;
+        this->indexed = false;
+    }
+
+    // Bulk operations; both operands must have the same size
+    bit_vector &operator&=(const bit_vector &other) {
+        return this->apply<detail::bit_vector::bitwise_op::and_>(other);
+    }
+
+    bit_vector &operator|=(const bit_vector &other) {
+        return this->apply<detail::bit_vector::bitwise_op::or_>(other);
+    }
+
+    bit_vector &operator^=(const bit_vector &other) {
+        return this->apply<detail::bit_vector::bitwise_op::xor_>(other);
+    }
+
+    // *this &= ~other
+    bit_vector &and_not(const bit_vector &other) {
+        return this->apply<detail::bit_vector::bitwise_op::and_not>(other);
+    }
+
+    // Number of set bits
+    size_type count() const noexcept {
+        if (this->indexed) {
+            return this->nOnes;
+        }
+        return detail::bit_vector::popcount(this->storage.data(), this->storage.size());
+    }
+
+    // Rank/select
+    void build_rank_select() {
+        namespace impl = detail::bit_vector;
+
+        size_type nWords = this->storage.size();
+        size_type nBlocks = nWords / impl::BLOCK_WORDS + 1uz;
+        size_type nSupers = nWords / impl::SUPERBLOCK_WORDS + 1uz;
+        this->blockCounts.resize_for_overwrite(nBlocks);
+        this->superCounts.resize_for_overwrite(nSupers);
+        this->selectSamples.clear();
+
+        size_type total { 0uz };
+        size_type nextSample { 0uz };
+        for (size_type block { 0uz }; block < nBlocks; ++block) {
+            size_type firstWord = block * impl::BLOCK_WORDS;
+            if (firstWord % impl::SUPERBLOCK_WORDS == 0uz) {
+                this->superCounts[firstWord / impl::SUPERBLOCK_WORDS] = total;
+            }
+            size_type super = this->superCounts[firstWord / impl::SUPERBLOCK_WORDS];
+            this->blockCounts[block] = static_cast<std::uint16_t>(total - super);
+
+            size_type nBlockWords = firstWord < nWords ? std::min(impl::BLOCK_WORDS, nWords - firstWord) : 0uz;
+            total += impl::popcount(this->storage.data() + firstWord, nBlockWords);
+            // every SELECT_SAMPLE-th set bit falls in this block's superblock
+            while (nextSample < total) {
+                this->selectSamples.push_back(static_cast<std::uint32_t>(firstWord / impl::SUPERBLOCK_WORDS));
+                nextSample += impl::SELECT_SAMPLE;
+            }
+        }
+        this->nOnes = total;
+        this->indexed = true;
+    }
+
+    bool has_rank_select() const noexcept {
+        return this->indexed;
+    }
+
+    // Number of set bits in [0, pos), pos <= size()
+    size_type rank1(size_type pos) const {
+        namespace impl = detail::bit_vector;
+        this->check_index();
+        if (pos > this->nBits) [[unlikely]] {
+            throw std::out_of_range("bit_vector::rank1");
+        }
+
+        size_type word = pos / WORD_BITS;
+        size_type block = word / impl::BLOCK_WORDS;
+        size_type r = this->superCounts[word / impl::SUPERBLOCK_WORDS] + this->blockCounts[block];
+        for (size_type w = block * impl::BLOCK_WORDS; w < word; ++w) {
+            r += static_cast<size_type>(std::popcount(this->storage[w]));
+        }
+        if (pos % WORD_BITS != 0uz) {
+            word_type mask = (word_type { 1u } << (pos % WORD_BITS)) - 1u;
+            r += static_cast<size_type>(std::popcount(this->storage[word] & mask));
+        }
+        return r;
+    }
+
+    size_type rank0(size_type pos) const {
+        return pos - this->rank1(pos);
+    }
+
+    // Position of the set bit of rank k (0-based), k < count()
+    size_type select1(size_type k) const {
+        namespace impl = detail::bit_vector;
+        this->check_index();
+        if (k >= this->nOnes) [[unlikely]] {
+            throw std::out_of_range("bit_vector::select1");
+        }
+
+        // the samples bound the superblocks that can hold the k-th set bit
+        size_type sample = k / impl::SELECT_SAMPLE;
+        size_type lo = this->selectSamples[sample];
+        size_type hi = sample + 1uz < this->selectSamples.size()
+            ? this->selectSamples[sample + 1uz] + 1uz
+            : this->superCounts.size();
+        // last superblock in [lo, hi) that starts at or before the k-th set bit
+        while (hi - lo > 1uz) {
+            size_type mid = lo + (hi - lo) / 2uz;
+            if (this->superCounts[mid] <= k) {
+                lo = mid;
+            } else {
+                hi = mid;
+            }
+        }
+        size_type rest = k - this->superCounts[lo];
+
+        size_type block = lo * (impl::SUPERBLOCK_WORDS / impl::BLOCK_WORDS);
+        size_type lastBlock = std::min(
+            block + impl::SUPERBLOCK_WORDS / impl::BLOCK_WORDS,
+            this->blockCounts.size()
+        );
+        while (block + 1uz < lastBlock && this->blockCounts[block + 1uz] <= rest) {
+            ++block;
+        }
+        rest -= this->blockCounts[block];
+
+        size_type word = block * impl::BLOCK_WORDS;
+        for (;; ++word) {
+            size_type c = static_cast<size_type>(std::popcount(this->storage[word]));
+            if (rest < c) { break; }
+            rest -= c;
+        }
+        return word * WORD_BITS + impl::select_in_word(this->storage[word], rest);
+    }
+
+private:
+    template <detail::bit_vector::bitwise_op Op>
+    bit_vector &apply(const bit_vector &other) {
+        if (other.nBits != this->nBits) [[unlikely]] {
+            throw std::invalid_argument("bit_vector: size mismatch");
+        }
+        detail::bit_vector::bitwise<Op>(this->storage.data(), other.storage.data(), this->storage.size());
+        this->indexed = false;
+        return *this;
+    }
+
+    void clear_tail() noexcept {
+        if (this->nBits % WORD_BITS != 0uz) {
+            this->storage.back() &= (word_type { 1u } << (this->nBits % WORD_BITS)) - 1u;
+        }
+    }
+
+    void check_index() const {
+        if (!this->indexed) [[unlikely]] {
+            throw std::logic_error("bit_vector: build_rank_select() must follow any modification");
+        }
+    }
+};
+
+} // namespace zstl end
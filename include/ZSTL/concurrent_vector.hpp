@@ -0,0 +1,390 @@
+#pragma once
+
+#include "memory_resource.hpp"
+#include "segmented_vector.hpp" // segment layout
+
+#include <atomic>
+#include <array>
+#include <limits>
+#include <algorithm>
+#include <memory>
+#include <cstddef>
+#include <cstdint>
+#include <utility>
+#include <stdexcept>
+#include <type_traits>
+
+
+// concurrent_vector
+// A grow-only vector that many threads can append to without a lock
+// It uses the same segment layout as `segmented_vector`:
+//   - push_back()/grow_by() reserve their slots with one atomic fetch_add on the size
+//   - the first thread that needs a segment allocates it and installs it with a CAS,
+//     losers of the race give their allocation back
+//   - every slot has a state byte, set once its element is constructed; size() is
+//     the length of the prefix of constructed slots, advanced with a CAS by
+//     whichever appender finds it can be, so no appender waits for another and
+//     any thread may read the indices below size()
+//   - elements never move, so an index stays readable, and its address valid,
+//     until clear()
+// A constructor that throws from push_back()/grow_by() leaves a hole that size()
+//   cannot pass: every later append throws std::runtime_error until clear(). The
+//   elements appended concurrently with the failed one stay reachable through the
+//   reference or index they returned, and clear() destroys every constructed slot
+// The memory_resource must itself be thread-safe (new_delete_resource() is)
+namespace zstl {
+
+template <
+    typename _Tp,
+    std::size_t FirstSegmentSize = 64uz,
+    class Allocator = pmr::polymorphic_allocator<_Tp>
+>
+class concurrent_vector {
+public:
+    using value_type = _Tp;
+    using allocator_type = Allocator;
+    using size_type = std::size_t;
+    using difference_type = std::ptrdiff_t;
+    using reference = _Tp &;
+    using const_reference = const _Tp &;
+    using pointer = _Tp *;
+    using const_pointer = const _Tp *;
+
+private:
+    using layout = segmented_vector<_Tp, FirstSegmentSize, Allocator>;
+
+    static constexpr size_type MAX_SEGMENTS = layout::segment_of(
+        std::numeric_limits<size_type>::max()
+    ) + 1uz;
+
+    using state_type = std::atomic<std::uint8_t>;
+
+    static constexpr std::uint8_t EMPTY { 0u };
+    static constexpr std::uint8_t CONSTRUCTED { 1u };
+    static constexpr std::uint8_t FAILED { 2u };
+
+    allocator_type alloc;
+    std::array<std::atomic<pointer>, MAX_SEGMENTS> segments {};
+    // one state byte per slot of the segment of the same index, installed before it
+    std::array<std::atomic<state_type *>, MAX_SEGMENTS> states {};
+    // keep the hot counters off the cache line holding the segment table
+    alignas(64) std::atomic<size_type> nReserved { 0uz };
+    // slots [0, nPublished) are constructed, see publish()
+    alignas(64) std::atomic<size_type> nPublished { 0uz };
+    // set when a constructor threw, rejects every later append
+    std::atomic<bool> broken { false };
+
+public:
+    // Constructor
+    concurrent_vector() noexcept(noexcept(allocator_type())) = default;
+
+    explicit concurrent_vector(const allocator_type &alloc) noexcept
+        : alloc(alloc)
+    {}
+
+    concurrent_vector(const concurrent_vector &) = delete;
+    concurrent_vector &operator=(const concurrent_vector &) = delete;
+
+    // Destructor
+    ~concurrent_vector() {
+        this->clear();
+        for (size_type seg { 0uz }; seg < MAX_SEGMENTS; ++seg) {
+            pointer p = this->segments[seg].load(std::memory_order_relaxed);
+            if (p) {
+                this->alloc.template deallocate_object<value_type>(
+                    p,
+                    layout::segment_size(seg)
+                );
+            }
+            state_type *st = this->states[seg].load(std::memory_order_relaxed);
+            if (st) {
+                this->alloc.template deallocate_object<state_type>(
+                    st,
+                    layout::segment_size(seg)
+                );
+            }
+        }
+    }
+
+    allocator_type get_allocator() const noexcept {
+        return this->alloc;
+    }
+
+    // Element access
+    reference at(size_type index) {
+        if (index >= this->size()) [[unlikely]] {
+            throw std::out_of_range("concurrent_vector::at");
+        }
+
+        return (*this)[index];
+    }
+
+    const_reference at(size_type index) const {
+        if (index >= this->size()) [[unlikely]] {
+            throw std::out_of_range("concurrent_vector::at");
+        }
+
+        return (*this)[index];
+    }
+
+    reference operator[](size_type index) noexcept {
+        size_type seg = layout::segment_of(index);
+        return this->segments[seg].load(std::memory_order_acquire)[index - layout::segment_begin(seg)];
+    }
+
+    const_reference operator[](size_type index) const noexcept {
+        size_type seg = layout::segment_of(index);
+        return this->segments[seg].load(std::memory_order_acquire)[index - layout::segment_begin(seg)];
+    }
+
+    // Capacity
+    bool empty() const noexcept {
+        return this->size() == 0uz;
+    }
+
+    // Number of published elements: every index below it is constructed and
+    //   safe to read from any thread; an element that is still being constructed
+    //   holds back the ones appended after it
+    size_type size() const noexcept {
+        return this->nPublished.load(std::memory_order_acquire);
+    }
+
+    // Pre-allocates segments so that the first `n` slots never hit the allocation path
+    void reserve(size_type n) {
+        if (n != 0uz) {
+            this->ensure_segments(0uz, n);
+        }
+    }
+
+    // Modifiers (thread-safe)
+    reference push_back(const_reference value) {
+        return this->emplace_back(value);
+    }
+
+    reference push_back(value_type &&value) {
+        return this->emplace_back(std::move(value));
+    }
+
+    template <class... Args>
+    reference emplace_back(Args &&...args) {
+        this->check_not_broken();
+
+        size_type index = this->nReserved.fetch_add(1uz, std::memory_order_relaxed);
+        pointer p;
+        try {
+            p = this->slot(index);
+            this->alloc.construct(p, std::forward<Args>(args)...);
+        } catch (...) {
+            this->fail(index, 1uz);
+            throw;
+        }
+        this->publish(index, 1uz);
+
+        return *p;
+    }
+
+    // Appends `count` copies of `value` as one contiguous range of indices
+    //   and returns the index of the first one
+    size_type grow_by(size_type count, const_reference value = value_type {}) {
+        this->check_not_broken();
+
+        size_type first = this->nReserved.fetch_add(count, std::memory_order_relaxed);
+        if (count == 0uz) {
+            return first;
+        }
+
+        size_type i = first;
+        try {
+            this->ensure_segments(first, first + count);
+            for (; i < first + count; ++i) {
+                this->alloc.construct(&(*this)[i], value);
+            }
+        } catch (...) {
+            for (size_type j = first; j < i; ++j) {
+                this->alloc.destroy(&(*this)[j]);
+            }
+            this->fail(first, count);
+            throw;
+        }
+        this->publish(first, count);
+
+        return first;
+    }
+
+    // Destroys every constructed element, published or not; not thread-safe
+    void clear() noexcept {
+        size_type n = this->nReserved.load(std::memory_order_relaxed);
+        for (size_type i { 0uz }; i < n; ++i) {
+            state_type *st = this->state_if_installed(i);
+            if (!st) {
+                // a failed append reserved slots in a segment it never installed
+                continue;
+            }
+            if constexpr (!std::is_trivially_destructible_v<value_type>) {
+                if (st->load(std::memory_order_relaxed) == CONSTRUCTED) {
+                    this->alloc.destroy(&(*this)[i]);
+                }
+            }
+            st->store(EMPTY, std::memory_order_relaxed);
+        }
+        this->nReserved.store(0uz, std::memory_order_relaxed);
+        this->nPublished.store(0uz, std::memory_order_relaxed);
+        this->broken.store(false, std::memory_order_relaxed);
+    }
+
+private:
+    void check_not_broken() const {
+        if (this->broken.load(std::memory_order_acquire)) [[unlikely]] {
+            throw std::runtime_error("concurrent_vector: an earlier append threw, clear() first");
+        }
+    }
+
+    // Marks the `count` constructed slots from `first` and advances nPublished
+    //   over every constructed slot that follows it
+    // Every publisher does a read-modify-write on nPublished after marking its
+    //   slots, so it synchronizes with all the publishers before it: of two
+    //   appenders that finish neighbouring slots at the same time, the later one
+    //   sees the other's slot constructed and carries nPublished past both
+    void publish(size_type first, size_type count) noexcept {
+        this->mark(first, count, CONSTRUCTED);
+
+        size_type n = this->nPublished.load(std::memory_order_relaxed);
+        if (n == first) [[likely]] {
+            // every earlier slot is published, publish these in the same step
+            if (this->nPublished.compare_exchange_strong(
+                    n,
+                    first + count,
+                    std::memory_order_acq_rel,
+                    std::memory_order_acquire
+                )) {
+                n = first + count;
+            }
+        } else {
+            n = this->nPublished.fetch_add(0uz, std::memory_order_acq_rel);
+        }
+        this->advance(n);
+    }
+
+    // Advances nPublished from `n` over the constructed slots that follow it
+    void advance(size_type n) noexcept {
+        for (;;) {
+            size_type end = n;
+            for (;;) {
+                state_type *st = this->state_if_installed(end);
+                if (!st || st->load(std::memory_order_acquire) != CONSTRUCTED) {
+                    break;
+                }
+                ++end;
+            }
+            if (end == n) {
+                return ;
+            }
+            // on failure `n` is the newer value, scan again from there
+            if (this->nPublished.compare_exchange_weak(
+                    n,
+                    end,
+                    std::memory_order_acq_rel,
+                    std::memory_order_acquire
+                )) {
+                n = end;
+            }
+        }
+    }
+
+    // Marks slots [first, first + count) as never to be constructed
+    void fail(size_type first, size_type count) noexcept {
+        this->broken.store(true, std::memory_order_release);
+        this->mark(first, count, FAILED);
+    }
+
+    // Stores `state` into the slots [first, first + count), one segment at a time;
+    //   skips the segments that were never installed
+    void mark(size_type first, size_type count, std::uint8_t state) noexcept {
+        size_type last = first + count;
+        while (first < last) {
+            size_type seg = layout::segment_of(first);
+            size_type begin = layout::segment_begin(seg);
+            size_type end = std::min(last, begin + layout::segment_size(seg));
+            if (state_type *st = this->states[seg].load(std::memory_order_acquire)) {
+                for (size_type i = first; i < end; ++i) {
+                    st[i - begin].store(state, std::memory_order_release);
+                }
+            }
+            first = end;
+        }
+    }
+
+    state_type *state_if_installed(size_type index) noexcept {
+        size_type seg = layout::segment_of(index);
+        state_type *st = this->states[seg].load(std::memory_order_acquire);
+        return st ? st + (index - layout::segment_begin(seg)) : nullptr;
+    }
+
+    pointer slot(size_type index) {
+        size_type seg = layout::segment_of(index);
+        pointer base = this->segments[seg].load(std::memory_order_acquire);
+        if (!base) [[unlikely]] {
+            base = this->install_segment(seg);
+        }
+
+        return base + (index - layout::segment_begin(seg));
+    }
+
+    void ensure_segments(size_type first, size_type last) {
+        size_type lastSeg = layout::segment_of(last - 1uz);
+        for (size_type seg = layout::segment_of(first); seg <= lastSeg; ++seg) {
+            if (!this->segments[seg].load(std::memory_order_acquire)) {
+                this->install_segment(seg);
+            }
+        }
+    }
+
+    // Installs the states of segment `seg`, then the segment itself, so that a
+    //   thread that sees the segment also sees its states
+    pointer install_segment(size_type seg) {
+        if (!this->states[seg].load(std::memory_order_acquire)) {
+            this->install_states(seg);
+        }
+
+        pointer fresh = this->alloc.template allocate_object<value_type>(
+            layout::segment_size(seg)
+        );
+
+        pointer expected { nullptr };
+        if (this->segments[seg].compare_exchange_strong(
+                expected,
+                fresh,
+                std::memory_order_acq_rel,
+                std::memory_order_acquire
+            )) {
+            return fresh;
+        }
+
+        // another thread installed this segment first
+        this->alloc.template deallocate_object<value_type>(
+            fresh,
+            layout::segment_size(seg)
+        );
+        return expected;
+    }
+
+    void install_states(size_type seg) {
+        size_type n = layout::segment_size(seg);
+        state_type *fresh = this->alloc.template allocate_object<state_type>(n);
+        for (size_type i { 0uz }; i < n; ++i) {
+            std::construct_at(fresh + i, EMPTY);
+        }
+
+        state_type *expected { nullptr };
+        if (!this->states[seg].compare_exchange_strong(
+                expected,
+                fresh,
+                std::memory_order_acq_rel,
+                std::memory_order_acquire
+            )) {
+            this->alloc.template deallocate_object<state_type>(fresh, n);
+        }
+    }
+};
+
+} // namespace zstl end
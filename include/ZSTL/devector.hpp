@@ -0,0 +1,408 @@
+#pragma once
+
+#include "memory_resource.hpp"
+
+#include <memory>
+#include <cstddef>
+#include <cstring>
+#include <utility>
+#include <iterator>
+#include <stdexcept>
+#include <type_traits>
+#include <initializer_list>
+
+
+// devector
+// A contiguous sequence with free capacity at both ends, so push_front/pop_front
+//   are amortized O(1) like push_back/pop_back; the natural container for
+//   sliding windows (push_back + pop_front) and double-ended work queues
+// Layout: [ front free | elements | back free ] inside one allocation of `nAlloc`
+// When one end runs out of room:
+// - if at most half of the buffer is in use, the elements are recentered in place
+//   (no allocation; each side is left with at least a quarter of the buffer, so
+//   the next recentering is Omega(n) pushes away)
+// - otherwise the buffer doubles and the elements land in the middle of it
+// Trivially copyable elements are relocated with one memcpy/memmove, others are
+//   move-constructed and destroyed one by one
+namespace zstl {
+
+template <
+    typename _Tp,
+    class Allocator = pmr::polymorphic_allocator<_Tp>
+>
+class devector {
+public:
+    using value_type = _Tp;
+    using allocator_type = Allocator;
+    using size_type = std::size_t;
+    using difference_type = std::ptrdiff_t;
+    using reference = _Tp &;
+    using const_reference = const _Tp &;
+    using pointer = _Tp *;
+    using const_pointer = const _Tp *;
+    using iterator = _Tp *;
+    using const_iterator = const _Tp *;
+    using reverse_iterator = std::reverse_iterator<iterator>;
+    using const_reverse_iterator = std::reverse_iterator<const_iterator>;
+
+private:
+    allocator_type alloc;
+    pointer buffer { nullptr };
+    size_type nAlloc { 0uz };
+    // elements are buffer[first, first + nStored)
+    size_type first { 0uz };
+    size_type nStored { 0uz };
+
+public:
+    // Constructor
+    devector() noexcept(noexcept(allocator_type())) = default;
+
+    explicit devector(const allocator_type &alloc) noexcept
+        : alloc(alloc)
+    {}
+
+    devector(
+        size_type count,
+        const_reference value,
+        const allocator_type &alloc = allocator_type()
+    )
+        : alloc(alloc)
+    {
+        this->reserve_back(count);
+        for (size_type i { 0uz }; i < count; ++i) {
+            this->push_back(value);
+        }
+    }
+
+    devector(
+        std::initializer_list<value_type> init,
+        const allocator_type &alloc = allocator_type()
+    )
+        : alloc(alloc)
+    {
+        this->reserve_back(init.size());
+        for (const value_type &value : init) {
+            this->push_back(value);
+        }
+    }
+
+    devector(const devector &other)
+        : alloc(other.alloc)
+    {
+        this->reserve_back(other.size());
+        for (const value_type &value : other) {
+            this->push_back(value);
+        }
+    }
+
+    devector(devector &&other) noexcept
+        : alloc(other.alloc)
+        , buffer(other.buffer)
+        , nAlloc(other.nAlloc)
+        , first(other.first)
+        , nStored(other.nStored)
+    {
+        other.buffer = nullptr;
+        other.nAlloc = 0uz;
+        other.first = 0uz;
+        other.nStored = 0uz;
+    }
+
+    devector &operator=(const devector &) = delete;
+    devector &operator=(devector &&) = delete;
+
+    // Destructor
+    ~devector() {
+        this->clear();
+        if (this->buffer) {
+            this->alloc.template deallocate_object<value_type>(this->buffer, this->nAlloc);
+        }
+    }
+
+    allocator_type get_allocator() const noexcept {
+        return this->alloc;
+    }
+
+    // Element access
+    reference at(size_type index) {
+        if (index >= this->nStored) [[unlikely]] {
+            throw std::out_of_range("devector::at");
+        }
+
+        return this->data()[index];
+    }
+
+    const_reference at(size_type index) const {
+        if (index >= this->nStored) [[unlikely]] {
+            throw std::out_of_range("devector::at");
+        }
+
+        return this->data()[index];
+    }
+
+    reference operator[](size_type index) noexcept {
+        // DCHECK_LT(index, this->nStored);
+        return this->data()[index];
+    }
+
+    const_reference operator[](size_type index) const noexcept {
+        // DCHECK_LT(index, this->nStored);
+        return this->data()[index];
+    }
+
+    reference front() noexcept { return this->data()[0uz]; }
+    const_reference front() const noexcept { return this->data()[0uz]; }
+    reference back() noexcept { return this->data()[this->nStored - 1uz]; }
+    const_reference back() const noexcept { return this->data()[this->nStored - 1uz]; }
+
+    pointer data() noexcept { return this->buffer + this->first; }
+    const_pointer data() const noexcept { return this->buffer + this->first; }
+
+    // Iterators
+    iterator begin() noexcept { return this->data(); }
+    const_iterator begin() const noexcept { return this->data(); }
+    const_iterator cbegin() const noexcept { return this->data(); }
+    iterator end() noexcept { return this->data() + this->nStored; }
+    const_iterator end() const noexcept { return this->data() + this->nStored; }
+    const_iterator cend() const noexcept { return this->data() + this->nStored; }
+    reverse_iterator rbegin() noexcept { return reverse_iterator(this->end()); }
+    const_reverse_iterator rbegin() const noexcept { return const_reverse_iterator(this->end()); }
+    reverse_iterator rend() noexcept { return reverse_iterator(this->begin()); }
+    const_reverse_iterator rend() const noexcept { return const_reverse_iterator(this->begin()); }
+
+    // Capacity
+    bool empty() const noexcept {
+        return this->nStored == 0uz;
+    }
+
+    size_type size() const noexcept {
+        return this->nStored;
+    }
+
+    size_type capacity() const noexcept {
+        return this->nAlloc;
+    }
+
+    // Elements that push_front/push_back can add before the buffer is reorganized
+    size_type front_free_capacity() const noexcept {
+        return this->first;
+    }
+
+    size_type back_free_capacity() const noexcept {
+        return this->nAlloc - this->first - this->nStored;
+    }
+
+    void reserve_front(size_type n) {
+        if (n > this->nStored) {
+            this->make_room_front(n - this->nStored);
+        }
+    }
+
+    void reserve_back(size_type n) {
+        if (n > this->nStored) {
+            this->make_room_back(n - this->nStored);
+        }
+    }
+
+    // Modifiers
+    void clear() noexcept {
+        if constexpr (!std::is_trivially_destructible_v<value_type>) {
+            for (size_type i { 0uz }; i < this->nStored; ++i) {
+                this->alloc.destroy(this->data() + i);
+            }
+        }
+        this->first = this->nAlloc / 2uz;
+        this->nStored = 0uz;
+    }
+
+    void push_back(const_reference value) {
+        this->emplace_back(value);
+    }
+
+    void push_back(value_type &&value) {
+        this->emplace_back(std::move(value));
+    }
+
+    template <class... Args>
+    reference emplace_back(Args &&...args) {
+        if (this->back_free_capacity() == 0uz) {
+            this->make_room_back(1uz);
+        }
+
+        pointer p = this->data() + this->nStored;
+        this->alloc.construct(p, std::forward<Args>(args)...);
+        ++(this->nStored);
+
+        return *p;
+    }
+
+    void push_front(const_reference value) {
+        this->emplace_front(value);
+    }
+
+    void push_front(value_type &&value) {
+        this->emplace_front(std::move(value));
+    }
+
+    template <class... Args>
+    reference emplace_front(Args &&...args) {
+        if (this->first == 0uz) {
+            this->make_room_front(1uz);
+        }
+
+        pointer p = this->data() - 1;
+        this->alloc.construct(p, std::forward<Args>(args)...);
+        --(this->first);
+        ++(this->nStored);
+
+        return *p;
+    }
+
+    void pop_back() {
+        // DCHECK(!empty());
+        this->alloc.destroy(this->data() + this->nStored - 1uz);
+        --(this->nStored);
+    }
+
+    void pop_front() {
+        // DCHECK(!empty());
+        this->alloc.destroy(this->data());
+        ++(this->first);
+        --(this->nStored);
+    }
+
+    // Removes [pos, last) by shifting whichever side of the gap is shorter
+    iterator erase(const_iterator pos, const_iterator last) {
+        size_type lo = static_cast<size_type>(pos - this->cbegin());
+        size_type hi = static_cast<size_type>(last - this->cbegin());
+        size_type count = hi - lo;
+        if (count == 0uz) {
+            return this->begin() + lo;
+        }
+
+        pointer p = this->data();
+        if (lo < this->nStored - hi) {
+            // move the prefix right
+            for (size_type i = lo; i > 0uz; --i) {
+                p[i - 1uz + count] = std::move(p[i - 1uz]);
+            }
+            for (size_type i { 0uz }; i < count; ++i) {
+                this->alloc.destroy(p + i);
+            }
+            this->first += count;
+        } else {
+            for (size_type i = hi; i < this->nStored; ++i) {
+                p[i - count] = std::move(p[i]);
+            }
+            for (size_type i = this->nStored - count; i < this->nStored; ++i) {
+                this->alloc.destroy(p + i);
+            }
+        }
+        this->nStored -= count;
+
+        return this->begin() + lo;
+    }
+
+    iterator erase(const_iterator pos) {
+        return this->erase(pos, pos + 1);
+    }
+
+    void resize(size_type count) {
+        while (this->nStored > count) {
+            this->pop_back();
+        }
+        this->reserve_back(count);
+        while (this->nStored < count) {
+            this->emplace_back();
+        }
+    }
+
+    void resize(size_type count, const_reference value) {
+        while (this->nStored > count) {
+            this->pop_back();
+        }
+        this->reserve_back(count);
+        while (this->nStored < count) {
+            this->emplace_back(value);
+        }
+    }
+
+    void swap(devector &other) noexcept {
+        // each buffer goes with the allocator that has to free it; polymorphic
+        //   allocators are not assignable, so they are rebuilt in place
+        allocator_type tmp(this->alloc);
+        std::destroy_at(&this->alloc);
+        std::construct_at(&this->alloc, other.alloc);
+        std::destroy_at(&other.alloc);
+        std::construct_at(&other.alloc, tmp);
+
+        std::swap(this->buffer, other.buffer);
+        std::swap(this->nAlloc, other.nAlloc);
+        std::swap(this->first, other.first);
+        std::swap(this->nStored, other.nStored);
+    }
+
+private:
+    // Moves n elements from src to dst (both inside or across buffers, possibly
+    //   overlapping) and ends their lifetime at src
+    void relocate(pointer dst, pointer src, size_type n) {
+        if (dst == src || n == 0uz) { return ; }
+
+        if constexpr (std::is_trivially_copyable_v<value_type>) {
+            std::memmove(static_cast<void *>(dst), static_cast<const void *>(src), n * sizeof(value_type));
+        } else if (dst < src) {
+            // front to back: each destination slot is either outside the source
+            //   or held an element that was already moved out and destroyed
+            for (size_type i { 0uz }; i < n; ++i) {
+                this->alloc.construct(dst + i, std::move(src[i]));
+                this->alloc.destroy(src + i);
+            }
+        } else {
+            for (size_type i = n; i > 0uz; --i) {
+                this->alloc.construct(dst + i - 1uz, std::move(src[i - 1uz]));
+                this->alloc.destroy(src + i - 1uz);
+            }
+        }
+    }
+
+    // Rebuilds the layout so that at least `needFront` slots are free before the
+    //   elements and `needBack` after them, splitting the rest evenly
+    void reorganize(size_type needFront, size_type needBack) {
+        size_type required = this->nStored + needFront + needBack;
+        if (required <= this->nAlloc && this->nStored <= this->nAlloc / 2uz) {
+            // recenter in place
+            size_type spare = this->nAlloc - required;
+            size_type newFirst = needFront + spare / 2uz;
+            this->relocate(this->buffer + newFirst, this->data(), this->nStored);
+            this->first = newFirst;
+            return ;
+        }
+
+        size_type grown = this->nAlloc == 0uz ? 4uz : 2uz * this->nAlloc;
+        size_type cap = grown < required ? required : grown;
+        size_type newFirst = needFront + (cap - required) / 2uz;
+
+        pointer fresh = this->alloc.template allocate_object<value_type>(cap);
+        this->relocate(fresh + newFirst, this->data(), this->nStored);
+        if (this->buffer) {
+            this->alloc.template deallocate_object<value_type>(this->buffer, this->nAlloc);
+        }
+        this->buffer = fresh;
+        this->nAlloc = cap;
+        this->first = newFirst;
+    }
+
+    void make_room_front(size_type n) {
+        if (this->first < n) {
+            this->reorganize(n, 0uz);
+        }
+    }
+
+    void make_room_back(size_type n) {
+        if (this->back_free_capacity() < n) {
+            this->reorganize(0uz, n);
+        }
+    }
+};
+
+} // namespace zstl end
@@ -0,0 +1,117 @@
+#pragma once
+
+#include <array>
+#include <mutex>
+#include <atomic>
+#include <vector>
+#include <cstddef>
+#include <cstdint>
+#include <algorithm>
+
+
+// dispatch_profile
+// How often `tagged_ptr<Ts...>::call` ran for each tag. Compiling with
+//   ZSTL_TAGGED_PTR_PROFILE defined makes every call/call_likely record its tag;
+//   without it nothing is recorded and `call` costs nothing extra
+// Every thread counts into its own counters (a plain relaxed load + store, no
+//   read-modify-write on a shared line); counts() adds them up. ranking() lists
+//   the types hottest first, the order to give to call_likely:
+//   auto hot = zstl::dispatch_profile<Circle, Rectangle, Polygon>::ranking();
+//   // hot[0] == 2 (Rectangle): p.call_likely<Rectangle>(func)
+namespace zstl {
+
+template <typename... Ts>
+class dispatch_profile {
+public:
+    // indexed by tag, [0] counts calls on nullptr
+    static constexpr std::size_t N_TAGS = sizeof...(Ts) + 1uz;
+    using counts_type = std::array<std::uint64_t, N_TAGS>;
+
+private:
+    struct thread_counters;
+
+    struct registry_type {
+        std::mutex m;
+        std::vector<thread_counters *> threads;
+        // counts of threads that have exited
+        counts_type retired {};
+    };
+
+    static registry_type &registry() {
+        static registry_type r;
+        return r;
+    }
+
+    struct thread_counters {
+        std::array<std::atomic<std::uint64_t>, N_TAGS> counts {};
+
+        thread_counters() {
+            registry_type &r = registry();
+            std::lock_guard lock(r.m);
+            r.threads.push_back(this);
+        }
+
+        ~thread_counters() {
+            registry_type &r = registry();
+            std::lock_guard lock(r.m);
+            for (std::size_t t { 0uz }; t < N_TAGS; ++t) {
+                r.retired[t] += this->counts[t].load(std::memory_order_relaxed);
+            }
+            std::erase(r.threads, this);
+        }
+    };
+
+    static thread_counters &local() {
+        thread_local thread_counters c;
+        return c;
+    }
+
+public:
+    static void record(std::size_t tag) {
+        // DCHECK_LT(tag, N_TAGS);
+        std::atomic<std::uint64_t> &c = local().counts[tag];
+        c.store(c.load(std::memory_order_relaxed) + 1u, std::memory_order_relaxed);
+    }
+
+    // Totals over all threads, running and exited
+    static counts_type counts() {
+        registry_type &r = registry();
+        std::lock_guard lock(r.m);
+        counts_type total = r.retired;
+        for (const thread_counters *c : r.threads) {
+            for (std::size_t t { 0uz }; t < N_TAGS; ++t) {
+                total[t] += c->counts[t].load(std::memory_order_relaxed);
+            }
+        }
+        return total;
+    }
+
+    // Zeroes all counters; counts recorded concurrently with reset() may survive it
+    static void reset() {
+        registry_type &r = registry();
+        std::lock_guard lock(r.m);
+        r.retired = {};
+        for (thread_counters *c : r.threads) {
+            for (std::atomic<std::uint64_t> &x : c->counts) {
+                x.store(0u, std::memory_order_relaxed);
+            }
+        }
+    }
+
+    // The tags of Ts, most called first (ties in tag order)
+    static std::array<std::size_t, sizeof...(Ts)> ranking() {
+        counts_type total = counts();
+        std::array<std::size_t, sizeof...(Ts)> tags;
+        for (std::size_t i { 0uz }; i < tags.size(); ++i) {
+            tags[i] = i + 1uz;
+        }
+        std::stable_sort(
+            tags.begin(),
+            tags.end(),
+            [&total](std::size_t a, std::size_t b) { return total[a] > total[b]; }
+        );
+        return tags;
+    }
+};
+
+} // namespace zstl end
@@ -0,0 +1,527 @@
+#pragma once
+
+#include "memory_resource.hpp"
+
+#include <memory> // std::addressof
+#include <cstdint>
+#include <cstddef>
+#include <utility>
+#include <iterator>
+#include <type_traits>
+#include <initializer_list>
+
+
+// hive
+// An unordered container for collections with heavy insert/erase churn:
+//   elements live in blocks that never move, so pointers/references (and
+//   `tagged_ptr`s) stay valid until the element itself is erased
+// - erase is O(1): the slot is destroyed in place and joins a run of erased slots
+// - insert is O(1): it reuses the first slot of an erased run when any block has
+//   one, otherwise appends to the last block, otherwise allocates a new block
+//   (block capacities double from MIN_BLOCK up to MAX_BLOCK)
+// - iteration follows a skip field (the low-complexity jump-counting pattern):
+//   the first and the last slot of every erased run hold the run length, live
+//   slots hold 0, so ++/-- jump over a whole run in one step
+// A block whose last element is erased goes back to the memory_resource
+namespace zstl {
+
+template <typename _Tp, class Allocator = pmr::polymorphic_allocator<_Tp>>
+class hive {
+public:
+    using value_type = _Tp;
+    using allocator_type = Allocator;
+    using size_type = std::size_t;
+    using difference_type = std::ptrdiff_t;
+    using reference = _Tp &;
+    using const_reference = const _Tp &;
+    using pointer = _Tp *;
+    using const_pointer = const _Tp *;
+
+    static constexpr size_type MIN_BLOCK { 8uz };
+    static constexpr size_type MAX_BLOCK { 8192uz };
+
+private:
+    using skip_type = std::uint16_t;
+
+    // no run, the end of a free list
+    static constexpr skip_type NONE { 0xffffu };
+
+    // An erased slot that starts a run is a node of its block's free list of runs
+    union slot {
+        _Tp value;
+        struct {
+            skip_type prev;
+            skip_type next;
+        } run;
+
+        slot() noexcept {}
+        ~slot() {}
+    };
+
+    struct block {
+        slot *slots { nullptr };
+        // capacity + 1 entries; the last one stays 0 and stops the forward jumps
+        skip_type *skip { nullptr };
+        block *prev { nullptr };
+        block *next { nullptr };
+        // list of the blocks that have erased runs
+        block *prevErased { nullptr };
+        block *nextErased { nullptr };
+        size_type capacity { 0uz };
+        // slots [0, highWater) have been used at least once
+        size_type highWater { 0uz };
+        size_type nStored { 0uz };
+        skip_type freeRuns { NONE };
+    };
+
+    allocator_type alloc;
+    block *head { nullptr };
+    block *tail { nullptr };
+    block *erasedHead { nullptr };
+    size_type nStored { 0uz };
+    size_type nCapacity { 0uz };
+
+    template <bool IsConst>
+    class basic_iterator {
+    private:
+        block *blk { nullptr };
+        size_type index { 0uz };
+
+        friend class hive;
+
+        basic_iterator(block *blk, size_type index) noexcept
+            : blk(blk)
+            , index(index)
+        {}
+
+    public:
+        using iterator_category = std::bidirectional_iterator_tag;
+        using value_type = _Tp;
+        using difference_type = std::ptrdiff_t;
+        using pointer = std::conditional_t<IsConst, const _Tp *, _Tp *>;
+        using reference = std::conditional_t<IsConst, const _Tp &, _Tp &>;
+
+        basic_iterator() = default;
+
+        operator basic_iterator<true>() const
+            requires (!IsConst)
+        {
+            return basic_iterator<true>(this->blk, this->index);
+        }
+
+        reference operator*() const { return this->blk->slots[this->index].value; }
+        pointer operator->() const { return std::addressof(this->blk->slots[this->index].value); }
+
+        basic_iterator &operator++() {
+            ++this->index;
+            this->index += this->blk->skip[this->index];
+            if (this->index == this->blk->highWater && this->blk->next) {
+                this->blk = this->blk->next;
+                this->index = this->blk->skip[0uz];
+            }
+            return *this;
+        }
+
+        basic_iterator operator++(int) {
+            basic_iterator old = *this;
+            ++*this;
+            return old;
+        }
+
+        basic_iterator &operator--() {
+            if (this->index == 0uz) {
+                this->blk = this->blk->prev;
+                this->index = this->blk->highWater;
+            }
+            --this->index;
+            size_type run = this->blk->skip[this->index];
+            if (run > this->index) {
+                // the run reaches the front of the block; blocks are never empty,
+                //   so the previous block ends with a live slot or a shorter run
+                this->blk = this->blk->prev;
+                this->index = this->blk->highWater - 1uz;
+                run = this->blk->skip[this->index];
+            }
+            this->index -= run;
+            return *this;
+        }
+
+        basic_iterator operator--(int) {
+            basic_iterator old = *this;
+            --*this;
+            return old;
+        }
+
+        friend bool operator==(const basic_iterator &a, const basic_iterator &b) {
+            return a.blk == b.blk && a.index == b.index;
+        }
+    };
+
+public:
+    using iterator = basic_iterator<false>;
+    using const_iterator = basic_iterator<true>;
+
+    // Constructor
+    hive() noexcept(noexcept(allocator_type())) = default;
+
+    explicit hive(const allocator_type &alloc) noexcept
+        : alloc(alloc)
+    {}
+
+    hive(
+        std::initializer_list<value_type> init,
+        const allocator_type &alloc = allocator_type()
+    )
+        : alloc(alloc)
+    {
+        for (const value_type &value : init) {
+            this->insert(value);
+        }
+    }
+
+    hive(const hive &other)
+        : alloc(other.alloc)
+    {
+        for (const value_type &value : other) {
+            this->insert(value);
+        }
+    }
+
+    hive(hive &&other) noexcept
+        : alloc(other.alloc)
+        , head(other.head)
+        , tail(other.tail)
+        , erasedHead(other.erasedHead)
+        , nStored(other.nStored)
+        , nCapacity(other.nCapacity)
+    {
+        other.head = nullptr;
+        other.tail = nullptr;
+        other.erasedHead = nullptr;
+        other.nStored = 0uz;
+        other.nCapacity = 0uz;
+    }
+
+    hive &operator=(const hive &) = delete;
+    hive &operator=(hive &&) = delete;
+
+    // Destructor
+    ~hive() {
+        this->clear();
+    }
+
+    allocator_type get_allocator() const noexcept {
+        return this->alloc;
+    }
+
+    // Iterators
+    iterator begin() noexcept { return this->make_begin<false>(); }
+    const_iterator begin() const noexcept { return this->make_begin<true>(); }
+    const_iterator cbegin() const noexcept { return this->make_begin<true>(); }
+    iterator end() noexcept { return this->make_end<false>(); }
+    const_iterator end() const noexcept { return this->make_end<true>(); }
+    const_iterator cend() const noexcept { return this->make_end<true>(); }
+
+    // Capacity
+    bool empty() const noexcept {
+        return this->nStored == 0uz;
+    }
+
+    size_type size() const noexcept {
+        return this->nStored;
+    }
+
+    size_type capacity() const noexcept {
+        return this->nCapacity;
+    }
+
+    size_type block_count() const noexcept {
+        size_type n { 0uz };
+        for (block *b = this->head; b; b = b->next) {
+            ++n;
+        }
+        return n;
+    }
+
+    // Modifiers
+    iterator insert(const_reference value) {
+        return this->emplace(value);
+    }
+
+    iterator insert(value_type &&value) {
+        return this->emplace(std::move(value));
+    }
+
+    template <class... Args>
+    iterator emplace(Args &&...args) {
+        if (block *b = this->erasedHead) {
+            // take the first slot of the block's first erased run
+            size_type s = b->freeRuns;
+            size_type len = b->skip[s];
+            skip_type next = b->slots[s].run.next;
+
+            this->alloc.construct(std::addressof(b->slots[s].value), std::forward<Args>(args)...);
+
+            b->skip[s] = 0u;
+            if (len == 1uz) {
+                b->freeRuns = next;
+                if (next != NONE) {
+                    b->slots[next].run.prev = NONE;
+                }
+            } else {
+                size_type first = s + 1uz;
+                b->skip[first] = static_cast<skip_type>(len - 1uz);
+                b->skip[s + len - 1uz] = static_cast<skip_type>(len - 1uz);
+                b->slots[first].run.prev = NONE;
+                b->slots[first].run.next = next;
+                if (next != NONE) {
+                    b->slots[next].run.prev = static_cast<skip_type>(first);
+                }
+                b->freeRuns = static_cast<skip_type>(first);
+            }
+            if (b->freeRuns == NONE) {
+                this->unlink_erased(b);
+            }
+
+            ++(b->nStored);
+            ++(this->nStored);
+            return iterator(b, s);
+        }
+
+        if (!this->tail || this->tail->highWater == this->tail->capacity) {
+            this->add_block();
+        }
+
+        block *b = this->tail;
+        size_type s = b->highWater;
+        this->alloc.construct(std::addressof(b->slots[s].value), std::forward<Args>(args)...);
+        ++(b->highWater);
+        ++(b->nStored);
+        ++(this->nStored);
+        return iterator(b, s);
+    }
+
+    // Destroys the element at `pos` and returns an iterator to the next one;
+    //   no other element moves
+    iterator erase(const_iterator pos) {
+        // DCHECK(pos != end());
+        block *b = pos.blk;
+        size_type i = pos.index;
+
+        iterator next(b, i);
+        ++next;
+
+        this->alloc.destroy(std::addressof(b->slots[i].value));
+        --(this->nStored);
+        if (--(b->nStored) == 0uz) {
+            this->release_block(b);
+            // `next` can only still point into the freed block if that was the end
+            return next.blk == b ? this->end() : next;
+        }
+
+        size_type left = i == 0uz ? 0uz : b->skip[i - 1uz];
+        size_type right = b->skip[i + 1uz];
+
+        if (left == 0uz && right == 0uz) {
+            // a new run of one slot
+            b->skip[i] = 1u;
+            bool wasClean = b->freeRuns == NONE;
+            b->slots[i].run.prev = NONE;
+            b->slots[i].run.next = b->freeRuns;
+            if (!wasClean) {
+                b->slots[b->freeRuns].run.prev = static_cast<skip_type>(i);
+            }
+            b->freeRuns = static_cast<skip_type>(i);
+            if (wasClean) {
+                this->link_erased(b);
+            }
+        } else if (right == 0uz) {
+            // extends the run on the left
+            size_type len = left + 1uz;
+            b->skip[i - left] = static_cast<skip_type>(len);
+            b->skip[i] = static_cast<skip_type>(len);
+        } else if (left == 0uz) {
+            // becomes the new first slot of the run on the right
+            size_type len = right + 1uz;
+            b->skip[i] = static_cast<skip_type>(len);
+            b->skip[i + len - 1uz] = static_cast<skip_type>(len);
+            this->move_run(b, i + 1uz, i);
+        } else {
+            // joins the runs on both sides
+            size_type len = left + 1uz + right;
+            this->unlink_run(b, i + 1uz);
+            b->skip[i - left] = static_cast<skip_type>(len);
+            b->skip[i + right] = static_cast<skip_type>(len);
+        }
+
+        return next;
+    }
+
+    // Erasing the last element of the last block moves end(), hence the second check
+    iterator erase(const_iterator first, const_iterator last) {
+        while (first != last && first != this->cend()) {
+            first = this->erase(first);
+        }
+        return iterator(first.blk, first.index);
+    }
+
+    // Destroys every element and returns all blocks to the memory_resource
+    void clear() noexcept {
+        while (this->head) {
+            block *b = this->head;
+            if constexpr (!std::is_trivially_destructible_v<value_type>) {
+                for (const_iterator it(b, b->skip[0uz]); it.blk == b && it.index != b->highWater; ++it) {
+                    this->alloc.destroy(std::addressof(b->slots[it.index].value));
+                }
+            }
+            this->head = b->next;
+            this->free_block(b);
+        }
+        this->tail = nullptr;
+        this->erasedHead = nullptr;
+        this->nStored = 0uz;
+        this->nCapacity = 0uz;
+    }
+
+    // Iterator to the element at `p`, which must be an element of this hive
+    iterator get_iterator(const_pointer p) noexcept {
+        const slot *s = reinterpret_cast<const slot *>(p);
+        for (block *b = this->head; b; b = b->next) {
+            if (s >= b->slots && s < b->slots + b->capacity) {
+                return iterator(b, static_cast<size_type>(s - b->slots));
+            }
+        }
+        return this->end();
+    }
+
+    const_iterator get_iterator(const_pointer p) const noexcept {
+        return const_cast<hive *>(this)->get_iterator(p);
+    }
+
+private:
+    template <bool IsConst>
+    basic_iterator<IsConst> make_begin() const noexcept {
+        if (!this->head) {
+            return basic_iterator<IsConst>();
+        }
+        return basic_iterator<IsConst>(this->head, this->head->skip[0uz]);
+    }
+
+    template <bool IsConst>
+    basic_iterator<IsConst> make_end() const noexcept {
+        if (!this->tail) {
+            return basic_iterator<IsConst>();
+        }
+        return basic_iterator<IsConst>(this->tail, this->tail->highWater);
+    }
+
+    void add_block() {
+        size_type cap = this->tail ? this->tail->capacity * 2uz : MIN_BLOCK;
+        if (cap > MAX_BLOCK) {
+            cap = MAX_BLOCK;
+        }
+
+        block *b = this->alloc.template new_object<block>();
+        try {
+            b->slots = this->alloc.template allocate_object<slot>(cap);
+            b->skip = this->alloc.template allocate_object<skip_type>(cap + 1uz);
+        } catch (...) {
+            if (b->slots) {
+                this->alloc.template deallocate_object<slot>(b->slots, cap);
+            }
+            this->alloc.delete_object(b);
+            throw;
+        }
+        for (size_type i { 0uz }; i <= cap; ++i) {
+            b->skip[i] = 0u;
+        }
+        b->capacity = cap;
+
+        b->prev = this->tail;
+        if (this->tail) {
+            this->tail->next = b;
+        } else {
+            this->head = b;
+        }
+        this->tail = b;
+        this->nCapacity += cap;
+    }
+
+    // Unlinks an empty block from every list and frees it
+    void release_block(block *b) noexcept {
+        if (b->freeRuns != NONE) {
+            this->unlink_erased(b);
+        }
+        if (b->prev) {
+            b->prev->next = b->next;
+        } else {
+            this->head = b->next;
+        }
+        if (b->next) {
+            b->next->prev = b->prev;
+        } else {
+            this->tail = b->prev;
+        }
+        this->nCapacity -= b->capacity;
+        this->free_block(b);
+    }
+
+    void free_block(block *b) noexcept {
+        this->alloc.template deallocate_object<skip_type>(b->skip, b->capacity + 1uz);
+        this->alloc.template deallocate_object<slot>(b->slots, b->capacity);
+        this->alloc.delete_object(b);
+    }
+
+    void link_erased(block *b) noexcept {
+        b->prevErased = nullptr;
+        b->nextErased = this->erasedHead;
+        if (this->erasedHead) {
+            this->erasedHead->prevErased = b;
+        }
+        this->erasedHead = b;
+    }
+
+    void unlink_erased(block *b) noexcept {
+        if (b->prevErased) {
+            b->prevErased->nextErased = b->nextErased;
+        } else {
+            this->erasedHead = b->nextErased;
+        }
+        if (b->nextErased) {
+            b->nextErased->prevErased = b->prevErased;
+        }
+        b->prevErased = nullptr;
+        b->nextErased = nullptr;
+    }
+
+    // The run starting at `from` now starts at `to`
+    static void move_run(block *b, size_type from, size_type to) noexcept {
+        skip_type prev = b->slots[from].run.prev;
+        skip_type next = b->slots[from].run.next;
+        b->slots[to].run.prev = prev;
+        b->slots[to].run.next = next;
+        if (prev != NONE) {
+            b->slots[prev].run.next = static_cast<skip_type>(to);
+        } else {
+            b->freeRuns = static_cast<skip_type>(to);
+        }
+        if (next != NONE) {
+            b->slots[next].run.prev = static_cast<skip_type>(to);
+        }
+    }
+
+    static void unlink_run(block *b, size_type s) noexcept {
+        skip_type prev = b->slots[s].run.prev;
+        skip_type next = b->slots[s].run.next;
+        if (prev != NONE) {
+            b->slots[prev].run.next = next;
+        } else {
+            b->freeRuns = next;
+        }
+        if (next != NONE) {
+            b->slots[next].run.prev = prev;
+        }
+    }
+};
+
+} // namespace zstl end
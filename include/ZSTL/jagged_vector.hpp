@@ -0,0 +1,243 @@
+#pragma once
+
+#include "memory_resource.hpp"
+#include "vector.hpp"
+
+#include <span>
+#include <cstddef>
+#include <utility>
+#include <stdexcept>
+#include <initializer_list>
+
+
+// jagged_vector
+// A vector of variable-length rows in CSR (compressed sparse row) layout:
+//   all rows live back to back in one value buffer and `offsets[r]` / `offsets[r + 1]`
+//   delimit row r, so there is one allocation for all rows instead of one per row
+//   and reading a row is a single indirection
+// Rows are appended at the end, either whole (push_back_row) or element by element
+//   through a `row_builder` when the length is not known up front
+namespace zstl {
+
+template <typename _Tp>
+class jagged_vector {
+public:
+    using value_type = _Tp;
+    using size_type = std::size_t;
+    using difference_type = std::ptrdiff_t;
+    using allocator_type = pmr::polymorphic_allocator<_Tp>;
+    using row_type = std::span<_Tp>;
+    using const_row_type = std::span<const _Tp>;
+
+private:
+    zstl::vector<_Tp> values;
+    zstl::vector<size_type> offsets;
+    // a row_builder is appending to the values past offsets.back()
+    bool building { false };
+
+public:
+    // row_builder
+    // Appends elements to a new last row; the row becomes visible when
+    //   the builder is finished (explicitly or on destruction)
+    // Only one builder may be open at a time: build_row, push_back_row and clear
+    //   throw std::logic_error while one is
+    // The builder points at its jagged_vector, so it is neither copyable nor
+    //   movable (build_row returns it by guaranteed elision), and the jagged_vector
+    //   must stay where it is until the builder is finished
+    class row_builder {
+    private:
+        jagged_vector *owner { nullptr };
+
+    public:
+        explicit row_builder(jagged_vector *owner)
+            : owner(owner)
+        {}
+
+        row_builder(const row_builder &) = delete;
+        row_builder &operator=(const row_builder &) = delete;
+
+        row_builder(row_builder &&) = delete;
+        row_builder &operator=(row_builder &&) = delete;
+
+        ~row_builder() {
+            this->finish();
+        }
+
+        void push_back(const _Tp &value) {
+            this->owner->values.push_back(value);
+        }
+
+        void push_back(_Tp &&value) {
+            this->owner->values.push_back(std::move(value));
+        }
+
+        template <class... Args>
+        _Tp &emplace_back(Args &&...args) {
+            return this->owner->values.emplace_back(std::forward<Args>(args)...);
+        }
+
+        // number of elements added to the row so far; 0 once finished
+        size_type size() const noexcept {
+            if (!this->owner) {
+                return 0uz;
+            }
+            return this->owner->values.size() - this->owner->offsets.back();
+        }
+
+        void finish() {
+            if (this->owner) {
+                this->owner->offsets.push_back(this->owner->values.size());
+                this->owner->building = false;
+                this->owner = nullptr;
+            }
+        }
+    };
+
+    // Constructor
+    jagged_vector()
+        : jagged_vector(allocator_type())
+    {}
+
+    explicit jagged_vector(const allocator_type &alloc)
+        : values(alloc)
+        , offsets(pmr::polymorphic_allocator<size_type>(alloc.resource()))
+    {
+        this->offsets.push_back(0uz);
+    }
+
+    jagged_vector(
+        std::initializer_list<std::initializer_list<value_type>> rows,
+        const allocator_type &alloc = allocator_type()
+    )
+        : jagged_vector(alloc)
+    {
+        this->offsets.reserve(rows.size() + 1uz);
+        for (const auto &row : rows) {
+            this->push_back_row(row.begin(), row.end());
+        }
+    }
+
+    // Element access
+    row_type operator[](size_type row) noexcept {
+        return { this->values.data() + this->offsets[row], this->row_size(row) };
+    }
+
+    const_row_type operator[](size_type row) const noexcept {
+        return { this->values.data() + this->offsets[row], this->row_size(row) };
+    }
+
+    row_type at(size_type row) {
+        if (row >= this->size()) [[unlikely]] {
+            throw std::out_of_range("jagged_vector::at");
+        }
+
+        return (*this)[row];
+    }
+
+    const_row_type at(size_type row) const {
+        if (row >= this->size()) [[unlikely]] {
+            throw std::out_of_range("jagged_vector::at");
+        }
+
+        return (*this)[row];
+    }
+
+    row_type back() noexcept {
+        return (*this)[this->size() - 1uz];
+    }
+
+    const_row_type back() const noexcept {
+        return (*this)[this->size() - 1uz];
+    }
+
+    size_type row_size(size_type row) const noexcept {
+        return this->offsets[row + 1uz] - this->offsets[row];
+    }
+
+    // The flattened storage: every row back to back, and the row boundaries
+    std::span<value_type> flat() noexcept {
+        return { this->values.data(), this->offsets.back() };
+    }
+
+    std::span<const value_type> flat() const noexcept {
+        return { this->values.data(), this->offsets.back() };
+    }
+
+    std::span<const size_type> row_offsets() const noexcept {
+        return { this->offsets.data(), this->offsets.size() };
+    }
+
+    // Capacity
+    bool empty() const noexcept {
+        return this->size() == 0uz;
+    }
+
+    // number of rows
+    size_type size() const noexcept {
+        return this->offsets.size() - 1uz;
+    }
+
+    // number of elements over all rows
+    size_type total_size() const noexcept {
+        return this->offsets.back();
+    }
+
+    void reserve(size_type rows, size_type elements) {
+        this->offsets.reserve(rows + 1uz);
+        this->values.reserve(elements);
+    }
+
+    // Modifiers
+    void clear() {
+        if (this->building) [[unlikely]] {
+            throw std::logic_error("jagged_vector::clear: a row_builder is open");
+        }
+
+        this->values.clear();
+        this->offsets.clear();
+        this->offsets.push_back(0uz);
+    }
+
+    template <class InputIt>
+    row_type push_back_row(InputIt first, InputIt last) {
+        if (this->building) [[unlikely]] {
+            throw std::logic_error("jagged_vector::push_back_row: a row_builder is open");
+        }
+
+        for (InputIt iter = first; iter != last; ++iter) {
+            this->values.push_back(*iter);
+        }
+        this->offsets.push_back(this->values.size());
+
+        return this->back();
+    }
+
+    row_type push_back_row(std::span<const value_type> row) {
+        return this->push_back_row(row.begin(), row.end());
+    }
+
+    row_type push_back_row(std::initializer_list<value_type> row) {
+        return this->push_back_row(row.begin(), row.end());
+    }
+
+    // Starts a new last row of not yet known length
+    row_builder build_row() {
+        if (this->building) [[unlikely]] {
+            throw std::logic_error("jagged_vector::build_row: a row_builder is open");
+        }
+
+        this->building = true;
+        return row_builder(this);
+    }
+
+    void pop_back_row() {
+        // DCHECK(!empty());
+        // DCHECK(!building);
+        this->offsets.pop_back();
+        while (this->values.size() > this->offsets.back()) {
+            this->values.pop_back();
+        }
+    }
+};
+
+} // namespace zstl end
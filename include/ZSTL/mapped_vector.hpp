@@ -0,0 +1,315 @@
+#pragma once
+
+#include <span>
+#include <cerrno>
+#include <cstdint>
+#include <cstddef>
+#include <cstring>
+#include <utility>
+#include <iterator>
+#include <stdexcept>
+#include <system_error>
+#include <type_traits>
+
+#include <fcntl.h> // open
+#include <unistd.h> // close, write
+#include <sys/mman.h> // mmap, munmap, madvise
+#include <sys/stat.h> // fstat
+
+
+// mapped_vector
+// A read-only vector view over a file of trivially-copyable `T` that is mmap()ed
+//   instead of read and copied, so opening a multi-GiB dataset costs a few syscalls
+//   and pages are faulted in on first touch
+// The file starts with a `mapped_header` that records the element size, count and
+//   alignment it was written with; opening validates it against `T`
+// Files are produced by `write_mapped_file()`
+namespace zstl {
+
+// file layout: [mapped_header][padding up to data_offset][count * element_size bytes]
+struct mapped_header {
+    static constexpr char MAGIC[8] { 'Z', 'S', 'T', 'L', 'V', 'E', 'C', '\0' };
+    static constexpr std::uint32_t VERSION { 1u };
+
+    char magic[8] {};
+    std::uint32_t version { 0u };
+    std::uint32_t element_size { 0u };
+    std::uint64_t element_alignment { 0u };
+    std::uint64_t count { 0u };
+    std::uint64_t data_offset { 0u };
+};
+
+// access hints forwarded to madvise()
+enum class access_hint {
+    normal,
+    sequential,
+    random,
+    willneed
+};
+
+template <typename T>
+using mapped_span = std::span<const T>;
+
+
+namespace detail::mapped_vector {
+
+// the data section starts on a page-cache friendly boundary that also satisfies `T`
+template <typename T>
+constexpr std::uint64_t data_offset() {
+    constexpr std::uint64_t align = alignof(T) > 64uz ? alignof(T) : 64uz;
+    return (sizeof(mapped_header) + align - 1u) / align * align;
+}
+
+inline void write_all(int fd, const void *buf, std::size_t n) {
+    const char *p = static_cast<const char *>(buf);
+    while (n != 0uz) {
+        ssize_t written = ::write(fd, p, n);
+        if (written < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            throw std::system_error(errno, std::generic_category(), "write_mapped_file: write");
+        }
+        p += written;
+        n -= static_cast<std::size_t>(written);
+    }
+}
+
+} // namespace detail::mapped_vector end
+
+
+// Writes `data` with a `mapped_header` so that `mapped_vector<T>` can map it back
+template <typename T>
+    requires std::is_trivially_copyable_v<T>
+void write_mapped_file(const char *path, std::span<const T> data) {
+    int fd = ::open(path, O_WRONLY | O_CREAT | O_TRUNC, 0644);
+    if (fd < 0) {
+        throw std::system_error(errno, std::generic_category(), "write_mapped_file: open");
+    }
+
+    mapped_header header;
+    std::memcpy(header.magic, mapped_header::MAGIC, sizeof(header.magic));
+    header.version = mapped_header::VERSION;
+    header.element_size = sizeof(T);
+    header.element_alignment = alignof(T);
+    header.count = data.size();
+    header.data_offset = detail::mapped_vector::data_offset<T>();
+
+    try {
+        char padding[detail::mapped_vector::data_offset<T>()] {};
+        std::memcpy(padding, &header, sizeof(header));
+        detail::mapped_vector::write_all(fd, padding, sizeof(padding));
+        detail::mapped_vector::write_all(fd, data.data(), data.size_bytes());
+    } catch (...) {
+        ::close(fd);
+        throw;
+    }
+
+    // on NFS and friends a failed write may only be reported here
+    if (::close(fd) != 0) {
+        throw std::system_error(errno, std::generic_category(), "write_mapped_file: close");
+    }
+}
+
+
+template <typename _Tp>
+    requires std::is_trivially_copyable_v<_Tp>
+class mapped_vector {
+public:
+    using value_type = _Tp;
+    using size_type = std::size_t;
+    using difference_type = std::ptrdiff_t;
+    using reference = const _Tp &;
+    using const_reference = const _Tp &;
+    using pointer = const _Tp *;
+    using const_pointer = const _Tp *;
+    using iterator = const _Tp *;
+    using const_iterator = const _Tp *;
+    using reverse_iterator = std::reverse_iterator<const_iterator>;
+    using const_reverse_iterator = std::reverse_iterator<const_iterator>;
+
+private:
+    void *mapping { nullptr };
+    size_type mappingBytes { 0uz };
+    const_pointer ptr { nullptr };
+    size_type nStored { 0uz };
+
+public:
+    // Constructor
+    mapped_vector() noexcept = default;
+
+    explicit mapped_vector(const char *path, access_hint hint = access_hint::normal) {
+        int fd = ::open(path, O_RDONLY);
+        if (fd < 0) {
+            throw std::system_error(errno, std::generic_category(), "mapped_vector: open");
+        }
+
+        struct stat st;
+        if (::fstat(fd, &st) != 0) {
+            int err = errno;
+            ::close(fd);
+            throw std::system_error(err, std::generic_category(), "mapped_vector: fstat");
+        }
+
+        this->mappingBytes = static_cast<size_type>(st.st_size);
+        if (this->mappingBytes < sizeof(mapped_header)) {
+            ::close(fd);
+            throw std::runtime_error("mapped_vector: file too small for header");
+        }
+
+        this->mapping = ::mmap(nullptr, this->mappingBytes, PROT_READ, MAP_PRIVATE, fd, 0);
+        int err = errno;
+        // the mapping keeps its own reference to the file
+        ::close(fd);
+        if (this->mapping == MAP_FAILED) {
+            this->mapping = nullptr;
+            throw std::system_error(err, std::generic_category(), "mapped_vector: mmap");
+        }
+
+        try {
+            this->validate_header();
+        } catch (...) {
+            this->unmap();
+            throw;
+        }
+
+        this->advise(hint);
+    }
+
+    mapped_vector(const mapped_vector &) = delete;
+    mapped_vector &operator=(const mapped_vector &) = delete;
+
+    mapped_vector(mapped_vector &&other) noexcept
+        : mapping(std::exchange(other.mapping, nullptr))
+        , mappingBytes(std::exchange(other.mappingBytes, 0uz))
+        , ptr(std::exchange(other.ptr, nullptr))
+        , nStored(std::exchange(other.nStored, 0uz))
+    {}
+
+    mapped_vector &operator=(mapped_vector &&other) noexcept {
+        if (this != &other) {
+            this->unmap();
+            this->mapping = std::exchange(other.mapping, nullptr);
+            this->mappingBytes = std::exchange(other.mappingBytes, 0uz);
+            this->ptr = std::exchange(other.ptr, nullptr);
+            this->nStored = std::exchange(other.nStored, 0uz);
+        }
+
+        return *this;
+    }
+
+    // Destructor
+    ~mapped_vector() {
+        this->unmap();
+    }
+
+    // Applies an access hint to the whole mapping
+    void advise(access_hint hint) const noexcept {
+        if (!this->mapping) { return ; }
+
+        int advice = MADV_NORMAL;
+        switch (hint) {
+            case access_hint::normal: advice = MADV_NORMAL; break;
+            case access_hint::sequential: advice = MADV_SEQUENTIAL; break;
+            case access_hint::random: advice = MADV_RANDOM; break;
+            case access_hint::willneed: advice = MADV_WILLNEED; break;
+        }
+        // a hint: failure is harmless
+        ::madvise(this->mapping, this->mappingBytes, advice);
+    }
+
+    // Element access
+    const_reference at(size_type index) const {
+        if (index >= this->nStored) [[unlikely]] {
+            throw std::out_of_range("mapped_vector::at");
+        }
+
+        return this->ptr[index];
+    }
+
+    const_reference operator[](size_type index) const noexcept {
+        return this->ptr[index];
+    }
+
+    const_reference front() const noexcept {
+        return this->ptr[0uz];
+    }
+
+    const_reference back() const noexcept {
+        return this->ptr[this->nStored - 1uz];
+    }
+
+    const_pointer data() const noexcept {
+        return this->ptr;
+    }
+
+    mapped_span<value_type> span() const noexcept {
+        return { this->ptr, this->nStored };
+    }
+
+    operator mapped_span<value_type>() const noexcept {
+        return this->span();
+    }
+
+    // Iterators
+    const_iterator begin() const noexcept { return this->ptr; }
+    const_iterator cbegin() const noexcept { return this->ptr; }
+    const_iterator end() const noexcept { return this->ptr + this->nStored; }
+    const_iterator cend() const noexcept { return this->ptr + this->nStored; }
+    const_reverse_iterator rbegin() const noexcept { return const_reverse_iterator(this->end()); }
+    const_reverse_iterator crbegin() const noexcept { return const_reverse_iterator(this->end()); }
+    const_reverse_iterator rend() const noexcept { return const_reverse_iterator(this->begin()); }
+    const_reverse_iterator crend() const noexcept { return const_reverse_iterator(this->begin()); }
+
+    // Capacity
+    bool empty() const noexcept {
+        return this->nStored == 0uz;
+    }
+
+    size_type size() const noexcept {
+        return this->nStored;
+    }
+
+private:
+    void validate_header() {
+        mapped_header header;
+        std::memcpy(&header, this->mapping, sizeof(header));
+
+        if (std::memcmp(header.magic, mapped_header::MAGIC, sizeof(header.magic)) != 0) {
+            throw std::runtime_error("mapped_vector: bad magic");
+        }
+        if (header.version != mapped_header::VERSION) {
+            throw std::runtime_error("mapped_vector: unsupported version");
+        }
+        if (header.element_size != sizeof(_Tp)) {
+            throw std::runtime_error("mapped_vector: element size mismatch");
+        }
+        if (header.data_offset < sizeof(mapped_header)) {
+            throw std::runtime_error("mapped_vector: data overlaps the header");
+        }
+        if (header.element_alignment != alignof(_Tp) || header.data_offset % alignof(_Tp) != 0u) {
+            throw std::runtime_error("mapped_vector: element alignment mismatch");
+        }
+        if (header.data_offset > this->mappingBytes
+            || header.count > (this->mappingBytes - header.data_offset) / sizeof(_Tp)) {
+            throw std::runtime_error("mapped_vector: file truncated");
+        }
+
+        this->ptr = reinterpret_cast<const_pointer>(
+            static_cast<const char *>(this->mapping) + header.data_offset
+        );
+        this->nStored = static_cast<size_type>(header.count);
+    }
+
+    void unmap() noexcept {
+        if (this->mapping) {
+            ::munmap(this->mapping, this->mappingBytes);
+        }
+        this->mapping = nullptr;
+        this->mappingBytes = 0uz;
+        this->ptr = nullptr;
+        this->nStored = 0uz;
+    }
+};
+
+} // namespace zstl end
@@ -1,6 +1,10 @@
 #pragma once
 
 #include <new>
+#include <limits>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
 #include <thread>
 #include <malloc.h> // memalign, _aligned_malloc
 
@@ -18,7 +22,7 @@ public:
 
     memory_resource(const memory_resource& ) = default;
 
-    virtual ~memory_resource();
+    virtual ~memory_resource() = default;
 
     // to do: Exceptions
     // Throws an exception if storage of the requested size and alignment cannot be obtained
@@ -107,18 +111,43 @@ inline memory_resource *new_delete_resource() noexcept {
     return ndr;
 }
 
-// TODO
+// NullMemoryResource
+class NullMemoryResource : public memory_resource {
+    void *do_allocate(std::size_t, std::size_t) override {
+        throw std::bad_alloc();
+    }
+
+    void do_deallocate(void *, std::size_t, std::size_t) override {}
+
+    bool do_is_equal(const memory_resource &other) const noexcept override {
+        return this == &other;
+    }
+};
+
 // ref: https://en.cppreference.com/w/cpp/memory/null_memory_resource
-memory_resource* null_memory_resource() noexcept;
+inline memory_resource *null_memory_resource() noexcept {
+    static NullMemoryResource nmr;
+    return &nmr;
+}
+
+namespace detail {
+
+// nullptr means new_delete_resource()
+inline std::atomic<memory_resource *> defaultResource { nullptr };
+
+} // namespace detail end
 
-// TODO
 // ref: https://en.cppreference.com/w/cpp/memory/set_default_resource
-memory_resource* set_default_resource(memory_resource *r) noexcept;
+inline memory_resource *set_default_resource(memory_resource *r) noexcept {
+    memory_resource *old = detail::defaultResource.exchange(r, std::memory_order_acq_rel);
+    return old ? old : new_delete_resource();
+}
 
-// TODO
 // ref: https://en.cppreference.com/w/cpp/memory/get_default_resource
-memory_resource* get_default_resource() noexcept;
-
+inline memory_resource *get_default_resource() noexcept {
+    memory_resource *r = detail::defaultResource.load(std::memory_order_acquire);
+    return r ? r : new_delete_resource();
+}
 
 
 
@@ -173,7 +202,6 @@ public:
 #endif
     }
 
-    // TODO
     monotonic_buffer_resource(void *buffer, std::size_t buffer_size)
         : monotonic_buffer_resource(
             buffer,
@@ -182,12 +210,22 @@ public:
         )
     {}
 
-    // TODO
+    // Allocations are served from `buffer` first; once it is used up, blocks of
+    //   at least buffer_size bytes come from `upstream`
     monotonic_buffer_resource(
         void *buffer,
         std::size_t buffer_size,
         memory_resource *upstream
-    );
+    )
+        : upstream(upstream)
+        , block_size(buffer_size > 256 * 1024uz ? buffer_size : 256 * 1024uz)
+        , current(&this->initial)
+        , initial { buffer, buffer_size, nullptr }
+    {
+#ifndef NDEBUG
+        this->constructTID = std::this_thread::get_id();
+#endif
+    }
 
     monotonic_buffer_resource(const monotonic_buffer_resource& ) = delete;
 
@@ -205,7 +243,9 @@ public:
             b = next;
         }
         this->block_list = nullptr;
-        this->current = nullptr;
+        // back to the initial buffer, if there is one
+        this->current = this->initial.ptr ? &this->initial : nullptr;
+        this->current_pos = 0uz;
     }
 
     memory_resource *upstream_resource() const {
@@ -262,8 +302,36 @@ private:
     block *current { nullptr };
     std::size_t current_pos { 0uz };
     block *block_list { nullptr };
+    // the buffer passed to the constructor; not in block_list, never freed
+    block initial {};
 };
 
+inline void *monotonic_buffer_resource::do_allocate(std::size_t bytes, std::size_t align) {
+    // DCHECK_EQ(std::this_thread::get_id(), this->constructTID);
+    if (bytes > this->block_size) {
+        // We've got a big allocation; let the current block be so that
+        // smaller allocations have a chance at using up more of it.
+        return this->upstream->allocate(bytes, align);
+    }
+
+    // align the address rather than the offset: block memory starts right
+    // after the block header
+    auto padding = [this, align]() {
+        std::uintptr_t address = reinterpret_cast<std::uintptr_t>(this->current->ptr) + this->current_pos;
+        return (align - address % align) % align;
+    };
+
+    if (!this->current || this->current_pos + padding() + bytes > this->current->size) {
+        this->current = this->allocate_block(this->block_size + align);
+        this->current_pos = 0uz;
+    }
+    this->current_pos += padding();
+
+    void *ptr = static_cast<char *>(this->current->ptr) + this->current_pos;
+    this->current_pos += bytes;
+    return ptr;
+}
+
 
 
 
@@ -0,0 +1,385 @@
+#pragma once
+
+#include "memory_resource.hpp"
+#include "vector.hpp"
+#include "simd.hpp" // zstl::simd::level, zstl::simd::detail::vec_t
+
+#include <bit> // std::bit_width
+#include <span>
+#include <array>
+#include <cstdint>
+#include <cstddef>
+#include <cstring>
+#include <stdexcept>
+
+
+// Compressed vector of 64-bit unsigned integers (sorted ID columns, timestamps, ...)
+// Values are packed in blocks of 512; every block picks the narrower of
+// - frame of reference: value - min(block), direct O(1) access to any value
+// - delta: value - previous value (non-decreasing blocks only), a prefix sum
+//   over the block on access
+// and stores them with a fixed bit width in a vertical layout: the block is 8
+//   interleaved streams (value v goes to stream v % 8), so word t of all streams
+//   is contiguous and one register unpacks the same bit position of 2, 4 or 8 streams
+//   with a single shift, on SSE2, AVX2 or AVX-512 alike
+// Appended values stay uncompressed in a tail until a block is full
+namespace zstl {
+
+namespace detail::packed_int_vector {
+
+using word_type = std::uint64_t;
+
+inline constexpr std::size_t BLOCK_SIZE { 512uz };
+inline constexpr std::size_t STREAMS { 8uz };
+inline constexpr std::size_t STREAM_LENGTH { BLOCK_SIZE / STREAMS };
+
+struct block_header {
+    std::uint64_t base;     // min (frame of reference) or first value (delta)
+    std::uint64_t offset;   // first word of the block; the block has STREAMS * width words
+    std::uint8_t width;     // bits per value, 0 to 64
+    bool delta;
+};
+
+constexpr word_type low_mask(std::size_t width) noexcept {
+    return width == 64uz ? ~word_type { 0u } : (word_type { 1u } << width) - 1u;
+}
+
+// the packed value at position `i` of stream `k`
+inline word_type extract(const word_type *words, std::size_t width, std::size_t k, std::size_t i) noexcept {
+    std::size_t pos = i * width;
+    std::size_t t = pos / 64uz;
+    std::size_t shift = pos % 64uz;
+    word_type x = words[t * STREAMS + k] >> shift;
+    if (shift + width > 64uz) {
+        x |= words[(t + 1uz) * STREAMS + k] << (64uz - shift);
+    }
+    return x & low_mask(width);
+}
+
+// packs `values` (BLOCK_SIZE of them, already reduced to `width` bits) into
+//   STREAMS * width zeroed words
+inline void pack(const word_type *values, std::size_t width, word_type *words) noexcept {
+    if (width == 0uz) { return ; }
+    for (std::size_t v { 0uz }; v < BLOCK_SIZE; ++v) {
+        std::size_t k = v % STREAMS;
+        std::size_t pos = (v / STREAMS) * width;
+        std::size_t t = pos / 64uz;
+        std::size_t shift = pos % 64uz;
+        words[t * STREAMS + k] |= values[v] << shift;
+        if (shift + width > 64uz) {
+            words[(t + 1uz) * STREAMS + k] |= values[v] >> (64uz - shift);
+        }
+    }
+}
+
+inline void unpack_scalar(const word_type *words, std::size_t width, word_type *out) noexcept {
+    for (std::size_t v { 0uz }; v < BLOCK_SIZE; ++v) {
+        out[v] = width == 0uz ? 0u : extract(words, width, v % STREAMS, v / STREAMS);
+    }
+}
+
+
+#ifdef ZSTL_SIMD_X86
+
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wpsabi"
+
+// unpacks one block in value order; every register holds L adjacent streams, which
+//   share the same word index and shift at every position
+template <std::size_t Bytes>
+[[gnu::always_inline]] inline void unpack_kernel(const word_type *words, std::size_t width, word_type *out) noexcept {
+    using V = zstl::simd::detail::vec_t<word_type, Bytes>;
+    constexpr std::size_t L = Bytes / sizeof(word_type);
+
+    if (width == 0uz) {
+        std::memset(out, 0, BLOCK_SIZE * sizeof(word_type));
+        return ;
+    }
+    const word_type mask = low_mask(width);
+    for (std::size_t group { 0uz }; group < STREAMS; group += L) {
+        for (std::size_t i { 0uz }; i < STREAM_LENGTH; ++i) {
+            std::size_t pos = i * width;
+            std::size_t t = pos / 64uz;
+            std::size_t shift = pos % 64uz;
+            V x = zstl::simd::detail::load<V>(words + t * STREAMS + group) >> shift;
+            if (shift + width > 64uz) {
+                x |= zstl::simd::detail::load<V>(words + (t + 1uz) * STREAMS + group) << (64uz - shift);
+            }
+            x &= mask;
+            std::memcpy(out + i * STREAMS + group, &x, Bytes);
+        }
+    }
+}
+
+[[gnu::target("sse2")]]
+inline void unpack_sse2(const word_type *words, std::size_t width, word_type *out) noexcept {
+    unpack_kernel<16uz>(words, width, out);
+}
+
+[[gnu::target("avx2")]]
+inline void unpack_avx2(const word_type *words, std::size_t width, word_type *out) noexcept {
+    unpack_kernel<32uz>(words, width, out);
+}
+
+[[gnu::target("avx512f,avx512bw,avx512dq,avx512vl")]]
+inline void unpack_avx512(const word_type *words, std::size_t width, word_type *out) noexcept {
+    unpack_kernel<64uz>(words, width, out);
+}
+
+#pragma GCC diagnostic pop
+
+#endif // ZSTL_SIMD_X86
+
+
+using unpack_fn = void (*)(const word_type *, std::size_t, word_type *);
+
+inline unpack_fn unpacker(zstl::simd::level l) noexcept {
+    if (l > zstl::simd::detected_level()) {
+        l = zstl::simd::detected_level();
+    }
+#ifdef ZSTL_SIMD_X86
+    switch (l) {
+        case zstl::simd::level::avx512: return unpack_avx512;
+        case zstl::simd::level::avx2: return unpack_avx2;
+        case zstl::simd::level::sse2: return unpack_sse2;
+        case zstl::simd::level::scalar: break;
+    }
+#endif
+    return unpack_scalar;
+}
+
+// decodes a whole block into `out` (BLOCK_SIZE values)
+inline void decode(const block_header &h, const word_type *words, word_type *out, unpack_fn unpack) noexcept {
+    unpack(words + h.offset, h.width, out);
+    if (h.delta) {
+        word_type running = h.base;
+        for (std::size_t v { 0uz }; v < BLOCK_SIZE; ++v) {
+            running += out[v];
+            out[v] = running;
+        }
+    } else {
+        for (std::size_t v { 0uz }; v < BLOCK_SIZE; ++v) {
+            out[v] += h.base;
+        }
+    }
+}
+
+} // namespace detail::packed_int_vector end
+
+
+class packed_int_vector {
+public:
+    using value_type = std::uint64_t;
+    using size_type = std::size_t;
+    using allocator_type = pmr::polymorphic_allocator<value_type>;
+
+    static constexpr size_type BLOCK_SIZE = detail::packed_int_vector::BLOCK_SIZE;
+
+private:
+    using block_header = detail::packed_int_vector::block_header;
+    using word_type = detail::packed_int_vector::word_type;
+
+    zstl::vector<word_type> words;
+    zstl::vector<block_header> headers;
+    zstl::vector<value_type> tail;    // fewer than BLOCK_SIZE values not packed yet
+
+public:
+    packed_int_vector() = default;
+
+    explicit packed_int_vector(const allocator_type &alloc)
+        : words(alloc)
+        , headers(pmr::polymorphic_allocator<block_header>(alloc.resource()))
+        , tail(alloc)
+    {}
+
+    packed_int_vector(const packed_int_vector &other) = default;
+    packed_int_vector(packed_int_vector &&other) noexcept = default;
+    packed_int_vector &operator=(const packed_int_vector &other) = default;
+    packed_int_vector &operator=(packed_int_vector &&other) noexcept = default;
+
+    allocator_type get_allocator() const noexcept {
+        return this->words.get_allocator();
+    }
+
+    // Element access: O(1) in frame-of-reference blocks and the tail,
+    //   a prefix over the block in delta blocks
+    value_type operator[](size_type pos) const noexcept {
+        namespace impl = detail::packed_int_vector;
+        // DCHECK_LT(pos, size());
+        size_type block = pos / BLOCK_SIZE;
+        if (block >= this->headers.size()) {
+            return this->tail[pos - this->headers.size() * BLOCK_SIZE];
+        }
+
+        const block_header &h = this->headers[block];
+        const word_type *w = this->words.data() + h.offset;
+        size_type v = pos % BLOCK_SIZE;
+        if (!h.delta) {
+            return h.base + (h.width == 0u ? 0u : impl::extract(w, h.width, v % impl::STREAMS, v / impl::STREAMS));
+        }
+
+        // unpacking the whole block with SIMD beats extracting the deltas one by one
+        alignas(64) std::array<word_type, impl::BLOCK_SIZE> deltas;
+        impl::unpacker(zstl::simd::detected_level())(w, h.width, deltas.data());
+        value_type x = h.base;
+        for (size_type u { 1uz }; u <= v; ++u) {
+            x += deltas[u];
+        }
+        return x;
+    }
+
+    value_type at(size_type pos) const {
+        if (pos >= this->size()) [[unlikely]] {
+            throw std::out_of_range("packed_int_vector::at");
+        }
+        return (*this)[pos];
+    }
+
+    // Capacity
+    size_type size() const noexcept {
+        return this->headers.size() * BLOCK_SIZE + this->tail.size();
+    }
+
+    bool empty() const noexcept {
+        return this->size() == 0uz;
+    }
+
+    size_type block_count() const noexcept {
+        return this->headers.size();
+    }
+
+    // bytes held by the packed words, block headers and the tail
+    size_type memory_bytes() const noexcept {
+        return this->words.size() * sizeof(word_type)
+            + this->headers.size() * sizeof(block_header)
+            + this->tail.size() * sizeof(value_type);
+    }
+
+    // Modifiers
+    void push_back(value_type value) {
+        this->tail.push_back(value);
+        if (this->tail.size() == BLOCK_SIZE) {
+            this->seal(this->tail.data());
+            this->tail.clear();
+        }
+    }
+
+    // appends many values; full blocks are packed straight from `values`
+    void append(std::span<const value_type> values) {
+        size_type i { 0uz };
+        while (!this->tail.empty() && i < values.size()) {
+            this->push_back(values[i++]);
+        }
+        for (; i + BLOCK_SIZE <= values.size(); i += BLOCK_SIZE) {
+            this->seal(values.data() + i);
+        }
+        for (; i < values.size(); ++i) {
+            this->push_back(values[i]);
+        }
+    }
+
+    void clear() noexcept {
+        this->words.clear();
+        this->headers.clear();
+        this->tail.clear();
+    }
+
+    // Bulk decoding
+    // Decodes block `block` into `out`, which must hold BLOCK_SIZE values
+    void decode_block(
+        size_type block,
+        std::span<value_type> out,
+        zstl::simd::level l = zstl::simd::detected_level()
+    ) const {
+        namespace impl = detail::packed_int_vector;
+        if (block >= this->headers.size() || out.size() < BLOCK_SIZE) [[unlikely]] {
+            throw std::out_of_range("packed_int_vector::decode_block");
+        }
+        impl::decode(this->headers[block], this->words.data(), out.data(), impl::unpacker(l));
+    }
+
+    // Calls `func(std::span<const value_type>)` with the values in order,
+    //   one decoded block (and finally the tail) at a time
+    template <typename Func>
+    void for_each_block(Func &&func, zstl::simd::level l = zstl::simd::detected_level()) const {
+        namespace impl = detail::packed_int_vector;
+        impl::unpack_fn unpack = impl::unpacker(l);
+        alignas(64) std::array<value_type, BLOCK_SIZE> buf;
+        for (const block_header &h : this->headers) {
+            impl::decode(h, this->words.data(), buf.data(), unpack);
+            func(std::span<const value_type>(buf.data(), BLOCK_SIZE));
+        }
+        if (!this->tail.empty()) {
+            func(std::span<const value_type>(this->tail.data(), this->tail.size()));
+        }
+    }
+
+    // Decodes every value into `out`, which must hold size() values
+    void copy_to(std::span<value_type> out, zstl::simd::level l = zstl::simd::detected_level()) const {
+        namespace impl = detail::packed_int_vector;
+        if (out.size() < this->size()) [[unlikely]] {
+            throw std::out_of_range("packed_int_vector::copy_to");
+        }
+        impl::unpack_fn unpack = impl::unpacker(l);
+        for (size_type block { 0uz }; block < this->headers.size(); ++block) {
+            impl::decode(this->headers[block], this->words.data(), out.data() + block * BLOCK_SIZE, unpack);
+        }
+        if (!this->tail.empty()) {
+            std::memcpy(
+                out.data() + this->headers.size() * BLOCK_SIZE,
+                this->tail.data(),
+                this->tail.size() * sizeof(value_type)
+            );
+        }
+    }
+
+private:
+    // packs BLOCK_SIZE values as a new block
+    void seal(const value_type *values) {
+        namespace impl = detail::packed_int_vector;
+
+        value_type lo = values[0];
+        value_type hi = values[0];
+        value_type maxDelta { 0u };
+        bool sorted { true };
+        for (size_type v { 1uz }; v < BLOCK_SIZE; ++v) {
+            lo = values[v] < lo ? values[v] : lo;
+            hi = values[v] > hi ? values[v] : hi;
+            sorted = sorted && values[v] >= values[v - 1uz];
+            value_type d = values[v] - values[v - 1uz];
+            maxDelta = d > maxDelta ? d : maxDelta;
+        }
+
+        auto forWidth = static_cast<size_type>(std::bit_width(hi - lo));
+        auto deltaWidth = static_cast<size_type>(std::bit_width(maxDelta));
+        bool delta = sorted && deltaWidth < forWidth;
+        size_type width = delta ? deltaWidth : forWidth;
+
+        std::array<word_type, BLOCK_SIZE> reduced;
+        for (size_type v { 0uz }; v < BLOCK_SIZE; ++v) {
+            if (delta) {
+                reduced[v] = v == 0uz ? 0u : values[v] - values[v - 1uz];
+            } else {
+                reduced[v] = values[v] - lo;
+            }
+        }
+
+        // grows geometrically, unlike resize()
+        size_type offset = this->words.size();
+        std::span<word_type> packed = this->words.append_uninitialized(impl::STREAMS * width);
+        if (width != 0uz) {
+            std::memset(packed.data(), 0, packed.size_bytes());
+            impl::pack(reduced.data(), width, packed.data());
+        }
+        this->headers.push_back(
+            block_header {
+                .base = delta ? values[0] : lo,
+                .offset = offset,
+                .width = static_cast<std::uint8_t>(width),
+                .delta = delta
+            }
+        );
+    }
+};
+
+} // namespace zstl end
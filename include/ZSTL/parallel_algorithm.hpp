@@ -0,0 +1,340 @@
+#pragma once
+
+#include "vector.hpp"
+#include "thread_pool.hpp" // zstl::parallel_policy, zstl::parallel_for_chunks
+
+#include <span>
+#include <ranges>
+#include <cstddef>
+#include <utility>
+#include <iterator>
+#include <algorithm> // std::sort, std::merge, std::move
+#include <functional> // std::less, std::plus
+
+
+// Parallel algorithms over contiguous ranges (`zstl::vector`, `std::span`, ...)
+//   that run on `zstl::thread_pool` workers:
+//   - parallel_sort: per-chunk std::sort, then rounds of pairwise merges where every
+//     merge is itself split along its merge path so all threads stay busy
+//   - parallel_reduce: per-chunk partial results combined in chunk order
+//   - parallel_inclusive_scan / parallel_exclusive_scan: two-pass scan
+//     (chunk totals, then a local scan of every chunk seeded with its prefix)
+// `op` must be associative; it does not have to be commutative
+namespace zstl {
+
+namespace detail::parallel_algorithm {
+
+// Merge path co-rank: the number of elements taken from `a` among the first `d`
+//   elements of the stable merge of `a` and `b`
+template <typename T, typename Compare>
+std::size_t co_rank(
+    std::size_t d,
+    const T *a,
+    std::size_t lenA,
+    const T *b,
+    std::size_t lenB,
+    Compare &comp
+) {
+    std::size_t lo = d > lenB ? d - lenB : 0uz;
+    std::size_t hi = d < lenA ? d : lenA;
+    while (lo < hi) {
+        std::size_t i = lo + (hi - lo) / 2uz;
+        std::size_t j = d - i;
+        // a[i] precedes b[j - 1] in the merge, so more than i elements come from `a`
+        if (j > 0uz && !comp(b[j - 1uz], a[i])) {
+            lo = i + 1uz;
+        } else {
+            hi = i;
+        }
+    }
+
+    return lo;
+}
+
+} // namespace detail::parallel_algorithm end
+
+
+template <std::ranges::contiguous_range Range, typename Compare = std::less<>>
+    requires std::ranges::sized_range<Range>
+void parallel_sort(
+    const parallel_policy &policy,
+    Range &&range,
+    Compare comp = {}
+) {
+    using T = std::ranges::range_value_t<Range>;
+    namespace impl = detail::parallel_algorithm;
+
+    T *data = std::ranges::data(range);
+    std::size_t n = std::ranges::size(range);
+    std::size_t nChunks = parallel_chunk_count(policy, n);
+    if (nChunks <= 1uz) {
+        std::sort(data, data + n, comp);
+        return ;
+    }
+
+    // sorted runs are [runs[k], runs[k + 1])
+    zstl::vector<std::size_t> runs;
+    for (std::size_t chunk { 0uz }; chunk <= nChunks; ++chunk) {
+        runs.push_back(n * chunk / nChunks);
+    }
+
+    parallel_for_chunks(
+        policy,
+        n,
+        nChunks,
+        [&](std::size_t, std::size_t begin, std::size_t end) {
+            std::sort(data + begin, data + end, comp);
+        }
+    );
+
+    // ping-pong between the input and a scratch buffer from the default memory_resource
+    zstl::vector<T> scratch;
+    scratch.resize_for_overwrite(n);
+    T *src = data;
+    T *dst = scratch.data();
+
+    thread_pool &pool = policy.get_pool();
+    while (runs.size() > 2uz) {
+        std::size_t nRuns = runs.size() - 1uz;
+        std::size_t nPairs = (nRuns + 1uz) / 2uz;
+        std::size_t parts = pool.size() > nPairs ? pool.size() / nPairs : 1uz;
+
+        // merge path splits of every pair, computed before any task starts moving
+        //   elements out of `src` (which the binary searches would otherwise read)
+        zstl::vector<std::size_t> splits;
+        splits.reserve(nPairs * (parts + 1uz));
+        for (std::size_t pair { 0uz }; pair < nPairs; ++pair) {
+            std::size_t first = runs[2uz * pair];
+            std::size_t mid = runs[2uz * pair + 1uz];
+            std::size_t last = 2uz * pair + 2uz < runs.size() ? runs[2uz * pair + 2uz] : mid;
+            for (std::size_t part { 0uz }; part <= parts; ++part) {
+                std::size_t d = (last - first) * part / parts;
+                splits.push_back(
+                    impl::co_rank(d, src + first, mid - first, src + mid, last - mid, comp)
+                );
+            }
+        }
+
+        pool.run(
+            nPairs * parts,
+            [&](std::size_t task) {
+                std::size_t pair = task / parts;
+                std::size_t part = task % parts;
+
+                std::size_t first = runs[2uz * pair];
+                std::size_t mid = runs[2uz * pair + 1uz];
+                std::size_t last = 2uz * pair + 2uz < runs.size() ? runs[2uz * pair + 2uz] : mid;
+
+                std::size_t d0 = (last - first) * part / parts;
+                std::size_t d1 = (last - first) * (part + 1uz) / parts;
+                std::size_t i0 = splits[pair * (parts + 1uz) + part];
+                std::size_t i1 = splits[pair * (parts + 1uz) + part + 1uz];
+
+                std::merge(
+                    std::make_move_iterator(src + first + i0),
+                    std::make_move_iterator(src + first + i1),
+                    std::make_move_iterator(src + mid + (d0 - i0)),
+                    std::make_move_iterator(src + mid + (d1 - i1)),
+                    dst + first + d0,
+                    comp
+                );
+            }
+        );
+
+        zstl::vector<std::size_t> merged;
+        for (std::size_t k { 0uz }; k < runs.size(); k += 2uz) {
+            merged.push_back(runs[k]);
+        }
+        if (merged.back() != n) {
+            merged.push_back(n);
+        }
+        runs = std::move(merged);
+        std::swap(src, dst);
+    }
+
+    if (src != data) {
+        parallel_for_chunks(
+            policy,
+            n,
+            nChunks,
+            [&](std::size_t, std::size_t begin, std::size_t end) {
+                std::move(src + begin, src + end, data + begin);
+            }
+        );
+    }
+}
+
+
+template <
+    std::ranges::contiguous_range Range,
+    typename T,
+    typename BinaryOp = std::plus<>
+>
+    requires std::ranges::sized_range<Range>
+T parallel_reduce(
+    const parallel_policy &policy,
+    const Range &range,
+    T init,
+    BinaryOp op = {}
+) {
+    const auto *data = std::ranges::data(range);
+    std::size_t n = std::ranges::size(range);
+    std::size_t nChunks = parallel_chunk_count(policy, n);
+    if (n == 0uz) {
+        return init;
+    }
+
+    zstl::vector<T> partials(nChunks, init);
+    parallel_for_chunks(
+        policy,
+        n,
+        nChunks,
+        [&](std::size_t chunk, std::size_t begin, std::size_t end) {
+            T acc = data[begin];
+            for (std::size_t i = begin + 1uz; i < end; ++i) {
+                acc = op(std::move(acc), data[i]);
+            }
+            partials[chunk] = std::move(acc);
+        }
+    );
+
+    for (std::size_t chunk { 0uz }; chunk < nChunks; ++chunk) {
+        init = op(std::move(init), partials[chunk]);
+    }
+
+    return init;
+}
+
+
+namespace detail::parallel_algorithm {
+
+// Two-pass scan shared by the inclusive and exclusive variants;
+//   `init` seeds chunk 0 (nullptr for an inclusive scan)
+template <bool Inclusive, typename In, typename Out, typename T, typename BinaryOp>
+void scan(
+    const parallel_policy &policy,
+    const In *in,
+    Out *out,
+    std::size_t n,
+    const T *init,
+    BinaryOp &op
+) {
+    std::size_t nChunks = parallel_chunk_count(policy, n);
+    if (n == 0uz) { return ; }
+
+    // pass 1: the total of every chunk but the last
+    zstl::vector<T> carries;
+    carries.reserve(nChunks);
+    for (std::size_t chunk { 0uz }; chunk < nChunks; ++chunk) {
+        carries.push_back(init ? *init : T(in[0uz]));
+    }
+    if (nChunks > 1uz) {
+        parallel_for_chunks(
+            policy,
+            n,
+            nChunks,
+            [&](std::size_t chunk, std::size_t begin, std::size_t end) {
+                if (chunk + 1uz == nChunks) { return ; }
+                T acc = in[begin];
+                for (std::size_t i = begin + 1uz; i < end; ++i) {
+                    acc = op(std::move(acc), in[i]);
+                }
+                carries[chunk] = std::move(acc);
+            }
+        );
+    }
+
+    // exclusive prefix of the chunk totals: what flows into each chunk
+    zstl::vector<bool> hasCarry(nChunks, false);
+    {
+        bool has = init != nullptr;
+        T running = init ? *init : T(in[0uz]);
+        for (std::size_t chunk { 0uz }; chunk < nChunks; ++chunk) {
+            T total = std::move(carries[chunk]);
+            carries[chunk] = running;
+            hasCarry[chunk] = has;
+            if (chunk + 1uz < nChunks) {
+                running = has ? op(std::move(running), total) : std::move(total);
+                has = true;
+            }
+        }
+    }
+
+    // pass 2: scan every chunk starting from its carry
+    parallel_for_chunks(
+        policy,
+        n,
+        nChunks,
+        [&](std::size_t chunk, std::size_t begin, std::size_t end) {
+            bool has = hasCarry[chunk];
+            T acc = carries[chunk];
+            for (std::size_t i = begin; i < end; ++i) {
+                // read before writing so that `in` and `out` may alias
+                T x = in[i];
+                if constexpr (Inclusive) {
+                    acc = has ? op(std::move(acc), std::move(x)) : std::move(x);
+                    has = true;
+                    out[i] = acc;
+                } else {
+                    out[i] = acc;
+                    acc = op(std::move(acc), std::move(x));
+                }
+            }
+        }
+    );
+}
+
+} // namespace detail::parallel_algorithm end
+
+
+// out[i] = in[0] op in[1] op ... op in[i]; `out` may be `in`
+template <
+    std::ranges::contiguous_range InRange,
+    std::ranges::contiguous_range OutRange,
+    typename BinaryOp = std::plus<>
+>
+    requires std::ranges::sized_range<InRange>
+void parallel_inclusive_scan(
+    const parallel_policy &policy,
+    const InRange &in,
+    OutRange &&out,
+    BinaryOp op = {}
+) {
+    using T = std::ranges::range_value_t<OutRange>;
+
+    detail::parallel_algorithm::scan<true>(
+        policy,
+        std::ranges::data(in),
+        std::ranges::data(out),
+        std::ranges::size(in),
+        static_cast<const T *>(nullptr),
+        op
+    );
+}
+
+// out[i] = init op in[0] op ... op in[i - 1]; `out` may be `in`
+template <
+    std::ranges::contiguous_range InRange,
+    std::ranges::contiguous_range OutRange,
+    typename T,
+    typename BinaryOp = std::plus<>
+>
+    requires std::ranges::sized_range<InRange>
+void parallel_exclusive_scan(
+    const parallel_policy &policy,
+    const InRange &in,
+    OutRange &&out,
+    T init,
+    BinaryOp op = {}
+) {
+    detail::parallel_algorithm::scan<false>(
+        policy,
+        std::ranges::data(in),
+        std::ranges::data(out),
+        std::ranges::size(in),
+        &init,
+        op
+    );
+}
+
+} // namespace zstl end
@@ -0,0 +1,242 @@
+#pragma once
+
+#include "memory_resource.hpp"
+#include "vector.hpp"
+#include "tagged_ptr.hpp"
+
+#include <bit>
+#include <span>
+#include <tuple>
+#include <limits>
+#include <cstddef>
+#include <cstdint>
+#include <utility>
+#include <stdexcept>
+
+
+// poly_collection
+// Objects of the types Ts... stored by value, one zstl::vector per type, instead of
+//   one heap allocation per object referenced by a tagged_ptr:
+//   zstl::poly_collection<Circle, Rectangle> shapes;
+//   auto h = shapes.emplace<Circle>(2.0);
+//   shapes.for_each([&](const auto *s) { total += s->get_area(); });
+// for_each walks the segments one after the other, so every type is a direct
+//   loop over contiguous memory and the call inside it is inlined; there is no
+//   per-element dispatch at all
+// Elements are referred to by `handle`s (type tag + index in the segment, 4 bytes),
+//   which stay valid as the collection grows; get(h) gives the tagged_ptr, which
+//   like a vector iterator is invalidated by the next insertion of that type
+namespace zstl {
+
+template <typename... Ts>
+class poly_collection {
+public:
+    using size_type = std::size_t;
+    using pointer = tagged_ptr<Ts...>;
+    using allocator_type = pmr::polymorphic_allocator<std::byte>;
+
+    static constexpr std::size_t TAG_BITS = std::bit_width(sizeof...(Ts));
+    static constexpr std::size_t INDEX_BITS = 32uz - TAG_BITS;
+
+    // [ tag : TAG_BITS | index : INDEX_BITS ], tag 0 is the null handle
+    class handle {
+    private:
+        std::uint32_t word { 0u };
+
+        friend class poly_collection;
+
+        handle(std::size_t tag, std::size_t index) noexcept
+            : word(static_cast<std::uint32_t>((tag << INDEX_BITS) | index))
+        {}
+
+    public:
+        handle() = default;
+
+        auto tag() const {
+            return static_cast<std::uint64_t>(this->word >> INDEX_BITS);
+        }
+
+        size_type index() const {
+            return static_cast<size_type>(this->word & INDEX_MASK);
+        }
+
+        friend bool operator==(const handle &, const handle &) = default;
+    };
+
+private:
+    static_assert(TAG_BITS < 16uz, "poly_collection: too many types for a 32-bit handle");
+
+    static constexpr std::uint32_t INDEX_MASK = (std::uint32_t { 1u } << INDEX_BITS) - 1u;
+
+    std::tuple<zstl::vector<Ts>...> segments;
+
+    template <typename T>
+    zstl::vector<T> &segment_of() noexcept {
+        return std::get<type_index_v<T, Ts...>>(this->segments);
+    }
+
+    template <typename T>
+    const zstl::vector<T> &segment_of() const noexcept {
+        return std::get<type_index_v<T, Ts...>>(this->segments);
+    }
+
+public:
+    // Constructor
+    explicit poly_collection(const allocator_type &alloc = allocator_type())
+        : segments(pmr::polymorphic_allocator<Ts>(alloc.resource())...)
+    {}
+
+    poly_collection(const poly_collection &) = delete;
+    poly_collection &operator=(const poly_collection &) = delete;
+
+    template <typename T>
+        requires contain_type<T, Ts...>
+    static constexpr std::size_t get_type_tag() {
+        return pointer::template get_type_tag<T>();
+    }
+
+    template <typename T, typename... Args>
+        requires contain_type<T, Ts...>
+    handle emplace(Args &&...args) {
+        zstl::vector<T> &seg = this->segment_of<T>();
+        if (seg.size() > INDEX_MASK) [[unlikely]] {
+            throw std::length_error("poly_collection::emplace");
+        }
+        seg.emplace_back(std::forward<Args>(args)...);
+        return handle(get_type_tag<T>(), seg.size() - 1uz);
+    }
+
+    template <typename T>
+        requires contain_type<std::remove_cvref_t<T>, Ts...>
+    handle insert(T &&value) {
+        return this->emplace<std::remove_cvref_t<T>>(std::forward<T>(value));
+    }
+
+    template <typename T>
+        requires contain_type<T, Ts...>
+    void reserve(size_type n) {
+        this->segment_of<T>().reserve(n);
+    }
+
+    void clear() noexcept {
+        std::apply([](auto &...seg) { (seg.clear(), ...); }, this->segments);
+    }
+
+    size_type size() const noexcept {
+        return std::apply([](const auto &...seg) { return (seg.size() + ...); }, this->segments);
+    }
+
+    template <typename T>
+        requires contain_type<T, Ts...>
+    size_type size() const noexcept {
+        return this->segment_of<T>().size();
+    }
+
+    bool empty() const noexcept {
+        return this->size() == 0uz;
+    }
+
+    // The contiguous storage of type T
+    template <typename T>
+        requires contain_type<T, Ts...>
+    std::span<T> segment() noexcept {
+        zstl::vector<T> &seg = this->segment_of<T>();
+        return { seg.data(), seg.size() };
+    }
+
+    template <typename T>
+        requires contain_type<T, Ts...>
+    std::span<const T> segment() const noexcept {
+        const zstl::vector<T> &seg = this->segment_of<T>();
+        return { seg.data(), seg.size() };
+    }
+
+    // The tagged_ptr to the element of `h`; a null `h` gives nullptr
+    pointer get(handle h) const {
+        pointer p = nullptr;
+        std::size_t tag { 0uz };
+        auto getOne = [&]<typename T>() {
+            if (h.tag() == ++tag) {
+                p = pointer(this->segment_of<T>().data() + h.index());
+            }
+        };
+        (getOne.template operator()<Ts>(), ...);
+        return p;
+    }
+
+    template <typename T>
+        requires contain_type<T, Ts...>
+    T *cast(handle h) noexcept {
+        return h.tag() == get_type_tag<T>()
+            ? this->segment_of<T>().data() + h.index()
+            : nullptr;
+    }
+
+    template <typename T>
+        requires contain_type<T, Ts...>
+    const T *cast(handle h) const noexcept {
+        return h.tag() == get_type_tag<T>()
+            ? this->segment_of<T>().data() + h.index()
+            : nullptr;
+    }
+
+    template <typename Func>
+    decltype(auto) call(handle h, Func &&func) {
+        return this->get(h).call(std::forward<Func>(func));
+    }
+
+    template <typename Func>
+    decltype(auto) call(handle h, Func &&func) const {
+        const pointer p = this->get(h);
+        return p.call(std::forward<Func>(func));
+    }
+
+    // visitor(segment<T>()) for every type T with elements, in tag order
+    template <typename Visitor>
+    void visit(Visitor &&visitor) {
+        auto visitOne = [&]<typename T>() {
+            std::span<T> s = this->template segment<T>();
+            if (!s.empty()) {
+                visitor(s);
+            }
+        };
+        (visitOne.template operator()<Ts>(), ...);
+    }
+
+    template <typename Visitor>
+    void visit(Visitor &&visitor) const {
+        auto visitOne = [&]<typename T>() {
+            std::span<const T> s = this->template segment<T>();
+            if (!s.empty()) {
+                visitor(s);
+            }
+        };
+        (visitOne.template operator()<Ts>(), ...);
+    }
+
+    // func(p) for every element, one type after the other, with `p` a T * like
+    //   in tagged_ptr::call
+    template <typename Func>
+    void for_each(Func &&func) {
+        this->visit(
+            [&func](auto s) {
+                for (auto &x : s) {
+                    func(&x);
+                }
+            }
+        );
+    }
+
+    template <typename Func>
+    void for_each(Func &&func) const {
+        this->visit(
+            [&func](auto s) {
+                for (const auto &x : s) {
+                    func(&x);
+                }
+            }
+        );
+    }
+};
+
+} // namespace zstl end
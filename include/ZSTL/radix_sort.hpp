@@ -0,0 +1,265 @@
+#pragma once
+
+#include "memory_resource.hpp"
+#include "vector.hpp"
+#include "thread_pool.hpp" // zstl::parallel_policy, zstl::parallel_for_chunks
+
+#include <bit> // std::bit_cast
+#include <array>
+#include <ranges>
+#include <cstdint>
+#include <cstddef>
+#include <utility>
+#include <algorithm> // std::move
+#include <functional> // std::identity
+#include <type_traits>
+
+
+// LSD radix sort over contiguous ranges (`zstl::vector`, `std::span`, ...)
+// Keys are integers or IEEE floats, either the elements themselves (radix_sort)
+//   or extracted from records (radix_sort_by_key); radix_key() maps every key type
+//   to an unsigned integer with the same ordering, which is then sorted one byte
+//   per pass, least significant first
+// - the scratch buffer for the ping-pong between passes comes from a memory_resource
+// - all byte histograms are built in one read of the input; a pass whose histogram
+//   has a single non-empty bucket would not move anything and is skipped
+// - the parallel overloads split every pass over a thread pool, each chunk scattering
+//   through its own bucket offsets so the sort stays stable
+// The sort is stable
+namespace zstl {
+
+// Order-preserving map from an arithmetic key to an unsigned integer of the same size:
+//   signed integers get their sign bit flipped; for floats, negative values have all
+//   bits flipped and non-negative values only the sign bit
+template <typename Key>
+    requires std::is_arithmetic_v<Key>
+constexpr auto radix_key(Key key) noexcept {
+    using U = std::conditional_t<
+        sizeof(Key) == 1uz, std::uint8_t,
+        std::conditional_t<
+            sizeof(Key) == 2uz, std::uint16_t,
+            std::conditional_t<sizeof(Key) == 4uz, std::uint32_t, std::uint64_t>
+        >
+    >;
+    static_assert(sizeof(U) == sizeof(Key), "radix_key expects 1, 2, 4 or 8 byte keys");
+    constexpr U SIGN_BIT = U(1) << (sizeof(U) * 8uz - 1uz);
+
+    if constexpr (std::is_floating_point_v<Key>) {
+        U bits = std::bit_cast<U>(key);
+        return static_cast<U>((bits & SIGN_BIT) ? ~bits : (bits | SIGN_BIT));
+    } else if constexpr (std::is_signed_v<Key>) {
+        return static_cast<U>(static_cast<U>(key) ^ SIGN_BIT);
+    } else {
+        return static_cast<U>(key);
+    }
+}
+
+
+namespace detail::radix_sort {
+
+inline constexpr std::size_t RADIX { 256uz };
+
+template <typename KeyFn, typename T>
+using key_type = decltype(radix_key(std::declval<KeyFn &>()(std::declval<const T &>())));
+
+template <typename KeyFn, typename T>
+inline constexpr std::size_t DIGITS = sizeof(key_type<KeyFn, T>);
+
+template <typename U>
+constexpr std::size_t digit(U key, std::size_t pass) noexcept {
+    return static_cast<std::size_t>((key >> (pass * 8uz)) & U(0xff));
+}
+
+// counts[pass * RADIX + b] += number of elements in [first, last) whose byte `pass` is b
+template <typename T, typename KeyFn>
+void histogram_all(const T *first, const T *last, KeyFn &key, std::size_t *counts) {
+    constexpr std::size_t nDigits = DIGITS<KeyFn, T>;
+    for (const T *p = first; p != last; ++p) {
+        auto k = radix_key(key(*p));
+        for (std::size_t pass { 0uz }; pass < nDigits; ++pass) {
+            ++counts[pass * RADIX + digit(k, pass)];
+        }
+    }
+}
+
+template <typename T, typename KeyFn>
+void histogram_one(const T *first, const T *last, KeyFn &key, std::size_t pass, std::size_t *counts) {
+    for (const T *p = first; p != last; ++p) {
+        ++counts[digit(radix_key(key(*p)), pass)];
+    }
+}
+
+template <typename T, typename KeyFn>
+void scatter(T *first, T *last, T *dst, KeyFn &key, std::size_t pass, std::size_t *offsets) {
+    for (T *p = first; p != last; ++p) {
+        std::size_t b = digit(radix_key(key(*p)), pass);
+        dst[offsets[b]++] = std::move(*p);
+    }
+}
+
+// a pass is trivial when every element falls into the same bucket
+inline bool trivial_pass(const std::size_t *counts, std::size_t n) {
+    for (std::size_t b { 0uz }; b < RADIX; ++b) {
+        if (counts[b] != 0uz) {
+            return counts[b] == n;
+        }
+    }
+    return true;
+}
+
+template <typename T, typename KeyFn>
+void sort(
+    T *data,
+    std::size_t n,
+    KeyFn &key,
+    pmr::memory_resource *resource,
+    const parallel_policy *policy
+) {
+    constexpr std::size_t nDigits = DIGITS<KeyFn, T>;
+    if (n < 2uz) { return ; }
+
+    std::size_t nChunks = policy ? parallel_chunk_count(*policy, n) : 1uz;
+
+    // per-chunk histograms of every byte, from a single read of the input;
+    //   the byte distribution does not depend on the order of the elements,
+    //   so the totals decide once which passes can be skipped
+    zstl::vector<std::size_t> chunkCounts(
+        nChunks * nDigits * RADIX,
+        0uz,
+        pmr::polymorphic_allocator<std::size_t>(resource)
+    );
+    auto forEachChunk = [&](auto &&func) {
+        if (nChunks <= 1uz) {
+            func(0uz, 0uz, n);
+        } else {
+            parallel_for_chunks(*policy, n, nChunks, func);
+        }
+    };
+    forEachChunk(
+        [&](std::size_t chunk, std::size_t begin, std::size_t end) {
+            histogram_all(data + begin, data + end, key, chunkCounts.data() + chunk * nDigits * RADIX);
+        }
+    );
+
+    std::array<std::size_t, nDigits * RADIX> totals {};
+    for (std::size_t chunk { 0uz }; chunk < nChunks; ++chunk) {
+        for (std::size_t i { 0uz }; i < nDigits * RADIX; ++i) {
+            totals[i] += chunkCounts[chunk * nDigits * RADIX + i];
+        }
+    }
+
+    pmr::polymorphic_allocator<T> scratchAlloc(resource);
+    zstl::vector<T> scratch(scratchAlloc);
+    T *src = data;
+    T *dst = nullptr;
+
+    // offsets[chunk * RADIX + b]: where chunk `chunk` writes its next element of bucket b
+    zstl::vector<std::size_t> offsets(nChunks * RADIX, 0uz, pmr::polymorphic_allocator<std::size_t>(resource));
+    bool firstPass { true };
+    for (std::size_t pass { 0uz }; pass < nDigits; ++pass) {
+        if (trivial_pass(totals.data() + pass * RADIX, n)) {
+            continue;
+        }
+
+        if (!dst) {
+            scratch.resize_for_overwrite(n);
+            dst = scratch.data();
+        }
+
+        // the per-chunk histograms from the initial read only match the original order
+        if (firstPass) {
+            for (std::size_t chunk { 0uz }; chunk < nChunks; ++chunk) {
+                std::copy_n(
+                    chunkCounts.data() + (chunk * nDigits + pass) * RADIX,
+                    RADIX,
+                    offsets.data() + chunk * RADIX
+                );
+            }
+        } else {
+            std::fill(offsets.begin(), offsets.end(), 0uz);
+            forEachChunk(
+                [&](std::size_t chunk, std::size_t begin, std::size_t end) {
+                    histogram_one(src + begin, src + end, key, pass, offsets.data() + chunk * RADIX);
+                }
+            );
+        }
+        firstPass = false;
+
+        // bucket-major, chunk-minor exclusive prefix sum keeps equal keys in input order
+        std::size_t running { 0uz };
+        for (std::size_t b { 0uz }; b < RADIX; ++b) {
+            for (std::size_t chunk { 0uz }; chunk < nChunks; ++chunk) {
+                std::size_t count = offsets[chunk * RADIX + b];
+                offsets[chunk * RADIX + b] = running;
+                running += count;
+            }
+        }
+
+        forEachChunk(
+            [&](std::size_t chunk, std::size_t begin, std::size_t end) {
+                scatter(src + begin, src + end, dst, key, pass, offsets.data() + chunk * RADIX);
+            }
+        );
+        std::swap(src, dst);
+    }
+
+    if (src != data) {
+        forEachChunk(
+            [&](std::size_t, std::size_t begin, std::size_t end) {
+                std::move(src + begin, src + end, data + begin);
+            }
+        );
+    }
+}
+
+} // namespace detail::radix_sort end
+
+
+// Sorts integers or floats in ascending order
+template <std::ranges::contiguous_range Range>
+    requires std::ranges::sized_range<Range>
+        && std::is_arithmetic_v<std::ranges::range_value_t<Range>>
+void radix_sort(
+    Range &&range,
+    pmr::memory_resource *resource = pmr::new_delete_resource()
+) {
+    std::identity key;
+    detail::radix_sort::sort(std::ranges::data(range), std::ranges::size(range), key, resource, nullptr);
+}
+
+template <std::ranges::contiguous_range Range>
+    requires std::ranges::sized_range<Range>
+        && std::is_arithmetic_v<std::ranges::range_value_t<Range>>
+void radix_sort(
+    const parallel_policy &policy,
+    Range &&range,
+    pmr::memory_resource *resource = pmr::new_delete_resource()
+) {
+    std::identity key;
+    detail::radix_sort::sort(std::ranges::data(range), std::ranges::size(range), key, resource, &policy);
+}
+
+// Sorts records by the arithmetic key `key(record)`; records must be
+//   default constructible and movable (the scratch buffer holds moved-from records)
+template <std::ranges::contiguous_range Range, typename KeyFn>
+    requires std::ranges::sized_range<Range>
+void radix_sort_by_key(
+    Range &&range,
+    KeyFn key,
+    pmr::memory_resource *resource = pmr::new_delete_resource()
+) {
+    detail::radix_sort::sort(std::ranges::data(range), std::ranges::size(range), key, resource, nullptr);
+}
+
+template <std::ranges::contiguous_range Range, typename KeyFn>
+    requires std::ranges::sized_range<Range>
+void radix_sort_by_key(
+    const parallel_policy &policy,
+    Range &&range,
+    KeyFn key,
+    pmr::memory_resource *resource = pmr::new_delete_resource()
+) {
+    detail::radix_sort::sort(std::ranges::data(range), std::ranges::size(range), key, resource, &policy);
+}
+
+} // namespace zstl end
@@ -0,0 +1,420 @@
+#pragma once
+
+#include "memory_resource.hpp"
+
+#include <bit> // std::bit_width, std::has_single_bit
+#include <span>
+#include <array>
+#include <cstddef>
+#include <utility>
+#include <iterator>
+#include <stdexcept>
+#include <type_traits>
+#include <initializer_list>
+
+
+// segmented_vector
+// A sequence container that grows by appending geometrically-sized segments
+//   instead of reallocating, so elements never move and pointers/references
+//   (and `tagged_ptr`s) to them stay valid until the element is popped
+// Segment 0 holds `FirstSegmentSize` elements and segment k (k >= 1) holds
+//   `FirstSegmentSize << (k - 1)`, so the capacity doubles with every segment
+//   and the segment of index i is `bit_width(i / FirstSegmentSize)`
+namespace zstl {
+
+template <
+    typename _Tp,
+    std::size_t FirstSegmentSize = 16uz,
+    class Allocator = pmr::polymorphic_allocator<_Tp>
+>
+    requires (std::has_single_bit(FirstSegmentSize))
+class segmented_vector {
+public:
+    using value_type = _Tp;
+    using allocator_type = Allocator;
+    using size_type = std::size_t;
+    using difference_type = std::ptrdiff_t;
+    using reference = _Tp &;
+    using const_reference = const _Tp &;
+    using pointer = _Tp *;
+    using const_pointer = const _Tp *;
+
+private:
+    static constexpr size_type FIRST_SHIFT = std::bit_width(FirstSegmentSize) - 1uz;
+    static constexpr size_type MAX_SEGMENTS = 64uz - FIRST_SHIFT;
+
+    allocator_type alloc;
+    std::array<pointer, MAX_SEGMENTS> segments {};
+    size_type nSegments { 0uz };
+    size_type nStored { 0uz };
+
+public:
+    static constexpr size_type segment_of(size_type index) noexcept {
+        return static_cast<size_type>(std::bit_width(index >> FIRST_SHIFT));
+    }
+
+    static constexpr size_type segment_begin(size_type segment) noexcept {
+        return segment == 0uz ? 0uz : FirstSegmentSize << (segment - 1uz);
+    }
+
+    static constexpr size_type segment_size(size_type segment) noexcept {
+        return segment == 0uz ? FirstSegmentSize : FirstSegmentSize << (segment - 1uz);
+    }
+
+private:
+    template <bool IsConst>
+    class basic_iterator {
+    private:
+        using owner_type = std::conditional_t<
+            IsConst,
+            const segmented_vector,
+            segmented_vector
+        >;
+
+        owner_type *owner { nullptr };
+        size_type index { 0uz };
+        // [cur, segEnd) is the rest of the current segment, so ++ only has to
+        //   look up the segment table when it crosses a segment boundary
+        std::conditional_t<IsConst, const _Tp *, _Tp *> cur { nullptr };
+        std::conditional_t<IsConst, const _Tp *, _Tp *> segEnd { nullptr };
+
+        void locate() {
+            size_type seg = segment_of(this->index);
+            if (seg < this->owner->nSegments) {
+                this->cur = this->owner->segments[seg] + (this->index - segment_begin(seg));
+                this->segEnd = this->owner->segments[seg] + segment_size(seg);
+            } else {
+                this->cur = nullptr;
+                this->segEnd = nullptr;
+            }
+        }
+
+        friend class segmented_vector;
+
+    public:
+        using iterator_category = std::random_access_iterator_tag;
+        using value_type = _Tp;
+        using difference_type = std::ptrdiff_t;
+        using pointer = std::conditional_t<IsConst, const _Tp *, _Tp *>;
+        using reference = std::conditional_t<IsConst, const _Tp &, _Tp &>;
+
+        basic_iterator() = default;
+
+        basic_iterator(owner_type *owner, size_type index)
+            : owner(owner)
+            , index(index)
+        {
+            this->locate();
+        }
+
+        operator basic_iterator<true>() const
+            requires (!IsConst)
+        {
+            return basic_iterator<true>(this->owner, this->index);
+        }
+
+        reference operator*() const { return *this->cur; }
+        pointer operator->() const { return this->cur; }
+
+        reference operator[](difference_type n) const {
+            return (*this->owner)[this->index + n];
+        }
+
+        basic_iterator &operator++() {
+            ++this->index;
+            if (++this->cur == this->segEnd) [[unlikely]] {
+                this->locate();
+            }
+            return *this;
+        }
+
+        basic_iterator operator++(int) {
+            basic_iterator old = *this;
+            ++*this;
+            return old;
+        }
+
+        basic_iterator &operator--() {
+            --this->index;
+            this->locate();
+            return *this;
+        }
+
+        basic_iterator operator--(int) {
+            basic_iterator old = *this;
+            --*this;
+            return old;
+        }
+
+        basic_iterator &operator+=(difference_type n) {
+            this->index += n;
+            this->locate();
+            return *this;
+        }
+
+        basic_iterator &operator-=(difference_type n) {
+            return *this += -n;
+        }
+
+        friend basic_iterator operator+(basic_iterator it, difference_type n) { return it += n; }
+        friend basic_iterator operator+(difference_type n, basic_iterator it) { return it += n; }
+        friend basic_iterator operator-(basic_iterator it, difference_type n) { return it -= n; }
+
+        friend difference_type operator-(const basic_iterator &a, const basic_iterator &b) {
+            return static_cast<difference_type>(a.index) - static_cast<difference_type>(b.index);
+        }
+
+        friend bool operator==(const basic_iterator &a, const basic_iterator &b) {
+            return a.index == b.index;
+        }
+
+        friend auto operator<=>(const basic_iterator &a, const basic_iterator &b) {
+            return a.index <=> b.index;
+        }
+    };
+
+public:
+    using iterator = basic_iterator<false>;
+    using const_iterator = basic_iterator<true>;
+
+    // Constructor
+    segmented_vector() noexcept(noexcept(allocator_type())) = default;
+
+    explicit segmented_vector(const allocator_type &alloc) noexcept
+        : alloc(alloc)
+    {}
+
+    segmented_vector(
+        std::initializer_list<value_type> init,
+        const allocator_type &alloc = allocator_type()
+    )
+        : alloc(alloc)
+    {
+        this->reserve(init.size());
+        for (const value_type &value : init) {
+            this->push_back(value);
+        }
+    }
+
+    segmented_vector(const segmented_vector &other)
+        : alloc(other.alloc)
+    {
+        this->reserve(other.size());
+        other.for_each_segment(
+            [this](std::span<const value_type> seg) {
+                for (const value_type &value : seg) {
+                    this->push_back(value);
+                }
+            }
+        );
+    }
+
+    segmented_vector(segmented_vector &&other) noexcept
+        : alloc(other.alloc)
+        , segments(other.segments)
+        , nSegments(other.nSegments)
+        , nStored(other.nStored)
+    {
+        other.segments = {};
+        other.nSegments = 0uz;
+        other.nStored = 0uz;
+    }
+
+    segmented_vector &operator=(const segmented_vector &) = delete;
+    segmented_vector &operator=(segmented_vector &&) = delete;
+
+    // Destructor
+    ~segmented_vector() {
+        this->clear();
+        this->release_segments();
+    }
+
+    allocator_type get_allocator() const noexcept {
+        return this->alloc;
+    }
+
+    // Element access
+    reference at(size_type index) {
+        if (index >= this->nStored) [[unlikely]] {
+            throw std::out_of_range("segmented_vector::at");
+        }
+
+        return (*this)[index];
+    }
+
+    const_reference at(size_type index) const {
+        if (index >= this->nStored) [[unlikely]] {
+            throw std::out_of_range("segmented_vector::at");
+        }
+
+        return (*this)[index];
+    }
+
+    reference operator[](size_type index) noexcept {
+        size_type seg = segment_of(index);
+        return this->segments[seg][index - segment_begin(seg)];
+    }
+
+    const_reference operator[](size_type index) const noexcept {
+        size_type seg = segment_of(index);
+        return this->segments[seg][index - segment_begin(seg)];
+    }
+
+    reference front() noexcept {
+        return this->segments[0uz][0uz];
+    }
+
+    const_reference front() const noexcept {
+        return this->segments[0uz][0uz];
+    }
+
+    reference back() noexcept {
+        return (*this)[this->nStored - 1uz];
+    }
+
+    const_reference back() const noexcept {
+        return (*this)[this->nStored - 1uz];
+    }
+
+    // Segment access: the elements as a sequence of contiguous spans
+    size_type segment_count() const noexcept {
+        return this->nStored == 0uz ? 0uz : segment_of(this->nStored - 1uz) + 1uz;
+    }
+
+    std::span<value_type> segment(size_type seg) noexcept {
+        return { this->segments[seg], this->used_in_segment(seg) };
+    }
+
+    std::span<const value_type> segment(size_type seg) const noexcept {
+        return { this->segments[seg], this->used_in_segment(seg) };
+    }
+
+    // Calls `func` with a std::span over each non-empty segment in order;
+    //   the preferred way to scan, since the inner loop is a plain array walk
+    template <typename Func>
+    void for_each_segment(Func &&func) {
+        for (size_type seg { 0uz }, n = this->segment_count(); seg < n; ++seg) {
+            func(this->segment(seg));
+        }
+    }
+
+    template <typename Func>
+    void for_each_segment(Func &&func) const {
+        for (size_type seg { 0uz }, n = this->segment_count(); seg < n; ++seg) {
+            func(this->segment(seg));
+        }
+    }
+
+    // Iterators
+    iterator begin() noexcept { return iterator(this, 0uz); }
+    const_iterator begin() const noexcept { return const_iterator(this, 0uz); }
+    const_iterator cbegin() const noexcept { return const_iterator(this, 0uz); }
+    iterator end() noexcept { return iterator(this, this->nStored); }
+    const_iterator end() const noexcept { return const_iterator(this, this->nStored); }
+    const_iterator cend() const noexcept { return const_iterator(this, this->nStored); }
+
+    // Capacity
+    bool empty() const noexcept {
+        return this->nStored == 0uz;
+    }
+
+    size_type size() const noexcept {
+        return this->nStored;
+    }
+
+    size_type capacity() const noexcept {
+        return segment_begin(this->nSegments);
+    }
+
+    // Allocates segments until `n` elements fit; existing elements never move
+    void reserve(size_type n) {
+        while (this->capacity() < n) {
+            this->add_segment();
+        }
+    }
+
+    // Releases the unused trailing segments
+    void shrink_to_fit() {
+        size_type keep = this->segment_count();
+        while (this->nSegments > keep) {
+            --this->nSegments;
+            this->alloc.template deallocate_object<value_type>(
+                this->segments[this->nSegments],
+                segment_size(this->nSegments)
+            );
+            this->segments[this->nSegments] = nullptr;
+        }
+    }
+
+    // Modifiers
+    void clear() noexcept {
+        if constexpr (!std::is_trivially_destructible_v<value_type>) {
+            this->for_each_segment(
+                [this](std::span<value_type> seg) {
+                    for (value_type &value : seg) {
+                        this->alloc.destroy(&value);
+                    }
+                }
+            );
+        }
+        this->nStored = 0uz;
+    }
+
+    void push_back(const_reference value) {
+        this->emplace_back(value);
+    }
+
+    void push_back(value_type &&value) {
+        this->emplace_back(std::move(value));
+    }
+
+    template <class... Args>
+    reference emplace_back(Args &&...args) {
+        if (this->nStored == this->capacity()) {
+            this->add_segment();
+        }
+
+        pointer p = &(*this)[this->nStored];
+        this->alloc.construct(p, std::forward<Args>(args)...);
+        ++(this->nStored);
+
+        return *p;
+    }
+
+    void pop_back() {
+        // DCHECK(!empty());
+        this->alloc.destroy(&this->back());
+        --(this->nStored);
+    }
+
+private:
+    size_type used_in_segment(size_type seg) const noexcept {
+        size_type first = segment_begin(seg);
+        size_type last = first + segment_size(seg);
+        return (this->nStored < last ? this->nStored : last) - first;
+    }
+
+    void add_segment() {
+        if (this->nSegments == MAX_SEGMENTS) [[unlikely]] {
+            throw std::length_error("segmented_vector::add_segment");
+        }
+
+        this->segments[this->nSegments] = this->alloc.template allocate_object<value_type>(
+            segment_size(this->nSegments)
+        );
+        ++(this->nSegments);
+    }
+
+    void release_segments() noexcept {
+        for (size_type seg { 0uz }; seg < this->nSegments; ++seg) {
+            this->alloc.template deallocate_object<value_type>(
+                this->segments[seg],
+                segment_size(seg)
+            );
+            this->segments[seg] = nullptr;
+        }
+        this->nSegments = 0uz;
+    }
+};
+
+} // namespace zstl end
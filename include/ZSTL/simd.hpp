@@ -0,0 +1,386 @@
+#pragma once
+
+#include <ranges>
+#include <limits>
+#include <cstdint>
+#include <cstddef>
+#include <cstring>
+#include <concepts>
+#include <type_traits>
+
+
+// SIMD search and aggregation kernels over contiguous arithmetic data
+//   (`zstl::vector`, `zstl::array`, `std::span`, ...): find, count, min, max and sum
+//   for int32_t, float and double
+// Each kernel is written once with GCC/Clang vector extensions and instantiated at
+//   16, 32 and 64 byte widths inside functions compiled for SSE2, AVX2 and AVX-512,
+//   so one binary carries every ISA level; the level is picked at runtime from CPUID
+//   (detected_level()) unless the caller asks for a specific one
+// Notes:
+// - min/max of an empty range return the identity (numeric_limits max/lowest)
+// - floating-point sums are reassociated across lanes, so they may differ from a
+//   sequential sum in the last bits; int32_t sums are accumulated in int64_t
+// - NaNs are not ordered: find/count never match them and min/max skip them
+namespace zstl::simd {
+
+enum class level {
+    scalar,
+    sse2,
+    avx2,
+    avx512
+};
+
+inline const char *level_name(level l) noexcept {
+    switch (l) {
+        case level::scalar: return "scalar";
+        case level::sse2: return "sse2";
+        case level::avx2: return "avx2";
+        case level::avx512: return "avx512";
+    }
+    return "unknown";
+}
+
+// the best level supported by both the build and the running CPU
+inline level detected_level() noexcept {
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+    static const level best = [] {
+        __builtin_cpu_init();
+        if (__builtin_cpu_supports("avx512f") && __builtin_cpu_supports("avx512bw")
+            && __builtin_cpu_supports("avx512dq") && __builtin_cpu_supports("avx512vl")) {
+            return level::avx512;
+        }
+        if (__builtin_cpu_supports("avx2")) { return level::avx2; }
+        if (__builtin_cpu_supports("sse2")) { return level::sse2; }
+        return level::scalar;
+    }();
+    return best;
+#else
+    return level::scalar;
+#endif
+}
+
+template <typename T>
+concept kernel_type = std::same_as<T, std::int32_t>
+    || std::same_as<T, float>
+    || std::same_as<T, double>;
+
+template <typename T>
+using sum_type = std::conditional_t<std::is_integral_v<T>, std::int64_t, T>;
+
+
+namespace detail {
+
+// scalar fallback, also used for the tails of the vector kernels
+template <typename T>
+std::size_t find_scalar(const T *p, std::size_t n, T value) noexcept {
+    for (std::size_t i { 0uz }; i < n; ++i) {
+        if (p[i] == value) {
+            return i;
+        }
+    }
+    return n;
+}
+
+template <typename T>
+std::size_t count_scalar(const T *p, std::size_t n, T value) noexcept {
+    std::size_t c { 0uz };
+    for (std::size_t i { 0uz }; i < n; ++i) {
+        c += p[i] == value;
+    }
+    return c;
+}
+
+template <typename T>
+T min_scalar(const T *p, std::size_t n) noexcept {
+    T m = std::numeric_limits<T>::max();
+    for (std::size_t i { 0uz }; i < n; ++i) {
+        m = p[i] < m ? p[i] : m;
+    }
+    return m;
+}
+
+template <typename T>
+T max_scalar(const T *p, std::size_t n) noexcept {
+    T m = std::numeric_limits<T>::lowest();
+    for (std::size_t i { 0uz }; i < n; ++i) {
+        m = p[i] > m ? p[i] : m;
+    }
+    return m;
+}
+
+template <typename T>
+sum_type<T> sum_scalar(const T *p, std::size_t n) noexcept {
+    sum_type<T> s {};
+    for (std::size_t i { 0uz }; i < n; ++i) {
+        s += p[i];
+    }
+    return s;
+}
+
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define ZSTL_SIMD_X86 1
+
+// the helpers below are always inlined into their ISA-specific callers,
+//   so the vector-argument ABI warnings do not apply
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wpsabi"
+
+template <typename T, std::size_t Bytes>
+struct vec {
+    using type [[gnu::vector_size(Bytes)]] = T;
+};
+
+template <typename T, std::size_t Bytes>
+using vec_t = typename vec<T, Bytes>::type;
+
+template <typename V>
+[[gnu::always_inline]] inline V load(const void *p) noexcept {
+    V v;
+    std::memcpy(&v, p, sizeof(V));
+    return v;
+}
+
+// true if any lane of a comparison result is set
+template <typename M>
+[[gnu::always_inline]] inline bool any(const M &mask) noexcept {
+    std::uint64_t words[sizeof(M) / 8uz];
+    std::memcpy(words, &mask, sizeof(M));
+    std::uint64_t bits { 0u };
+    for (std::uint64_t w : words) {
+        bits |= w;
+    }
+    return bits != 0u;
+}
+
+template <typename T, std::size_t Bytes>
+[[gnu::always_inline]] inline std::size_t find_kernel(const T *p, std::size_t n, T value) noexcept {
+    using V = vec_t<T, Bytes>;
+    constexpr std::size_t L = Bytes / sizeof(T);
+    const V key = V {} + value;
+
+    std::size_t i { 0uz };
+    // four vectors per iteration, then locate the lane only on a hit
+    for (; i + 4uz * L <= n; i += 4uz * L) {
+        // masks are summed rather than or-ed: GCC scalarizes an OR of 512-bit compares
+        auto m = load<V>(p + i) == key;
+        m += load<V>(p + i + L) == key;
+        m += load<V>(p + i + 2uz * L) == key;
+        m += load<V>(p + i + 3uz * L) == key;
+        if (any(m)) [[unlikely]] {
+            return i + find_scalar(p + i, 4uz * L, value);
+        }
+    }
+    for (; i + L <= n; i += L) {
+        if (any(load<V>(p + i) == key)) [[unlikely]] {
+            return i + find_scalar(p + i, L, value);
+        }
+    }
+    return i + find_scalar(p + i, n - i, value);
+}
+
+template <typename T, std::size_t Bytes>
+[[gnu::always_inline]] inline std::size_t count_kernel(const T *p, std::size_t n, T value) noexcept {
+    using V = vec_t<T, Bytes>;
+    using M = decltype(V {} == V {});
+    constexpr std::size_t L = Bytes / sizeof(T);
+    // keep every lane counter far below overflow
+    constexpr std::size_t BLOCK = (std::size_t { 1u } << 30) * L;
+    const V key = V {} + value;
+
+    std::size_t total { 0uz };
+    std::size_t i { 0uz };
+    while (i + L <= n) {
+        std::size_t blockEnd = n - i > BLOCK ? i + BLOCK : n;
+        M acc {};
+        for (; i + L <= blockEnd; i += L) {
+            acc -= load<V>(p + i) == key; // true lanes are -1
+        }
+        for (std::size_t lane { 0uz }; lane < L; ++lane) {
+            total += static_cast<std::size_t>(acc[lane]);
+        }
+    }
+    return total + count_scalar(p + i, n - i, value);
+}
+
+template <typename T, std::size_t Bytes, bool IsMin>
+[[gnu::always_inline]] inline T minmax_kernel(const T *p, std::size_t n) noexcept {
+    using V = vec_t<T, Bytes>;
+    constexpr std::size_t L = Bytes / sizeof(T);
+    const T identity = IsMin ? std::numeric_limits<T>::max() : std::numeric_limits<T>::lowest();
+
+    V acc0 = V {} + identity;
+    V acc1 = acc0;
+    std::size_t i { 0uz };
+    for (; i + 2uz * L <= n; i += 2uz * L) {
+        V a = load<V>(p + i);
+        V b = load<V>(p + i + L);
+        if constexpr (IsMin) {
+            acc0 = a < acc0 ? a : acc0;
+            acc1 = b < acc1 ? b : acc1;
+        } else {
+            acc0 = a > acc0 ? a : acc0;
+            acc1 = b > acc1 ? b : acc1;
+        }
+    }
+    acc0 = IsMin ? (acc1 < acc0 ? acc1 : acc0) : (acc1 > acc0 ? acc1 : acc0);
+
+    T m = IsMin ? min_scalar(p + i, n - i) : max_scalar(p + i, n - i);
+    for (std::size_t lane { 0uz }; lane < L; ++lane) {
+        m = IsMin ? (acc0[lane] < m ? acc0[lane] : m) : (acc0[lane] > m ? acc0[lane] : m);
+    }
+    return m;
+}
+
+template <typename T, std::size_t Bytes>
+[[gnu::always_inline]] inline sum_type<T> sum_kernel(const T *p, std::size_t n) noexcept {
+    using S = sum_type<T>;
+    // int32_t lanes are widened, so each step loads half a register of input
+    constexpr std::size_t L = Bytes / sizeof(S);
+    using V = vec_t<S, Bytes>;
+
+    V acc0 {};
+    V acc1 {};
+    std::size_t i { 0uz };
+    for (; i + 2uz * L <= n; i += 2uz * L) {
+        if constexpr (std::is_same_v<S, T>) {
+            acc0 += load<V>(p + i);
+            acc1 += load<V>(p + i + L);
+        } else {
+            using H = vec_t<T, L * sizeof(T)>;
+            acc0 += __builtin_convertvector(load<H>(p + i), V);
+            acc1 += __builtin_convertvector(load<H>(p + i + L), V);
+        }
+    }
+    acc0 += acc1;
+
+    S s = sum_scalar(p + i, n - i);
+    for (std::size_t lane { 0uz }; lane < L; ++lane) {
+        s += acc0[lane];
+    }
+    return s;
+}
+
+// one instantiation of every kernel per ISA level
+#define ZSTL_SIMD_DEFINE_LEVEL(NAME, TARGET, BYTES)                                      \
+    template <typename T>                                                                \
+    [[gnu::target(TARGET)]] std::size_t find_##NAME(const T *p, std::size_t n, T v) {    \
+        return find_kernel<T, BYTES>(p, n, v);                                           \
+    }                                                                                    \
+    template <typename T>                                                                \
+    [[gnu::target(TARGET)]] std::size_t count_##NAME(const T *p, std::size_t n, T v) {   \
+        return count_kernel<T, BYTES>(p, n, v);                                          \
+    }                                                                                    \
+    template <typename T>                                                                \
+    [[gnu::target(TARGET)]] T min_##NAME(const T *p, std::size_t n) {                    \
+        return minmax_kernel<T, BYTES, true>(p, n);                                      \
+    }                                                                                    \
+    template <typename T>                                                                \
+    [[gnu::target(TARGET)]] T max_##NAME(const T *p, std::size_t n) {                    \
+        return minmax_kernel<T, BYTES, false>(p, n);                                     \
+    }                                                                                    \
+    template <typename T>                                                                \
+    [[gnu::target(TARGET)]] sum_type<T> sum_##NAME(const T *p, std::size_t n) {          \
+        return sum_kernel<T, BYTES>(p, n);                                               \
+    }
+
+ZSTL_SIMD_DEFINE_LEVEL(sse2, "sse2", 16uz)
+ZSTL_SIMD_DEFINE_LEVEL(avx2, "avx2", 32uz)
+ZSTL_SIMD_DEFINE_LEVEL(avx512, "avx512f,avx512bw,avx512dq,avx512vl", 64uz)
+
+#undef ZSTL_SIMD_DEFINE_LEVEL
+
+#pragma GCC diagnostic pop
+
+#endif // x86
+
+
+template <typename T>
+struct kernel_table {
+    std::size_t (*find)(const T *, std::size_t, T);
+    std::size_t (*count)(const T *, std::size_t, T);
+    T (*min)(const T *, std::size_t);
+    T (*max)(const T *, std::size_t);
+    sum_type<T> (*sum)(const T *, std::size_t);
+};
+
+template <typename T>
+const kernel_table<T> &kernels(level l) noexcept {
+    static constexpr kernel_table<T> scalar {
+        find_scalar<T>, count_scalar<T>, min_scalar<T>, max_scalar<T>, sum_scalar<T>
+    };
+#ifdef ZSTL_SIMD_X86
+    static constexpr kernel_table<T> sse2 {
+        find_sse2<T>, count_sse2<T>, min_sse2<T>, max_sse2<T>, sum_sse2<T>
+    };
+    static constexpr kernel_table<T> avx2 {
+        find_avx2<T>, count_avx2<T>, min_avx2<T>, max_avx2<T>, sum_avx2<T>
+    };
+    static constexpr kernel_table<T> avx512 {
+        find_avx512<T>, count_avx512<T>, min_avx512<T>, max_avx512<T>, sum_avx512<T>
+    };
+
+    // never run code the CPU cannot execute, whatever the caller asked for
+    if (l > detected_level()) {
+        l = detected_level();
+    }
+    switch (l) {
+        case level::sse2: return sse2;
+        case level::avx2: return avx2;
+        case level::avx512: return avx512;
+        case level::scalar: break;
+    }
+#else
+    (void)l;
+#endif
+    return scalar;
+}
+
+} // namespace detail end
+
+
+// Index of the first element equal to `value`, or size() when there is none
+template <std::ranges::contiguous_range Range>
+    requires kernel_type<std::ranges::range_value_t<Range>>
+std::size_t find(
+    const Range &range,
+    std::ranges::range_value_t<Range> value,
+    level l = detected_level()
+) {
+    using T = std::ranges::range_value_t<Range>;
+    return detail::kernels<T>(l).find(std::ranges::data(range), std::ranges::size(range), value);
+}
+
+template <std::ranges::contiguous_range Range>
+    requires kernel_type<std::ranges::range_value_t<Range>>
+std::size_t count(
+    const Range &range,
+    std::ranges::range_value_t<Range> value,
+    level l = detected_level()
+) {
+    using T = std::ranges::range_value_t<Range>;
+    return detail::kernels<T>(l).count(std::ranges::data(range), std::ranges::size(range), value);
+}
+
+template <std::ranges::contiguous_range Range>
+    requires kernel_type<std::ranges::range_value_t<Range>>
+std::ranges::range_value_t<Range> min(const Range &range, level l = detected_level()) {
+    using T = std::ranges::range_value_t<Range>;
+    return detail::kernels<T>(l).min(std::ranges::data(range), std::ranges::size(range));
+}
+
+template <std::ranges::contiguous_range Range>
+    requires kernel_type<std::ranges::range_value_t<Range>>
+std::ranges::range_value_t<Range> max(const Range &range, level l = detected_level()) {
+    using T = std::ranges::range_value_t<Range>;
+    return detail::kernels<T>(l).max(std::ranges::data(range), std::ranges::size(range));
+}
+
+template <std::ranges::contiguous_range Range>
+    requires kernel_type<std::ranges::range_value_t<Range>>
+sum_type<std::ranges::range_value_t<Range>> sum(const Range &range, level l = detected_level()) {
+    using T = std::ranges::range_value_t<Range>;
+    return detail::kernels<T>(l).sum(std::ranges::data(range), std::ranges::size(range));
+}
+
+} // namespace zstl::simd end
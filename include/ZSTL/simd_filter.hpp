@@ -0,0 +1,311 @@
+#pragma once
+
+#include "vector.hpp"
+#include "simd.hpp" // zstl::simd::level, zstl::simd::detail::vec_t
+
+#include <bit> // std::popcount
+#include <array>
+#include <limits>
+#include <ranges>
+#include <cstdint>
+#include <cstddef>
+#include <stdexcept>
+#include <concepts>
+#include <type_traits>
+
+#ifdef ZSTL_SIMD_X86
+#include <immintrin.h>
+#endif
+
+
+// SIMD stream compaction into `zstl::vector`:
+//   filter_into(src, dst, pred) appends the elements of src that satisfy pred,
+//   filter_indices_into(src, dst, pred) appends their positions instead
+// The comparison predicates below (greater{t}, between{lo, hi}, ...) are evaluated
+//   a whole register at a time; any other callable runs element by element
+// Every block of lanes is compared, its mask compressed (vpcompress on AVX-512, a
+//   permutation table + vpermd on AVX2) and stored unconditionally at the output
+//   cursor, which then advances by the popcount of the mask, so there is no branch
+//   per element. SSE2 has no variable lane shuffle and uses the branch-free scalar
+//   loop. The destination grows once, by src.size(), and is trimmed at the end
+namespace zstl::simd {
+
+// filter_indices_into writes positions as unsigned integers as wide as the elements
+template <typename T>
+using index_type = std::conditional_t<sizeof(T) == 4uz, std::uint32_t, std::uint64_t>;
+
+
+// Comparison predicates recognized by the vector kernels, e.g. greater{threshold};
+//   called on a single element they behave like the std:: function objects
+enum class compare_op {
+    equal_to,
+    not_equal_to,
+    less,
+    less_equal,
+    greater,
+    greater_equal,
+    between
+};
+
+#define ZSTL_SIMD_DEFINE_PREDICATE(NAME, OP)                                      \
+    template <typename T>                                                         \
+    struct NAME {                                                                 \
+        static constexpr compare_op op = compare_op::NAME;                        \
+        T value;                                                                  \
+        constexpr bool operator()(T x) const noexcept {                           \
+            return x OP this->value;                                              \
+        }                                                                         \
+    };
+
+ZSTL_SIMD_DEFINE_PREDICATE(equal_to, ==)
+ZSTL_SIMD_DEFINE_PREDICATE(not_equal_to, !=)
+ZSTL_SIMD_DEFINE_PREDICATE(less, <)
+ZSTL_SIMD_DEFINE_PREDICATE(less_equal, <=)
+ZSTL_SIMD_DEFINE_PREDICATE(greater, >)
+ZSTL_SIMD_DEFINE_PREDICATE(greater_equal, >=)
+
+#undef ZSTL_SIMD_DEFINE_PREDICATE
+
+// lo <= x && x <= hi
+template <typename T>
+struct between {
+    static constexpr compare_op op = compare_op::between;
+    T lo;
+    T hi;
+    constexpr bool operator()(T x) const noexcept {
+        return this->lo <= x && x <= this->hi;
+    }
+};
+
+
+namespace detail {
+
+// Every element is written, only the survivors advance the cursor; writing at
+//   out[k] with k <= i never leaves the n slots reserved for the output
+template <bool Indices, typename T, typename Out, typename Pred>
+std::size_t filter_scalar(const T *p, std::size_t n, std::size_t base, Out *out, Pred &pred) {
+    std::size_t k { 0uz };
+    for (std::size_t i { 0uz }; i < n; ++i) {
+        if constexpr (Indices) {
+            out[k] = static_cast<Out>(base + i);
+        } else {
+            out[k] = p[i];
+        }
+        k += static_cast<bool>(pred(p[i]));
+    }
+    return k;
+}
+
+
+#ifdef ZSTL_SIMD_X86
+
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wpsabi"
+
+template <typename Pred>
+concept vector_predicate = requires {
+    { Pred::op } -> std::convertible_to<compare_op>;
+};
+
+template <typename V>
+using mask_t = decltype(V {} == V {});
+
+// lane mask (all ones where true) of `pred` applied to every lane of `x`;
+//   returned through `m` so that no vector crosses a function boundary by value
+template <typename Pred, typename V>
+[[gnu::always_inline]] inline void lane_mask(const Pred &pred, const V &x, mask_t<V> &m) noexcept {
+    if constexpr (Pred::op == compare_op::equal_to) {
+        m = x == pred.value;
+    } else if constexpr (Pred::op == compare_op::not_equal_to) {
+        m = x != pred.value;
+    } else if constexpr (Pred::op == compare_op::less) {
+        m = x < pred.value;
+    } else if constexpr (Pred::op == compare_op::less_equal) {
+        m = x <= pred.value;
+    } else if constexpr (Pred::op == compare_op::greater) {
+        m = x > pred.value;
+    } else if constexpr (Pred::op == compare_op::greater_equal) {
+        m = x >= pred.value;
+    } else {
+        // masks are summed rather than and-ed: GCC scalarizes an AND of 512-bit compares
+        m = x >= pred.lo;
+        m += x <= pred.hi;
+        m = m == -2;
+    }
+}
+
+// vpermd indices that move the lanes selected by each mask to the front;
+//   64-bit lanes are moved as pairs of 32-bit lanes
+template <std::size_t Lanes>
+struct compress_table {
+    alignas(32) std::uint32_t perm[1uz << Lanes][8];
+};
+
+template <std::size_t Lanes>
+constexpr compress_table<Lanes> make_compress_table() {
+    constexpr std::size_t WIDTH = 8uz / Lanes;
+    compress_table<Lanes> table {};
+    for (std::size_t mask { 0uz }; mask < (1uz << Lanes); ++mask) {
+        std::size_t k { 0uz };
+        for (std::size_t lane { 0uz }; lane < Lanes; ++lane) {
+            if (mask & (1uz << lane)) {
+                for (std::size_t w { 0uz }; w < WIDTH; ++w) {
+                    table.perm[mask][k * WIDTH + w] = static_cast<std::uint32_t>(lane * WIDTH + w);
+                }
+                ++k;
+            }
+        }
+        // the tail lanes are stored too but overwritten later; keep them in range
+        for (std::size_t slot = k * WIDTH; slot < 8uz; ++slot) {
+            table.perm[mask][slot] = 0u;
+        }
+    }
+    return table;
+}
+
+template <std::size_t Lanes>
+inline constexpr compress_table<Lanes> COMPRESS_TABLE = make_compress_table<Lanes>();
+
+template <typename Out, std::size_t Bytes>
+[[gnu::always_inline]] inline vec_t<Out, Bytes> lane_indices() noexcept {
+    vec_t<Out, Bytes> idx {};
+    for (std::size_t lane { 0uz }; lane < Bytes / sizeof(Out); ++lane) {
+        idx[lane] = static_cast<Out>(lane);
+    }
+    return idx;
+}
+
+template <bool Indices, typename T, typename Out, typename Pred>
+[[gnu::target("avx2")]] std::size_t filter_avx2(const T *p, std::size_t n, Out *out, Pred &pred) {
+    using V = vec_t<T, 32uz>;
+    constexpr std::size_t L = 32uz / sizeof(T);
+    const vec_t<Out, 32uz> iota = lane_indices<Out, 32uz>();
+
+    std::size_t k { 0uz };
+    std::size_t i { 0uz };
+    for (; i + L <= n; i += L) {
+        V v = load<V>(p + i);
+        mask_t<V> m;
+        lane_mask(pred, v, m);
+        unsigned bits;
+        if constexpr (sizeof(T) == 4uz) {
+            bits = static_cast<unsigned>(_mm256_movemask_ps(__builtin_bit_cast(__m256, m)));
+        } else {
+            bits = static_cast<unsigned>(_mm256_movemask_pd(__builtin_bit_cast(__m256d, m)));
+        }
+
+        __m256i lanes;
+        if constexpr (Indices) {
+            lanes = __builtin_bit_cast(__m256i, iota + static_cast<Out>(i));
+        } else {
+            lanes = __builtin_bit_cast(__m256i, v);
+        }
+        __m256i perm = _mm256_load_si256(reinterpret_cast<const __m256i *>(COMPRESS_TABLE<L>.perm[bits]));
+        _mm256_storeu_si256(reinterpret_cast<__m256i *>(out + k), _mm256_permutevar8x32_epi32(lanes, perm));
+        k += static_cast<std::size_t>(std::popcount(bits));
+    }
+    return k + filter_scalar<Indices>(p + i, n - i, i, out + k, pred);
+}
+
+template <bool Indices, typename T, typename Out, typename Pred>
+[[gnu::target("avx512f,avx512bw,avx512dq,avx512vl")]]
+std::size_t filter_avx512(const T *p, std::size_t n, Out *out, Pred &pred) {
+    using V = vec_t<T, 64uz>;
+    constexpr std::size_t L = 64uz / sizeof(T);
+    const vec_t<Out, 64uz> iota = lane_indices<Out, 64uz>();
+
+    std::size_t k { 0uz };
+    std::size_t i { 0uz };
+    for (; i + L <= n; i += L) {
+        V v = load<V>(p + i);
+        mask_t<V> mv;
+        lane_mask(pred, v, mv);
+        __m512i m = __builtin_bit_cast(__m512i, mv);
+
+        __m512i lanes;
+        if constexpr (Indices) {
+            lanes = __builtin_bit_cast(__m512i, iota + static_cast<Out>(i));
+        } else {
+            lanes = __builtin_bit_cast(__m512i, v);
+        }
+        if constexpr (sizeof(T) == 4uz) {
+            __mmask16 bits = _mm512_movepi32_mask(m);
+            _mm512_storeu_si512(out + k, _mm512_maskz_compress_epi32(bits, lanes));
+            k += static_cast<std::size_t>(std::popcount(static_cast<unsigned>(bits)));
+        } else {
+            __mmask8 bits = _mm512_movepi64_mask(m);
+            _mm512_storeu_si512(out + k, _mm512_maskz_compress_epi64(bits, lanes));
+            k += static_cast<std::size_t>(std::popcount(static_cast<unsigned>(bits)));
+        }
+    }
+    return k + filter_scalar<Indices>(p + i, n - i, i, out + k, pred);
+}
+
+#pragma GCC diagnostic pop
+
+#endif // ZSTL_SIMD_X86
+
+
+template <bool Indices, typename T, typename Out, typename Alloc, typename Pred>
+std::size_t filter(const T *p, std::size_t n, zstl::vector<Out, Alloc> &dst, Pred &pred, level l) {
+    std::size_t base = dst.size();
+    // the only allocation: room for every element to survive
+    Out *out = dst.append_uninitialized(n).data();
+
+    std::size_t kept { 0uz };
+    if (l > detected_level()) {
+        l = detected_level();
+    }
+#ifdef ZSTL_SIMD_X86
+    if constexpr (vector_predicate<Pred>) {
+        if (l == level::avx512) {
+            kept = filter_avx512<Indices>(p, n, out, pred);
+        } else if (l == level::avx2) {
+            kept = filter_avx2<Indices>(p, n, out, pred);
+        } else {
+            kept = filter_scalar<Indices>(p, n, 0uz, out, pred);
+        }
+    } else {
+        kept = filter_scalar<Indices>(p, n, 0uz, out, pred);
+    }
+#else
+    kept = filter_scalar<Indices>(p, n, 0uz, out, pred);
+#endif
+
+    dst.resize_for_overwrite(base + kept);
+    return kept;
+}
+
+} // namespace detail end
+
+
+// Appends the elements of `src` for which `pred` holds to `dst`, in order,
+//   and returns how many were appended; `dst` must not alias `src`
+template <std::ranges::contiguous_range Range, typename Alloc, typename Pred>
+    requires kernel_type<std::ranges::range_value_t<Range>>
+std::size_t filter_into(
+    const Range &src,
+    zstl::vector<std::ranges::range_value_t<Range>, Alloc> &dst,
+    Pred pred,
+    level l = detected_level()
+) {
+    return detail::filter<false>(std::ranges::data(src), std::ranges::size(src), dst, pred, l);
+}
+
+// Appends the positions in `src` of the elements for which `pred` holds
+template <std::ranges::contiguous_range Range, typename Alloc, typename Pred>
+    requires kernel_type<std::ranges::range_value_t<Range>>
+std::size_t filter_indices_into(
+    const Range &src,
+    zstl::vector<index_type<std::ranges::range_value_t<Range>>, Alloc> &dst,
+    Pred pred,
+    level l = detected_level()
+) {
+    using Index = index_type<std::ranges::range_value_t<Range>>;
+    if (std::ranges::size(src) > std::numeric_limits<Index>::max()) [[unlikely]] {
+        throw std::length_error("zstl::simd::filter_indices_into");
+    }
+    return detail::filter<true>(std::ranges::data(src), std::ranges::size(src), dst, pred, l);
+}
+
+} // namespace zstl::simd end
@@ -0,0 +1,442 @@
+#pragma once
+
+#include "memory_resource.hpp"
+
+#include <span>
+#include <array>
+#include <tuple>
+#include <memory>
+#include <cstddef>
+#include <cstring>
+#include <utility>
+#include <stdexcept>
+#include <type_traits>
+
+
+// soa_vector
+// A structure-of-arrays container: each field `Ts` lives in its own column,
+//   so a kernel that touches one or two fields only streams those columns
+//   through the cache instead of whole records
+// All columns share a single allocation; each column starts on a
+//   `COLUMN_ALIGNMENT` boundary so column<I>() spans are ready for aligned SIMD loads
+// Rows are accessed through proxy references (`std::tuple<Ts&...>`)
+// Growth follows `zstl::vector`: 4 rows at first, then doubling
+namespace zstl {
+
+template <typename... Ts>
+    requires (sizeof...(Ts) > 0uz)
+class soa_vector {
+public:
+    using size_type = std::size_t;
+    using difference_type = std::ptrdiff_t;
+    using allocator_type = pmr::polymorphic_allocator<std::byte>;
+    using value_type = std::tuple<Ts...>;
+    using reference = std::tuple<Ts &...>;
+    using const_reference = std::tuple<const Ts &...>;
+
+    template <std::size_t I>
+    using column_type = std::tuple_element_t<I, std::tuple<Ts...>>;
+
+    static constexpr size_type COLUMN_ALIGNMENT { 64uz };
+    static constexpr size_type NUMBER_OF_COLUMNS { sizeof...(Ts) };
+
+private:
+    static_assert(
+        ((alignof(Ts) <= COLUMN_ALIGNMENT) && ...),
+        "soa_vector columns are aligned to COLUMN_ALIGNMENT bytes"
+    );
+
+    using column_pointers_type = std::array<void *, sizeof...(Ts)>;
+
+    // growth moves the rows when no column can throw doing so, and copies them
+    //   otherwise, so that a throw leaves the old block untouched
+    static constexpr bool NOTHROW_RELOCATE = (std::is_nothrow_move_constructible_v<Ts> && ...);
+
+    allocator_type alloc;
+    std::byte *block { nullptr };
+    column_pointers_type columns {};
+    size_type nAlloc { 0uz };
+    size_type nStored { 0uz };
+
+public:
+    // Constructor
+    soa_vector() noexcept(noexcept(allocator_type())) = default;
+
+    explicit soa_vector(const allocator_type &alloc) noexcept
+        : alloc(alloc)
+    {}
+
+    soa_vector(const soa_vector &other)
+        : alloc(other.alloc)
+    {
+        this->reserve(other.size());
+        for (size_type i { 0uz }; i < other.size(); ++i) {
+            this->push_back(other.row_values(i));
+        }
+    }
+
+    soa_vector(soa_vector &&other) noexcept
+        : alloc(other.alloc)
+        , block(other.block)
+        , columns(other.columns)
+        , nAlloc(other.nAlloc)
+        , nStored(other.nStored)
+    {
+        other.block = nullptr;
+        other.columns = {};
+        other.nAlloc = 0uz;
+        other.nStored = 0uz;
+    }
+
+    soa_vector &operator=(const soa_vector &) = delete;
+    soa_vector &operator=(soa_vector &&) = delete;
+
+    // Destructor
+    ~soa_vector() {
+        this->clear();
+        this->alloc.deallocate_bytes(this->block, block_bytes(this->nAlloc), COLUMN_ALIGNMENT);
+    }
+
+    allocator_type get_allocator() const noexcept {
+        return this->alloc;
+    }
+
+    // Column access
+    template <std::size_t I>
+    column_type<I> *column_data() noexcept {
+        return static_cast<column_type<I> *>(std::get<I>(this->columns));
+    }
+
+    template <std::size_t I>
+    const column_type<I> *column_data() const noexcept {
+        return static_cast<const column_type<I> *>(std::get<I>(this->columns));
+    }
+
+    template <std::size_t I>
+    std::span<column_type<I>> column() noexcept {
+        return { this->column_data<I>(), this->nStored };
+    }
+
+    template <std::size_t I>
+    std::span<const column_type<I>> column() const noexcept {
+        return { this->column_data<I>(), this->nStored };
+    }
+
+    // Row access
+    reference operator[](size_type index) noexcept {
+        return this->row(index, std::index_sequence_for<Ts...> {});
+    }
+
+    const_reference operator[](size_type index) const noexcept {
+        return this->row(index, std::index_sequence_for<Ts...> {});
+    }
+
+    reference at(size_type index) {
+        if (index >= this->nStored) [[unlikely]] {
+            throw std::out_of_range("soa_vector::at");
+        }
+
+        return (*this)[index];
+    }
+
+    const_reference at(size_type index) const {
+        if (index >= this->nStored) [[unlikely]] {
+            throw std::out_of_range("soa_vector::at");
+        }
+
+        return (*this)[index];
+    }
+
+    reference front() noexcept {
+        return (*this)[0uz];
+    }
+
+    const_reference front() const noexcept {
+        return (*this)[0uz];
+    }
+
+    reference back() noexcept {
+        return (*this)[this->nStored - 1uz];
+    }
+
+    const_reference back() const noexcept {
+        return (*this)[this->nStored - 1uz];
+    }
+
+    // Capacity
+    bool empty() const noexcept {
+        return this->nStored == 0uz;
+    }
+
+    size_type size() const noexcept {
+        return this->nStored;
+    }
+
+    size_type capacity() const noexcept {
+        return this->nAlloc;
+    }
+
+    void reserve(size_type n) {
+        if (n <= this->nAlloc) { return ; }
+
+        std::byte *newBlock = static_cast<std::byte *>(
+            this->alloc.allocate_bytes(block_bytes(n), COLUMN_ALIGNMENT)
+        );
+        column_pointers_type newColumns = column_pointers(newBlock, n);
+        try {
+            this->relocate(newColumns);
+        } catch (...) {
+            this->alloc.deallocate_bytes(newBlock, block_bytes(n), COLUMN_ALIGNMENT);
+            throw;
+        }
+        this->adopt(newBlock, newColumns, n);
+    }
+
+    // Modifiers
+    void clear() noexcept {
+        [&]<std::size_t... Is>(std::index_sequence<Is...>) {
+            (this->destroy_column<Is>(0uz, this->nStored), ...);
+        }(std::index_sequence_for<Ts...> {});
+        this->nStored = 0uz;
+    }
+
+    void push_back(const Ts &...values) {
+        this->emplace_back(values...);
+    }
+
+    void push_back(Ts &&...values) {
+        this->emplace_back(std::move(values)...);
+    }
+
+    void push_back(const value_type &values) {
+        std::apply(
+            [this](const Ts &...fields) {
+                this->emplace_back(fields...);
+            },
+            values
+        );
+    }
+
+    // one constructor argument per column
+    template <class... Args>
+        requires (sizeof...(Args) == sizeof...(Ts))
+    reference emplace_back(Args &&...args) {
+        if (this->nStored != this->nAlloc) [[likely]] {
+            construct_row(this->columns, this->nStored, std::forward<Args>(args)...);
+            ++(this->nStored);
+            return this->back();
+        }
+
+        // the arguments may refer to rows of this vector (v.push_back(v[0])), so the
+        //   new row is built in the new block before the old rows leave the old one
+        size_type n = this->nAlloc == 0uz ? 4uz : 2uz * this->nAlloc;
+        std::byte *newBlock = static_cast<std::byte *>(
+            this->alloc.allocate_bytes(block_bytes(n), COLUMN_ALIGNMENT)
+        );
+        column_pointers_type newColumns = column_pointers(newBlock, n);
+        try {
+            construct_row(newColumns, this->nStored, std::forward<Args>(args)...);
+        } catch (...) {
+            this->alloc.deallocate_bytes(newBlock, block_bytes(n), COLUMN_ALIGNMENT);
+            throw;
+        }
+        try {
+            this->relocate(newColumns);
+        } catch (...) {
+            destroy_row(newColumns, this->nStored);
+            this->alloc.deallocate_bytes(newBlock, block_bytes(n), COLUMN_ALIGNMENT);
+            throw;
+        }
+        this->adopt(newBlock, newColumns, n);
+        ++(this->nStored);
+
+        return this->back();
+    }
+
+    void pop_back() {
+        // DCHECK(!empty());
+        [&]<std::size_t... Is>(std::index_sequence<Is...>) {
+            (this->destroy_column<Is>(this->nStored - 1uz, this->nStored), ...);
+        }(std::index_sequence_for<Ts...> {});
+        --(this->nStored);
+    }
+
+    // Removes rows [first, last), shifting the following rows down in every column;
+    //   returns the index of the row that now follows the erased range
+    size_type erase(size_type first, size_type last) {
+        // DCHECK_LE(first, last);
+        // DCHECK_LE(last, size());
+        if (first == last) {
+            return first;
+        }
+
+        [&]<std::size_t... Is>(std::index_sequence<Is...>) {
+            (this->shift_column_down<Is>(first, last), ...);
+        }(std::index_sequence_for<Ts...> {});
+        this->nStored -= last - first;
+
+        return first;
+    }
+
+    size_type erase(size_type index) {
+        return this->erase(index, index + 1uz);
+    }
+
+    void swap(soa_vector &other) noexcept {
+        // polymorphic_allocator is not assignable: rebuild each one in place
+        allocator_type tmp(this->alloc);
+        std::destroy_at(&this->alloc);
+        std::construct_at(&this->alloc, other.alloc);
+        std::destroy_at(&other.alloc);
+        std::construct_at(&other.alloc, tmp);
+
+        std::swap(this->block, other.block);
+        std::swap(this->columns, other.columns);
+        std::swap(this->nAlloc, other.nAlloc);
+        std::swap(this->nStored, other.nStored);
+    }
+
+private:
+    static constexpr size_type align_up(size_type n) noexcept {
+        return (n + COLUMN_ALIGNMENT - 1uz) & ~(COLUMN_ALIGNMENT - 1uz);
+    }
+
+    static constexpr size_type block_bytes(size_type n) noexcept {
+        return ((align_up(n * sizeof(Ts))) + ... + 0uz);
+    }
+
+    static column_pointers_type column_pointers(std::byte *base, size_type n) noexcept {
+        column_pointers_type result {};
+        size_type offset { 0uz };
+        size_type k { 0uz };
+        ((result[k++] = base + offset, offset += align_up(n * sizeof(Ts))), ...);
+
+        return result;
+    }
+
+    template <std::size_t... Is>
+    reference row(size_type index, std::index_sequence<Is...>) noexcept {
+        return reference(this->column_data<Is>()[index]...);
+    }
+
+    template <std::size_t... Is>
+    const_reference row(size_type index, std::index_sequence<Is...>) const noexcept {
+        return const_reference(this->column_data<Is>()[index]...);
+    }
+
+    value_type row_values(size_type index) const {
+        return value_type((*this)[index]);
+    }
+
+    template <std::size_t I>
+    static column_type<I> *column_in(const column_pointers_type &cols) noexcept {
+        return static_cast<column_type<I> *>(cols[I]);
+    }
+
+    // Builds row `index` of `cols` from one argument per column, left to right; if
+    //   one constructor throws, the fields already built are destroyed
+    template <class... Args>
+    static void construct_row(const column_pointers_type &cols, size_type index, Args &&...args) {
+        size_type nBuilt { 0uz };
+        try {
+            [&]<std::size_t... Is>(std::index_sequence<Is...>) {
+                ((::new (static_cast<void *>(column_in<Is>(cols) + index))
+                    column_type<Is>(std::forward<Args>(args)), ++nBuilt), ...);
+            }(std::index_sequence_for<Ts...> {});
+        } catch (...) {
+            [&]<std::size_t... Is>(std::index_sequence<Is...>) {
+                ((Is < nBuilt ? std::destroy_at(column_in<Is>(cols) + index) : void()), ...);
+            }(std::index_sequence_for<Ts...> {});
+            throw;
+        }
+    }
+
+    static void destroy_row(const column_pointers_type &cols, size_type index) noexcept {
+        [&]<std::size_t... Is>(std::index_sequence<Is...>) {
+            (std::destroy_at(column_in<Is>(cols) + index), ...);
+        }(std::index_sequence_for<Ts...> {});
+    }
+
+    // Moves or copies the rows into `newColumns`, see NOTHROW_RELOCATE; if a copy
+    //   throws, what was built in `newColumns` is destroyed and the rows stay put
+    void relocate(const column_pointers_type &newColumns) {
+        size_type nDone { 0uz };
+        try {
+            [&]<std::size_t... Is>(std::index_sequence<Is...>) {
+                ((this->relocate_column<Is>(column_in<Is>(newColumns)), ++nDone), ...);
+            }(std::index_sequence_for<Ts...> {});
+        } catch (...) {
+            [&]<std::size_t... Is>(std::index_sequence<Is...>) {
+                ((Is < nDone ? static_cast<void>(std::destroy_n(column_in<Is>(newColumns), this->nStored)) : void()), ...);
+            }(std::index_sequence_for<Ts...> {});
+            throw;
+        }
+
+        if constexpr (!NOTHROW_RELOCATE) {
+            [&]<std::size_t... Is>(std::index_sequence<Is...>) {
+                (this->destroy_column<Is>(0uz, this->nStored), ...);
+            }(std::index_sequence_for<Ts...> {});
+        }
+    }
+
+    template <std::size_t I>
+    void relocate_column(column_type<I> *dst) {
+        using T = column_type<I>;
+        T *src = this->column_data<I>();
+        if constexpr (std::is_trivially_copyable_v<T>) {
+            if (this->nStored != 0uz) {
+                std::memcpy(static_cast<void *>(dst), src, this->nStored * sizeof(T));
+            }
+        } else if constexpr (NOTHROW_RELOCATE) {
+            for (size_type i { 0uz }; i < this->nStored; ++i) {
+                ::new (static_cast<void *>(dst + i)) T(std::move(src[i]));
+                src[i].~T();
+            }
+        } else {
+            // the source rows are destroyed by relocate() once every column is copied
+            size_type i { 0uz };
+            try {
+                for (; i < this->nStored; ++i) {
+                    if constexpr (std::is_copy_constructible_v<T>) {
+                        ::new (static_cast<void *>(dst + i)) T(std::as_const(src[i]));
+                    } else {
+                        ::new (static_cast<void *>(dst + i)) T(std::move(src[i]));
+                    }
+                }
+            } catch (...) {
+                std::destroy_n(dst, i);
+                throw;
+            }
+        }
+    }
+
+    void adopt(std::byte *newBlock, const column_pointers_type &newColumns, size_type n) noexcept {
+        this->alloc.deallocate_bytes(this->block, block_bytes(this->nAlloc), COLUMN_ALIGNMENT);
+        this->block = newBlock;
+        this->columns = newColumns;
+        this->nAlloc = n;
+    }
+
+    template <std::size_t I>
+    void destroy_column(size_type first, size_type last) noexcept {
+        using T = column_type<I>;
+        if constexpr (!std::is_trivially_destructible_v<T>) {
+            T *data = this->column_data<I>();
+            for (size_type i = first; i < last; ++i) {
+                data[i].~T();
+            }
+        }
+    }
+
+    template <std::size_t I>
+    void shift_column_down(size_type first, size_type last) {
+        column_type<I> *data = this->column_data<I>();
+        size_type dst = first;
+        for (size_type src = last; src < this->nStored; ++src, ++dst) {
+            data[dst] = std::move(data[src]);
+        }
+        this->destroy_column<I>(dst, this->nStored);
+    }
+};
+
+} // namespace zstl end
@@ -0,0 +1,255 @@
+#pragma once
+
+#include "memory_resource.hpp"
+#include "tagged_ptr.hpp"
+
+#include <bit>
+#include <new>
+#include <cstddef>
+#include <cstdint>
+#include <utility>
+#include <algorithm>
+#include <stdexcept>
+
+
+// tagged_handle
+// A `tagged_ptr<Ts...>` in 4 bytes instead of 8: the type tag plus the offset of
+//   the object from the base of a tagged_arena, so collections of hundreds of
+//   millions of handles take half the memory and twice as many fit in a cache line
+//   [ tag : bit_width(sizeof...(Ts)) | offset / GRANULE : the remaining bits ]
+// The offset is counted in GRANULE bytes (the largest alignof(Ts)), so with three
+//   8-byte aligned types a handle reaches 8 GiB of arena
+// A handle does not know its arena: call/cast/get take it as an argument
+//   zstl::tagged_arena arena(1uz << 30);
+//   auto h = zstl::tagged_handle<Circle, Rectangle>::make<Circle>(arena, 2.0);
+//   double area = h.call(arena, [](const auto *s) { return s->get_area(); });
+namespace zstl {
+
+// tagged_arena
+// One contiguous region of `capacity` bytes, taken from `upstream` up front and
+//   handed out by a monotonic_buffer_resource that never goes past it (bad_alloc
+//   when full); its start is the base tagged_handle offsets are relative to
+// The base is aligned to at least BASE_ALIGNMENT; handles of types aligned beyond
+//   that need an arena built with their alignment, see tagged_handle::GRANULE
+// Like monotonic_buffer_resource, the arena frees its memory at once and does not
+//   run destructors
+class tagged_arena {
+public:
+    static constexpr std::size_t BASE_ALIGNMENT { 64uz };
+
+private:
+    pmr::memory_resource *upstream;
+    std::size_t nBytes;
+    std::size_t baseAlignment;
+    std::byte *base;
+    pmr::monotonic_buffer_resource buffer;
+
+public:
+    // Constructor
+    explicit tagged_arena(
+        std::size_t capacity,
+        pmr::memory_resource *upstream = pmr::get_default_resource(),
+        std::size_t alignment = BASE_ALIGNMENT
+    )
+        : upstream(upstream)
+        , nBytes(capacity)
+        , baseAlignment(std::max(BASE_ALIGNMENT, alignment))
+        , base(static_cast<std::byte *>(upstream->allocate(capacity, this->baseAlignment)))
+        , buffer(this->base, capacity, pmr::null_memory_resource())
+    {}
+
+    tagged_arena(const tagged_arena &) = delete;
+    tagged_arena &operator=(const tagged_arena &) = delete;
+
+    // Destructor
+    ~tagged_arena() {
+        this->buffer.release();
+        this->upstream->deallocate(this->base, this->nBytes, this->baseAlignment);
+    }
+
+    void *allocate(std::size_t bytes, std::size_t alignment = alignof(std::max_align_t)) {
+        return this->buffer.allocate(bytes, alignment);
+    }
+
+    // Forgets every allocation; handles into the arena become dangling
+    void release() {
+        this->buffer.release();
+    }
+
+    pmr::memory_resource *resource() noexcept {
+        return &this->buffer;
+    }
+
+    std::byte *data() noexcept {
+        return this->base;
+    }
+
+    const std::byte *data() const noexcept {
+        return this->base;
+    }
+
+    std::size_t capacity() const noexcept {
+        return this->nBytes;
+    }
+
+    // The alignment of data()
+    std::size_t alignment() const noexcept {
+        return this->baseAlignment;
+    }
+
+    bool contains(const void *p) const noexcept {
+        const std::byte *q = static_cast<const std::byte *>(p);
+        return q >= this->base && q < this->base + this->nBytes;
+    }
+};
+
+
+template <typename... Ts>
+class tagged_handle {
+public:
+    using value_type = std::uint32_t;
+    using pointer = tagged_ptr<Ts...>;
+
+    static constexpr std::size_t TAG_BITS = std::bit_width(sizeof...(Ts));
+    static constexpr std::size_t OFFSET_BITS = 32uz - TAG_BITS;
+    static constexpr std::size_t GRANULE = std::max({ alignof(Ts)... });
+
+private:
+    static_assert(TAG_BITS < 16uz, "tagged_handle: too many types for a 32-bit handle");
+
+    static constexpr value_type OFFSET_MASK = (value_type { 1u } << OFFSET_BITS) - 1u;
+
+    value_type word { 0u };
+
+    std::size_t offset() const noexcept {
+        return static_cast<std::size_t>(this->word & OFFSET_MASK) * GRANULE;
+    }
+
+public:
+    // Constructor
+    tagged_handle() = default;
+
+    tagged_handle(std::nullptr_t) noexcept
+    {}
+
+    // The handle of `ptr`, which must point into `arena` at a multiple of GRANULE
+    template <typename T>
+        requires contain_type<T, Ts...>
+    tagged_handle(const tagged_arena &arena, const T *ptr) {
+        std::size_t off = static_cast<std::size_t>(
+            reinterpret_cast<const std::byte *>(ptr) - arena.data()
+        );
+        // DCHECK(arena.contains(ptr));
+        // DCHECK_EQ(off % GRANULE, 0u);
+        if (off / GRANULE > OFFSET_MASK) [[unlikely]] {
+            throw std::out_of_range("tagged_handle: object beyond the reach of a 32-bit offset");
+        }
+        this->word = static_cast<value_type>(get_type_tag<T>() << OFFSET_BITS)
+            | static_cast<value_type>(off / GRANULE);
+    }
+
+    // A T constructed from `args` in `arena`; offsets count GRANULEs from the base,
+    //   so for types aligned beyond BASE_ALIGNMENT the arena must be built with
+    //   an alignment of at least GRANULE
+    template <typename T, typename... Args>
+        requires contain_type<T, Ts...>
+    static tagged_handle make(tagged_arena &arena, Args &&...args) {
+        if constexpr (GRANULE > tagged_arena::BASE_ALIGNMENT) {
+            if (arena.alignment() < GRANULE) [[unlikely]] {
+                throw std::invalid_argument("tagged_handle::make: arena base less aligned than GRANULE");
+            }
+        }
+        T *obj = static_cast<T *>(arena.allocate(sizeof(T), GRANULE));
+        ::new (static_cast<void *>(obj)) T(std::forward<Args>(args)...);
+        return tagged_handle(arena, obj);
+    }
+
+    // Bytes of arena a handle can address
+    static constexpr std::size_t max_arena_size() {
+        return (std::size_t { OFFSET_MASK } + 1uz) * GRANULE;
+    }
+
+    friend bool operator==(const tagged_handle &, const tagged_handle &) = default;
+
+    template <typename T>
+        requires contain_type<T, std::nullptr_t, Ts...>
+    static constexpr std::size_t get_type_tag() {
+        return type_index_v<T, std::nullptr_t, Ts...>;
+    }
+
+    auto tag() const {
+        return static_cast<std::uint64_t>(this->word >> OFFSET_BITS);
+    }
+
+    template <typename T>
+        requires contain_type<T, Ts...>
+    bool points_to_type() const {
+        return tag() == get_type_tag<T>();
+    }
+
+    void *ptr(tagged_arena &arena) const {
+        return arena.data() + this->offset();
+    }
+
+    const void *ptr(const tagged_arena &arena) const {
+        return arena.data() + this->offset();
+    }
+
+    template <typename T>
+        requires contain_type<T, Ts...>
+    T *cast(tagged_arena &arena) const {
+        return points_to_type<T>()
+            ? static_cast<T *>(ptr(arena))
+            : nullptr;
+    }
+
+    template <typename T>
+        requires contain_type<T, Ts...>
+    const T *cast(const tagged_arena &arena) const {
+        return points_to_type<T>()
+            ? static_cast<const T *>(ptr(arena))
+            : nullptr;
+    }
+
+    template <typename Func>
+    decltype(auto) call(tagged_arena &arena, Func &&func) const {
+        return detail::tagged_ptr::dispatch<Func, void *, Ts...>(
+            std::forward<Func>(func),
+            ptr(arena),
+            tag() - 1uz
+        );
+    }
+
+    template <typename Func>
+    decltype(auto) call(const tagged_arena &arena, Func &&func) const {
+        return detail::tagged_ptr::dispatch<Func, const void *, Ts...>(
+            std::forward<Func>(func),
+            ptr(arena),
+            tag() - 1uz
+        );
+    }
+
+    // The full 8-byte tagged_ptr
+    pointer get(const tagged_arena &arena) const {
+        if (tag() == 0u) {
+            return nullptr;
+        }
+        return call(arena, [](const auto *p) { return pointer(p); });
+    }
+
+    value_type raw() const {
+        return this->word;
+    }
+
+    static tagged_handle from_raw(value_type word) {
+        tagged_handle h;
+        h.word = word;
+        return h;
+    }
+
+    static constexpr auto number_of_types() {
+        return sizeof...(Ts);
+    }
+};
+
+} // namespace zstl end
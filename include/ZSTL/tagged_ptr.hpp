@@ -5,7 +5,20 @@
 #include <cstddef> // std::size_t
 #include <cstdint> // std::uintptr_t, std::uint64_t
 #include <utility> // std::forward
-#include <type_traits> // std::integral_constant
+#include <type_traits> // std::integral_constant, std::invoke_result_t
+#include <bit> // std::countr_zero
+#include <algorithm> // std::min
+#include <array> // std::array
+#include <tuple> // std::tuple_element_t
+#include <stdexcept> // std::runtime_error
+
+#if defined(__linux__)
+#include <sys/mman.h> // mmap, munmap
+#endif
+
+#if defined(ZSTL_TAGGED_PTR_PROFILE)
+#include <ZSTL/dispatch_profile.hpp> // zstl::dispatch_profile
+#endif
 
 
 namespace zstl {
@@ -80,46 +93,247 @@ auto dispatch_call(
     }
 }
 
-}; // namespace detail::tagged_ptr end
 
+// Up to this many types `call` keeps the switch chain above: once inlined it is a
+//   couple of compares (or a jump table) that the optimizer can see through.
+//   Beyond it the chain is O(number of types) compares deep and stops being
+//   inlined, so `call` indexes a table of per-type thunks with the tag instead
+inline constexpr std::size_t SWITCH_DISPATCH_MAX { 8uz };
 
-// tagged_ptr
+// `T *` or `const T *`, following the constness of `VoidPtr`
+template <typename T, typename VoidPtr>
+using pointer_like_t = std::conditional_t<
+    std::is_const_v<std::remove_pointer_t<VoidPtr>>,
+    const T *,
+    T *
+>;
+
+// Same result type as the switch form: what `func` returns for the first type, by value
+template <typename Func, typename VoidPtr, typename T0, typename... Ts>
+struct call_result {
+    using type = std::remove_cvref_t<
+        std::invoke_result_t<Func &, pointer_like_t<T0, VoidPtr>>
+    >;
+};
+
+template <typename R, typename Func, typename T, typename VoidPtr>
+R call_thunk(Func &func, VoidPtr ptr) {
+    return func(static_cast<pointer_like_t<T, VoidPtr>>(ptr));
+}
+
+template <typename Func, typename VoidPtr, typename... Ts>
+struct call_table {
+    using result_type = typename call_result<Func, VoidPtr, Ts...>::type;
+    using thunk_type = result_type (*)(Func &, VoidPtr);
+
+    static constexpr thunk_type thunks[sizeof...(Ts)] {
+        &call_thunk<result_type, Func, Ts, VoidPtr>...
+    };
+};
+
+// Calls `func` with `ptr` cast to the `index`-th type of Ts
+template <typename Func, typename VoidPtr, typename... Ts>
+decltype(auto) dispatch(Func &&func, VoidPtr ptr, std::size_t index) {
+    if constexpr (sizeof...(Ts) <= SWITCH_DISPATCH_MAX) {
+        return dispatch_call<Func, Ts...>(std::forward<Func>(func), ptr, index);
+    } else {
+        using table = call_table<std::remove_reference_t<Func>, VoidPtr, Ts...>;
+        // DCHECK_LT(index, sizeof...(Ts));
+        return table::thunks[index](func, ptr);
+    }
+}
+
+// Tests the types `Likely...` first, in that order and marked [[likely]], and
+//   only then falls back to `dispatch`; `index` is the tag - 1 as for dispatch
 template <typename... Ts>
-class tagged_ptr {
+struct likely_dispatch {
+    template <typename Func, typename VoidPtr, typename L0, typename... Ls>
+    static typename call_result<Func, VoidPtr, Ts...>::type call(
+        Func &&func,
+        VoidPtr ptr,
+        std::size_t index
+    ) {
+        if (index == type_index_v<L0, Ts...>) [[likely]] {
+            return func(static_cast<pointer_like_t<L0, VoidPtr>>(ptr));
+        }
+        if constexpr (sizeof...(Ls) == 0uz) {
+            return dispatch<Func, VoidPtr, Ts...>(std::forward<Func>(func), ptr, index);
+        } else {
+            return call<Func, VoidPtr, Ls...>(std::forward<Func>(func), ptr, index);
+        }
+    }
+};
+
+}; // namespace detail::tagged_ptr end
+
+
+// Tag layouts
+// Where basic_tagged_ptr keeps the type tag inside the 64-bit word; tag 0 is nullptr,
+//   so a layout with B tag bits holds up to 2^B - 1 types
+// - tag_high_bits<B>: the top B bits. Pointee types may be incomplete; user-space
+//   addresses must fit in the 64 - B bits below (56 bits with 5-level paging),
+//   otherwise storing a pointer throws std::runtime_error
+// - tag_low_bits: the low bits that every pointer leaves zero because of
+//   alignment, log2 of the smallest alignof(Ts); independent of the address width
+// - tag_hybrid_bits<B>: the low alignment bits plus the top B bits, for more types
+//   than either gives alone
+template <std::size_t HighBits = 5uz>
+struct tag_high_bits {
+    template <typename... Ts>
+    struct layout {
+        static constexpr std::size_t LOW_BITS { 0uz };
+        static constexpr std::size_t HIGH_BITS { HighBits };
+    };
+};
+
+struct tag_low_bits {
+    template <typename... Ts>
+    struct layout {
+        static constexpr std::size_t LOW_BITS = std::countr_zero(std::min({ alignof(Ts)... }));
+        static constexpr std::size_t HIGH_BITS { 0uz };
+    };
+};
+
+template <std::size_t HighBits = 3uz>
+struct tag_hybrid_bits {
+    template <typename... Ts>
+    struct layout {
+        static constexpr std::size_t LOW_BITS = std::countr_zero(std::min({ alignof(Ts)... }));
+        static constexpr std::size_t HIGH_BITS { HighBits };
+    };
+};
+
+
+namespace detail::tagged_ptr {
+
+// Asks the kernel for a page far above the 47/48-bit boundary: it only honors
+//   the hint when the wider address space is enabled
+inline std::size_t probe_user_address_bits() {
+#if defined(__linux__) && (defined(__x86_64__) || defined(__aarch64__))
+#if defined(__x86_64__)
+    constexpr std::size_t NARROW { 47uz }, WIDE { 56uz };
+#else
+    constexpr std::size_t NARROW { 48uz }, WIDE { 52uz };
+#endif
+    constexpr std::uintptr_t HINT = std::uintptr_t { 1u } << (WIDE - 1uz);
+    constexpr std::size_t PAGE { 4096uz };
+
+    void *p = ::mmap(
+        reinterpret_cast<void *>(HINT), PAGE, PROT_NONE,
+        MAP_PRIVATE | MAP_ANONYMOUS | MAP_NORESERVE, -1, 0
+    );
+    if (p == MAP_FAILED) {
+        return NARROW;
+    }
+    bool wide = (reinterpret_cast<std::uintptr_t>(p) >> NARROW) != 0u;
+    ::munmap(p, PAGE);
+    return wide ? WIDE : NARROW;
+#else
+    return 48uz;
+#endif
+}
+
+}; // namespace detail::tagged_ptr end
+
+
+// Number of significant bits in a user-space pointer on this host: 47 on x86-64
+//   with 4-level paging, 56 with 5-level paging (LA57), 48 or 52 on AArch64
+inline std::size_t user_address_bits() {
+    static const std::size_t bits = detail::tagged_ptr::probe_user_address_bits();
+    return bits;
+}
+
+
+// basic_tagged_ptr
+template <typename Layout, typename... Ts>
+class basic_tagged_ptr {
 private:
     static_assert(
         sizeof(std::uintptr_t) >= sizeof(std::uint64_t),
         "tagged_ptr expect `std::uintptr_t` to have at least 64 bits"
     );
 
-    static constexpr std::uint64_t TAG_SHIFT { 59uz };
-    static constexpr std::uintptr_t GET_PTR_MASK = (1uz << TAG_SHIFT) - 1uz;
+    using layout = typename Layout::template layout<Ts...>;
+
+public:
+    static constexpr std::size_t LOW_TAG_BITS = layout::LOW_BITS;
+    static constexpr std::size_t HIGH_TAG_BITS = layout::HIGH_BITS;
+    // bits of the word an address may occupy
+    static constexpr std::size_t ADDRESS_BITS = 64uz - HIGH_TAG_BITS;
+
+private:
+    static_assert(
+        LOW_TAG_BITS + HIGH_TAG_BITS < 32uz,
+        "tagged_ptr: the tag layout leaves too few bits for the address"
+    );
+    static_assert(
+        sizeof...(Ts) < (1uz << (LOW_TAG_BITS + HIGH_TAG_BITS)),
+        "tagged_ptr: the tag layout has too few bits for this many types (tag 0 is nullptr)"
+    );
+
+    static constexpr std::uintptr_t LOW_MASK = (std::uintptr_t { 1u } << LOW_TAG_BITS) - 1u;
+    static constexpr std::uintptr_t HIGH_MASK =
+        HIGH_TAG_BITS == 0uz ? 0u : ~((std::uintptr_t { 1u } << ADDRESS_BITS) - 1u);
+    static constexpr std::uintptr_t GET_PTR_MASK = ~(LOW_MASK | HIGH_MASK);
+
     std::uintptr_t tagged_address { 0uz };
 
+    // called when a non-null pointer is stored, so that the error can be caught;
+    //   no host has more than 56 significant bits, so a layout leaving at least
+    //   that many to the address (tag_low_bits, tag_high_bits<8> and below) never
+    //   probes the host
+    static void check_address_space() {
+        if constexpr (ADDRESS_BITS < 56uz) {
+            if (user_address_bits() > ADDRESS_BITS) [[unlikely]] {
+                throw std::runtime_error(
+                    "tagged_ptr: user-space addresses overlap the high tag bits, use a tag layout with fewer high bits"
+                );
+            }
+        }
+    }
+
+    // counts this call in dispatch_profile<Ts...> when profiling is compiled in
+    void record_dispatch() const {
+#if defined(ZSTL_TAGGED_PTR_PROFILE)
+        dispatch_profile<Ts...>::record(static_cast<std::size_t>(tag()));
+#endif
+    }
+
+    static constexpr std::uintptr_t encode_tag(std::uintptr_t tag) {
+        std::uintptr_t word = tag & LOW_MASK;
+        if constexpr (HIGH_TAG_BITS != 0uz) {
+            word |= (tag >> LOW_TAG_BITS) << ADDRESS_BITS;
+        }
+        return word;
+    }
+
 public:
-    tagged_ptr()
-        : tagged_ptr(nullptr)
+    basic_tagged_ptr()
+        : basic_tagged_ptr(nullptr)
     {}
 
-    tagged_ptr(std::nullptr_t)
+    basic_tagged_ptr(std::nullptr_t)
         : tagged_address { 0uz }
     {}
 
     template <typename T>
         requires contain_type<T, Ts...>
-    tagged_ptr(const T *ptr)
+    basic_tagged_ptr(const T *ptr)
         : tagged_address {
             reinterpret_cast<std::uintptr_t>(static_cast<const void*>(ptr))
-            | (static_cast<std::uintptr_t>(get_type_tag<T>()) << TAG_SHIFT)
+            | encode_tag(get_type_tag<T>())
         }
-    {}
+    {
+        check_address_space();
+        // DCHECK_EQ(reinterpret_cast<std::uintptr_t>(ptr) & ~GET_PTR_MASK, 0u);
+    }
 
-    bool operator== (const tagged_ptr &other) const {
+    bool operator== (const basic_tagged_ptr &other) const {
         return (tagged_address == other.tagged_address)
             && (tag() == other.tag());
     }
 
-    bool operator!= (const tagged_ptr &other) const {
+    bool operator!= (const basic_tagged_ptr &other) const {
         return (tagged_address != other.tagged_address)
             || (tag() != other.tag());
     }
@@ -166,7 +380,8 @@ public:
 
     template <typename Func>
     decltype(auto) call(Func &&func) {
-        return detail::tagged_ptr::dispatch_call<Func, Ts...>(
+        record_dispatch();
+        return detail::tagged_ptr::dispatch<Func, decltype(ptr()), Ts...>(
             std::forward<Func>(func),
             ptr(),
             tag() - 1uz
@@ -175,7 +390,33 @@ public:
 
     template <typename Func>
     decltype(auto) call(Func &&func) const {
-        return detail::tagged_ptr::dispatch_call<Func, Ts...>(
+        record_dispatch();
+        return detail::tagged_ptr::dispatch<Func, decltype(ptr()), Ts...>(
+            std::forward<Func>(func),
+            ptr(),
+            tag() - 1uz
+        );
+    }
+
+    // Like call, for collections dominated by a few types: `Likely...` are tested
+    //   first, hottest first (see dispatch_profile::ranking), before the usual
+    //   dispatch handles the rest
+    template <typename... Likely, typename Func>
+        requires (sizeof...(Likely) > 0uz && (contain_type<Likely, Ts...> && ...))
+    decltype(auto) call_likely(Func &&func) {
+        record_dispatch();
+        return detail::tagged_ptr::likely_dispatch<Ts...>::template call<Func, decltype(ptr()), Likely...>(
+            std::forward<Func>(func),
+            ptr(),
+            tag() - 1uz
+        );
+    }
+
+    template <typename... Likely, typename Func>
+        requires (sizeof...(Likely) > 0uz && (contain_type<Likely, Ts...> && ...))
+    decltype(auto) call_likely(Func &&func) const {
+        record_dispatch();
+        return detail::tagged_ptr::likely_dispatch<Ts...>::template call<Func, decltype(ptr()), Likely...>(
             std::forward<Func>(func),
             ptr(),
             tag() - 1uz
@@ -183,7 +424,11 @@ public:
     }
 
     auto tag() const {
-        return static_cast<std::uint64_t>(tagged_address >> TAG_SHIFT);
+        std::uint64_t t = static_cast<std::uint64_t>(tagged_address & LOW_MASK);
+        if constexpr (HIGH_TAG_BITS != 0uz) {
+            t |= static_cast<std::uint64_t>(tagged_address >> ADDRESS_BITS) << LOW_TAG_BITS;
+        }
+        return t;
     }
 
     auto ptr() const {
@@ -194,9 +439,122 @@ public:
         return reinterpret_cast<void*>(tagged_address & GET_PTR_MASK);
     }
 
+    // The tagged word itself, for storing a tagged_ptr in an atomic or a packed field
+    std::uintptr_t raw() const {
+        return this->tagged_address;
+    }
+
+    static basic_tagged_ptr from_raw(std::uintptr_t word) {
+        basic_tagged_ptr p;
+        p.tagged_address = word;
+        return p;
+    }
+
     static constexpr auto number_of_types() {
         return sizeof...(Ts);
     }
+
+    // The most types this layout can tag
+    static constexpr std::size_t max_number_of_types() {
+        return (1uz << (LOW_TAG_BITS + HIGH_TAG_BITS)) - 1uz;
+    }
+};
+
+
+// tagged_ptr
+// The tag in the top 5 bits: up to 31 types, any alignment, incomplete types allowed
+template <typename... Ts>
+using tagged_ptr = basic_tagged_ptr<tag_high_bits<>, Ts...>;
+
+
+namespace detail::tagged_ptr {
+
+// One argument of zstl::dispatch: its types, and `T *` or `const T *` for them
+template <typename VoidPtr, typename... Ts>
+struct dispatch_slot {
+    using void_pointer = VoidPtr;
+
+    static constexpr std::size_t SIZE = sizeof...(Ts);
+
+    template <std::size_t I>
+    using pointer = pointer_like_t<std::tuple_element_t<I, std::tuple<Ts...>>, VoidPtr>;
+};
+
+template <typename VoidPtr, typename Layout, typename... Ts>
+dispatch_slot<VoidPtr, Ts...> slot_of(const basic_tagged_ptr<Layout, Ts...> *);
+
+// the slot of a (possibly const, possibly derived) tagged_ptr argument
+template <typename Ptr>
+using slot_for_t = decltype(slot_of<decltype(std::declval<Ptr &>().ptr())>(
+    std::declval<const std::remove_reference_t<Ptr> *>()
+));
+
+// A flattened table of every combination of argument types, row-major: the
+//   entry for type indices (i1, ..., ik) is at i1 * STRIDES[0] + ... + ik * STRIDES[k-1]
+template <typename Func, typename... Slots>
+struct multi_call_table {
+    static constexpr std::size_t RANK = sizeof...(Slots);
+    static constexpr std::array<std::size_t, RANK> SIZES { Slots::SIZE... };
+
+    static constexpr std::array<std::size_t, RANK> STRIDES = []() {
+        std::array<std::size_t, RANK> strides {};
+        std::size_t stride { 1uz };
+        for (std::size_t j = RANK; j-- > 0uz; ) {
+            strides[j] = stride;
+            stride *= SIZES[j];
+        }
+        return strides;
+    }();
+
+    static constexpr std::size_t SIZE = STRIDES[0uz] * SIZES[0uz];
+
+    // what `func` returns for the first type of every argument, by value
+    using result_type = std::remove_cvref_t<
+        std::invoke_result_t<Func &, typename Slots::template pointer<0uz>...>
+    >;
+    using thunk_type = result_type (*)(Func &, typename Slots::void_pointer...);
+
+    template <std::size_t Flat>
+    static result_type thunk(Func &func, typename Slots::void_pointer... ptrs) {
+        return [&]<std::size_t... K>(std::index_sequence<K...>) -> result_type {
+            return func(
+                static_cast<typename Slots::template pointer<Flat / STRIDES[K] % SIZES[K]>>(ptrs)...
+            );
+        }(std::make_index_sequence<RANK>());
+    }
+
+    static constexpr auto thunks = []<std::size_t... Flat>(std::index_sequence<Flat...>) {
+        return std::array<thunk_type, SIZE> { &thunk<Flat>... };
+    }(std::make_index_sequence<SIZE>());
 };
 
+}; // namespace detail::tagged_ptr end
+
+
+// dispatch
+// Multiple dispatch over tagged_ptrs: calls `func` with every argument cast to its
+//   dynamic type, through one indirect call into a flattened table of all
+//   N1 x N2 x ... type combinations, instead of nesting `call`s:
+//   zstl::dispatch(
+//       [](const auto *a, const auto *b) { return collide(*a, *b); },
+//       shapeA, shapeB
+//   );
+// Like `call`, the pointers are `const T *` for const arguments, every overload
+//   must return the same type, and no argument may be null
+template <typename Func, typename... Ptrs>
+    requires (sizeof...(Ptrs) > 0uz)
+decltype(auto) dispatch(Func &&func, Ptrs &&...ptrs) {
+    using table = detail::tagged_ptr::multi_call_table<
+        std::remove_reference_t<Func>,
+        detail::tagged_ptr::slot_for_t<Ptrs>...
+    >;
+
+    std::size_t index { 0uz };
+    std::size_t j { 0uz };
+    ((index += (static_cast<std::size_t>(ptrs.tag()) - 1uz) * table::STRIDES[j++]), ...);
+    // DCHECK_LT(index, table::SIZE);  // a null argument
+
+    return table::thunks[index](func, ptrs.ptr()...);
+}
+
 } // namespace zstl end
@@ -0,0 +1,205 @@
+#pragma once
+
+#include "memory_resource.hpp"
+#include "vector.hpp"
+#include "tagged_ptr.hpp"
+
+#include <span>
+#include <array>
+#include <tuple>
+#include <limits>
+#include <ranges>
+#include <cstdint>
+#include <cstddef>
+#include <utility>
+#include <concepts>
+#include <stdexcept>
+
+
+// Tag-bucketed batch dispatch over collections of `tagged_ptr<Ts...>`
+// Calling `call` element by element on a mixed collection jumps to a different
+//   target almost every time, and that indirect branch mispredicts constantly.
+//   tagged_ptr_groups sorts the pointers by tag instead (a stable counting sort
+//   on the 5-bit tag, two linear passes), after which every type is handled by
+//   one direct loop:
+//   zstl::tagged_ptr_groups<Circle, RightTriangle, Rectangle> groups;
+//   groups.assign(shapes);
+//   groups.visit([](auto group) { for (const auto *s : group) { ... } });
+// Each group is a std::span of `const T *` in input order, so a visitor can also
+//   work on a whole group at once (gather the fields, then a vectorizable loop);
+//   positions<T>() maps the group back to the input for scattering results
+// Elements may be of any type derived from tagged_ptr<Ts...>; null pointers are
+//   counted but not visited
+namespace zstl {
+
+template <typename... Ts>
+class tagged_ptr_groups {
+public:
+    using tagged_type = tagged_ptr<Ts...>;
+    using size_type = std::size_t;
+    using position_type = std::uint32_t;
+    using allocator_type = pmr::polymorphic_allocator<std::byte>;
+
+private:
+    static constexpr size_type N_TAGS = sizeof...(Ts) + 1uz;
+
+    // group of tag t: [offsets[t], offsets[t + 1]) of `pointers` and `order`
+    std::array<size_type, N_TAGS + 1uz> offsets {};
+    // the untyped pointers in tag order, filled in one pass without dispatch
+    zstl::vector<const void *> pointers;
+    zstl::vector<position_type> order;
+    // the same pointers as `const T *`, one vector per type
+    std::tuple<zstl::vector<const Ts *>...> groups;
+
+    template <typename T>
+    zstl::vector<const T *> &group_of() noexcept {
+        return std::get<type_index_v<T, Ts...>>(this->groups);
+    }
+
+    template <typename T>
+    const zstl::vector<const T *> &group_of() const noexcept {
+        return std::get<type_index_v<T, Ts...>>(this->groups);
+    }
+
+public:
+    // Constructor
+    explicit tagged_ptr_groups(const allocator_type &alloc = allocator_type())
+        : pointers(pmr::polymorphic_allocator<const void *>(alloc.resource()))
+        , order(pmr::polymorphic_allocator<position_type>(alloc.resource()))
+        , groups(pmr::polymorphic_allocator<const Ts *>(alloc.resource())...)
+    {}
+
+    template <std::ranges::forward_range Range>
+        requires std::derived_from<std::ranges::range_value_t<Range>, tagged_type>
+    explicit tagged_ptr_groups(const Range &ptrs, const allocator_type &alloc = allocator_type())
+        : tagged_ptr_groups(alloc)
+    {
+        this->assign(ptrs);
+    }
+
+    // Regroups `ptrs`; the buffers are reused, so calling assign() again on a
+    //   collection of similar size does not allocate
+    template <std::ranges::forward_range Range>
+        requires std::derived_from<std::ranges::range_value_t<Range>, tagged_type>
+    void assign(const Range &ptrs) {
+        std::array<size_type, N_TAGS> counts {};
+        size_type n { 0uz };
+        for (const tagged_type &p : ptrs) {
+            ++counts[p.tag()];
+            ++n;
+        }
+        if (n > std::numeric_limits<position_type>::max()) [[unlikely]] {
+            throw std::length_error("tagged_ptr_groups::assign");
+        }
+
+        this->offsets[0uz] = 0uz;
+        for (size_type t { 0uz }; t < N_TAGS; ++t) {
+            this->offsets[t + 1uz] = this->offsets[t] + counts[t];
+        }
+
+        this->pointers.resize_for_overwrite(n);
+        this->order.resize_for_overwrite(n);
+        std::array<size_type, N_TAGS> cursor;
+        for (size_type t { 0uz }; t < N_TAGS; ++t) {
+            cursor[t] = this->offsets[t];
+        }
+
+        position_type i { 0u };
+        for (const tagged_type &p : ptrs) {
+            size_type k = cursor[p.tag()]++;
+            this->pointers[k] = p.ptr();
+            this->order[k] = i++;
+        }
+
+        // one straight conversion loop per type
+        auto convert = [this]<typename T>() {
+            constexpr size_type TAG = tagged_type::template get_type_tag<T>();
+            const void *const *first = this->pointers.data() + this->offsets[TAG];
+            zstl::vector<const T *> &g = this->template group_of<T>();
+            g.resize_for_overwrite(this->offsets[TAG + 1uz] - this->offsets[TAG]);
+            for (size_type j { 0uz }; j < g.size(); ++j) {
+                g[j] = static_cast<const T *>(first[j]);
+            }
+        };
+        (convert.template operator()<Ts>(), ...);
+    }
+
+    size_type size() const noexcept {
+        return this->pointers.size();
+    }
+
+    size_type null_count() const noexcept {
+        return this->offsets[1uz];
+    }
+
+    // Pointers of type T, in input order
+    template <typename T>
+        requires contain_type<T, Ts...>
+    std::span<const T *const> group() const noexcept {
+        const zstl::vector<const T *> &g = this->template group_of<T>();
+        return { g.data(), g.size() };
+    }
+
+    // Input positions of the pointers in group<T>()
+    template <typename T>
+        requires contain_type<T, Ts...>
+    std::span<const position_type> positions() const noexcept {
+        constexpr size_type TAG = tagged_type::template get_type_tag<T>();
+        return {
+            this->order.data() + this->offsets[TAG],
+            this->offsets[TAG + 1uz] - this->offsets[TAG]
+        };
+    }
+
+    // visitor(group<T>()) for every type T with a non-empty group, in tag order
+    template <typename Visitor>
+    void visit(Visitor &&visitor) const {
+        auto visitOne = [&]<typename T>() {
+            std::span<const T *const> g = this->template group<T>();
+            if (!g.empty()) {
+                visitor(g);
+            }
+        };
+        (visitOne.template operator()<Ts>(), ...);
+    }
+
+    // func(p) for every non-null pointer, one type after the other; within a type
+    //   the call is direct and can be inlined
+    template <typename Func>
+    void for_each(Func &&func) const {
+        this->visit(
+            [&func](auto g) {
+                for (const auto *p : g) {
+                    func(p);
+                }
+            }
+        );
+    }
+};
+
+
+namespace detail::tagged_ptr {
+
+// tagged_ptr_groups for the tagged_ptr<Ts...> that `Derived` derives from
+template <typename... Ts>
+tagged_ptr_groups<Ts...> groups_for(const zstl::tagged_ptr<Ts...> *);
+
+template <typename Derived>
+using groups_for_t = decltype(groups_for(std::declval<const Derived *>()));
+
+}; // namespace detail::tagged_ptr end
+
+
+// One-shot form: groups `ptrs` by type and calls func(p) for each of them
+template <std::ranges::forward_range Range, typename Func>
+void for_each_grouped(
+    const Range &ptrs,
+    Func &&func,
+    pmr::memory_resource *resource = pmr::get_default_resource()
+) {
+    using groups_type = detail::tagged_ptr::groups_for_t<std::ranges::range_value_t<Range>>;
+    groups_type groups(ptrs, pmr::polymorphic_allocator<std::byte>(resource));
+    groups.for_each(std::forward<Func>(func));
+}
+
+} // namespace zstl end
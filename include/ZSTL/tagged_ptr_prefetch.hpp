@@ -0,0 +1,108 @@
+#pragma once
+
+#include "tagged_ptr.hpp"
+
+#include <ranges>
+#include <cstddef>
+#include <utility>
+#include <concepts>
+
+#if defined(_MSC_VER) && !defined(__clang__)
+#include <xmmintrin.h> // _mm_prefetch
+#endif
+
+
+// Prefetching traversal of collections of `tagged_ptr<Ts...>`
+// Walking a collection of pointers and calling into each pointee misses the cache
+//   on every element once the pointees no longer fit in it: the pointer array is
+//   streamed (and prefetched by the hardware), the pointees are not. These helpers
+//   issue a software prefetch for the pointee `distance` elements ahead before
+//   dispatching through `call` on the current one:
+//   zstl::for_each_prefetched(shapes, [&](const auto *s) { total += s->get_area(); });
+// The distance should cover the memory latency: about latency / time per element,
+//   so larger for cheap calls. Only the first cache line of a pointee is fetched
+namespace zstl {
+
+inline constexpr std::size_t DEFAULT_PREFETCH_DISTANCE { 32uz };
+
+namespace detail::tagged_ptr {
+
+// A read prefetch into all cache levels; never faults, so nullptr is fine
+inline void prefetch(const void *p) noexcept {
+#if defined(__GNUC__) || defined(__clang__)
+    __builtin_prefetch(p, 0, 3);
+#elif defined(_MSC_VER)
+    _mm_prefetch(static_cast<const char *>(p), _MM_HINT_T0);
+#else
+    static_cast<void>(p);
+#endif
+}
+
+template <typename Range>
+concept tagged_ptr_range = std::ranges::random_access_range<Range>
+    && std::ranges::sized_range<Range>
+    && requires(std::ranges::range_reference_t<Range> p) {
+        { p.ptr() };
+        { p.tag() };
+    };
+
+}; // namespace detail::tagged_ptr end
+
+
+// func(p) through `call` for every element of `ptrs`, in order, prefetching the
+//   pointee `distance` elements ahead; like `call`, no element may be null
+template <detail::tagged_ptr::tagged_ptr_range Range, typename Func>
+void for_each_prefetched(
+    Range &&ptrs,
+    Func &&func,
+    std::size_t distance = DEFAULT_PREFETCH_DISTANCE
+) {
+    auto first = std::ranges::begin(ptrs);
+    std::size_t n = static_cast<std::size_t>(std::ranges::size(ptrs));
+    std::size_t head = distance < n ? distance : n;
+
+    for (std::size_t i { 0uz }; i < head; ++i) {
+        detail::tagged_ptr::prefetch(first[i].ptr());
+    }
+
+    std::size_t i { 0uz };
+    for (; i + distance < n; ++i) {
+        detail::tagged_ptr::prefetch(first[i + distance].ptr());
+        first[i].call(func);
+    }
+    // the last `distance` elements are already on their way
+    for (; i < n; ++i) {
+        first[i].call(func);
+    }
+}
+
+// The sum of func(p) over the elements of `ptrs`, with the same prefetching
+template <detail::tagged_ptr::tagged_ptr_range Range, typename T, typename Func>
+T reduce_prefetched(
+    Range &&ptrs,
+    T init,
+    Func &&func,
+    std::size_t distance = DEFAULT_PREFETCH_DISTANCE
+) {
+    // its own loop rather than for_each_prefetched with a capturing lambda, so
+    //   that the sum stays in a register across the calls
+    auto first = std::ranges::begin(ptrs);
+    std::size_t n = static_cast<std::size_t>(std::ranges::size(ptrs));
+    std::size_t head = distance < n ? distance : n;
+
+    for (std::size_t i { 0uz }; i < head; ++i) {
+        detail::tagged_ptr::prefetch(first[i].ptr());
+    }
+
+    std::size_t i { 0uz };
+    for (; i + distance < n; ++i) {
+        detail::tagged_ptr::prefetch(first[i + distance].ptr());
+        init += first[i].call(func);
+    }
+    for (; i < n; ++i) {
+        init += first[i].call(func);
+    }
+    return init;
+}
+
+} // namespace zstl end
@@ -0,0 +1,155 @@
+#pragma once
+
+#include "memory_resource.hpp"
+#include "tagged_ptr.hpp"
+#include "tagged_unique_ptr.hpp" // detail::tagged_owner
+
+#include <atomic>
+#include <cstddef>
+#include <utility>
+
+
+// tagged_shared_ptr
+// A reference-counted `tagged_ptr<Ts...>` in one 8-byte word: the count is
+//   intrusive, kept in the header in front of the object next to its
+//   memory_resource, and the last owner destroys the object through the tag
+//   like tagged_unique_ptr does
+// Copies increment the count (relaxed) and the last release decrements it with
+//   acq_rel, so owners on different threads are fine; the object itself is not
+//   synchronized
+namespace zstl {
+
+template <typename... Ts>
+class tagged_shared_ptr {
+public:
+    using pointer = tagged_ptr<Ts...>;
+    using allocator_type = pmr::polymorphic_allocator<std::byte>;
+
+private:
+    using header = detail::tagged_owner::counted_header;
+
+    pointer p;
+
+    explicit tagged_shared_ptr(pointer p) noexcept
+        : p(p)
+    {}
+
+    header *control() const noexcept {
+        return detail::tagged_owner::header_of<header>(this->p.ptr());
+    }
+
+    void acquire() const noexcept {
+        if (this->p.tag() != 0u) {
+            this->control()->count.fetch_add(1uz, std::memory_order_relaxed);
+        }
+    }
+
+public:
+    // Constructor
+    tagged_shared_ptr() noexcept = default;
+
+    tagged_shared_ptr(std::nullptr_t) noexcept
+    {}
+
+    tagged_shared_ptr(const tagged_shared_ptr &other) noexcept
+        : p(other.p)
+    {
+        this->acquire();
+    }
+
+    tagged_shared_ptr(tagged_shared_ptr &&other) noexcept
+        : p(std::exchange(other.p, nullptr))
+    {}
+
+    tagged_shared_ptr &operator=(const tagged_shared_ptr &other) noexcept {
+        // acquire before release, so that self-assignment keeps the object alive
+        pointer q = other.p;
+        other.acquire();
+        this->reset();
+        this->p = q;
+        return *this;
+    }
+
+    tagged_shared_ptr &operator=(tagged_shared_ptr &&other) noexcept {
+        if (this != &other) [[likely]] {
+            this->reset();
+            this->p = std::exchange(other.p, nullptr);
+        }
+        return *this;
+    }
+
+    // Destructor
+    ~tagged_shared_ptr() {
+        this->reset();
+    }
+
+    template <typename T, typename... Args>
+        requires contain_type<T, Ts...>
+    static tagged_shared_ptr allocate(const allocator_type &alloc, Args &&...args) {
+        return tagged_shared_ptr(
+            pointer(detail::tagged_owner::create<header, T>(alloc, std::forward<Args>(args)...))
+        );
+    }
+
+    template <typename T, typename... Args>
+        requires contain_type<T, Ts...>
+    static tagged_shared_ptr make(Args &&...args) {
+        return allocate<T>(allocator_type(pmr::get_default_resource()), std::forward<Args>(args)...);
+    }
+
+    // Drops this owner; the last one destroys the object
+    void reset() noexcept {
+        if (this->p.tag() == 0u) { return ; }
+
+        if (this->control()->count.fetch_sub(1uz, std::memory_order_acq_rel) == 1uz) {
+            this->p.call(
+                [](auto *obj) {
+                    detail::tagged_owner::destroy<header>(obj);
+                }
+            );
+        }
+        this->p = nullptr;
+    }
+
+    void swap(tagged_shared_ptr &other) noexcept {
+        std::swap(this->p, other.p);
+    }
+
+    std::size_t use_count() const noexcept {
+        return this->p.tag() == 0u
+            ? 0uz
+            : this->control()->count.load(std::memory_order_relaxed);
+    }
+
+    pointer get() const noexcept {
+        return this->p;
+    }
+
+    explicit operator bool() const noexcept {
+        return this->p.tag() != 0u;
+    }
+
+    auto tag() const {
+        return this->p.tag();
+    }
+
+    template <typename T>
+        requires contain_type<T, Ts...>
+    bool points_to_type() const {
+        return this->p.template points_to_type<T>();
+    }
+
+    template <typename T>
+        requires contain_type<T, Ts...>
+    T *cast() const {
+        return const_cast<T *>(this->p.template cast<T>());
+    }
+
+    template <typename Func>
+    decltype(auto) call(Func &&func) const {
+        pointer q = this->p;
+        return q.call(std::forward<Func>(func));
+    }
+};
+
+} // namespace zstl end
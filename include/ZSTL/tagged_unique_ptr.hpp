@@ -0,0 +1,194 @@
+#pragma once
+
+#include "memory_resource.hpp"
+#include "tagged_ptr.hpp"
+
+#include <new>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <utility>
+#include <type_traits>
+
+
+// tagged_unique_ptr
+// An owning `tagged_ptr<Ts...>`: one 8-byte word, no vtable, and on destruction
+//   the tag picks the destructor, so a `std::unique_ptr<Base>` hierarchy can
+//   become a set of unrelated types:
+//   auto shape = zstl::tagged_unique_ptr<Circle, Rectangle>::make<Circle>(2.0);
+//   double area = shape.call([](const auto *s) { return s->get_area(); });
+// Objects are created by make<T>(args...), from pmr::get_default_resource(), or
+//   by allocate<T>(alloc, args...); both put a small header right in front of the
+//   object (the memory_resource it came from, and the reference count for
+//   tagged_shared_ptr); the header is found from the object address whatever its
+//   type, so the pointer stays 8 bytes
+namespace zstl {
+
+namespace detail::tagged_owner {
+
+struct header {
+    pmr::memory_resource *resource;
+};
+
+struct counted_header {
+    pmr::memory_resource *resource;
+    std::atomic<std::size_t> count;
+};
+
+// The block is [ padding | H | T ]: T starts at OFFSET, H ends where T starts
+template <typename H, typename T>
+inline constexpr std::size_t ALIGN = alignof(T) > alignof(H) ? alignof(T) : alignof(H);
+
+template <typename H, typename T>
+inline constexpr std::size_t OFFSET = (sizeof(H) + ALIGN<H, T> - 1uz) / ALIGN<H, T> * ALIGN<H, T>;
+
+template <typename H>
+H *header_of(const void *obj) noexcept {
+    return reinterpret_cast<H *>(
+        const_cast<std::byte *>(static_cast<const std::byte *>(obj)) - sizeof(H)
+    );
+}
+
+template <typename H, typename T, typename... Args>
+T *create(pmr::polymorphic_allocator<std::byte> alloc, Args &&...args) {
+    std::byte *block = static_cast<std::byte *>(
+        alloc.allocate_bytes(OFFSET<H, T> + sizeof(T), ALIGN<H, T>)
+    );
+    T *obj = reinterpret_cast<T *>(block + OFFSET<H, T>);
+    try {
+        alloc.construct(obj, std::forward<Args>(args)...);
+    } catch (...) {
+        alloc.deallocate_bytes(block, OFFSET<H, T> + sizeof(T), ALIGN<H, T>);
+        throw;
+    }
+    // every member initialized, the count of a new shared object starts at its one owner
+    if constexpr (std::is_same_v<H, counted_header>) {
+        ::new (static_cast<void *>(header_of<H>(obj))) H { alloc.resource(), 1uz };
+    } else {
+        ::new (static_cast<void *>(header_of<H>(obj))) H { alloc.resource() };
+    }
+    return obj;
+}
+
+template <typename H, typename T>
+void destroy(T *obj) noexcept {
+    H *h = header_of<H>(obj);
+    pmr::polymorphic_allocator<std::byte> alloc(h->resource);
+    alloc.destroy(obj);
+    h->~H();
+    alloc.deallocate_bytes(
+        reinterpret_cast<std::byte *>(obj) - OFFSET<H, T>,
+        OFFSET<H, T> + sizeof(T),
+        ALIGN<H, T>
+    );
+}
+
+}; // namespace detail::tagged_owner end
+
+
+template <typename... Ts>
+class tagged_unique_ptr {
+public:
+    using pointer = tagged_ptr<Ts...>;
+    using allocator_type = pmr::polymorphic_allocator<std::byte>;
+
+private:
+    using header = detail::tagged_owner::header;
+
+    pointer p;
+
+    explicit tagged_unique_ptr(pointer p) noexcept
+        : p(p)
+    {}
+
+public:
+    // Constructor
+    tagged_unique_ptr() noexcept = default;
+
+    tagged_unique_ptr(std::nullptr_t) noexcept
+    {}
+
+    tagged_unique_ptr(const tagged_unique_ptr &) = delete;
+    tagged_unique_ptr &operator=(const tagged_unique_ptr &) = delete;
+
+    tagged_unique_ptr(tagged_unique_ptr &&other) noexcept
+        : p(std::exchange(other.p, nullptr))
+    {}
+
+    tagged_unique_ptr &operator=(tagged_unique_ptr &&other) noexcept {
+        if (this != &other) [[likely]] {
+            this->reset();
+            this->p = std::exchange(other.p, nullptr);
+        }
+        return *this;
+    }
+
+    // Destructor
+    ~tagged_unique_ptr() {
+        this->reset();
+    }
+
+    // A T constructed from `args` in memory from `alloc`'s memory_resource
+    template <typename T, typename... Args>
+        requires contain_type<T, Ts...>
+    static tagged_unique_ptr allocate(const allocator_type &alloc, Args &&...args) {
+        return tagged_unique_ptr(
+            pointer(detail::tagged_owner::create<header, T>(alloc, std::forward<Args>(args)...))
+        );
+    }
+
+    template <typename T, typename... Args>
+        requires contain_type<T, Ts...>
+    static tagged_unique_ptr make(Args &&...args) {
+        return allocate<T>(allocator_type(pmr::get_default_resource()), std::forward<Args>(args)...);
+    }
+
+    // Destroys the owned object, if any
+    void reset() noexcept {
+        if (this->p.tag() != 0u) {
+            this->p.call(
+                [](auto *obj) {
+                    detail::tagged_owner::destroy<header>(obj);
+                }
+            );
+            this->p = nullptr;
+        }
+    }
+
+    void swap(tagged_unique_ptr &other) noexcept {
+        std::swap(this->p, other.p);
+    }
+
+    // The non-owning tagged_ptr
+    pointer get() const noexcept {
+        return this->p;
+    }
+
+    explicit operator bool() const noexcept {
+        return this->p.tag() != 0u;
+    }
+
+    auto tag() const {
+        return this->p.tag();
+    }
+
+    template <typename T>
+        requires contain_type<T, Ts...>
+    bool points_to_type() const {
+        return this->p.template points_to_type<T>();
+    }
+
+    template <typename T>
+        requires contain_type<T, Ts...>
+    T *cast() const {
+        return const_cast<T *>(this->p.template cast<T>());
+    }
+
+    template <typename Func>
+    decltype(auto) call(Func &&func) const {
+        pointer q = this->p;
+        return q.call(std::forward<Func>(func));
+    }
+};
+
+} // namespace zstl end
@@ -0,0 +1,274 @@
+#pragma once
+
+#include <mutex>
+#include <atomic>
+#include <thread>
+#include <vector>
+#include <cstddef>
+#include <exception>
+#include <cstdint>
+#include <utility>
+#include <type_traits>
+#include <condition_variable>
+
+
+namespace zstl {
+
+// thread_pool
+// A fork-join pool of `std::jthread` workers for data-parallel loops
+// run(nTasks, func) calls func(task) for every task in [0, nTasks), spreading the
+//   tasks over the workers and the calling thread, and returns once all are done
+// Task t < size() always runs on thread t (0 is the caller, then the workers in
+//   order), so chunk t of every parallel_for over the same range lands on the same
+//   thread; the tasks past the first size() are handed out to whichever thread is free
+// If tasks throw, the other tasks still run and run() rethrows the first exception
+//   once every thread is done with the job
+// Calls to run() are serialized; calling run() from inside a task deadlocks
+class thread_pool {
+private:
+    std::vector<std::jthread> workers;
+
+    std::mutex runMutex; // serializes run()
+    std::mutex m;
+    std::condition_variable startCv;
+    std::condition_variable doneCv;
+
+    // the current job, type-erased so that run() can take any callable
+    const void *jobContext { nullptr };
+    void (*jobInvoke)(const void *, std::size_t) { nullptr };
+    std::size_t jobTasks { 0uz };
+    std::atomic<std::size_t> nextTask { 0uz };
+    std::exception_ptr jobError;
+
+    std::uint64_t generation { 0u };
+    std::size_t nFinished { 0uz };
+    bool stopping { false };
+
+public:
+    // `nThreads` counts the calling thread, so thread_pool(1) runs everything inline
+    explicit thread_pool(unsigned nThreads = std::thread::hardware_concurrency()) {
+        if (nThreads == 0u) {
+            nThreads = 1u;
+        }
+
+        this->workers.reserve(nThreads - 1u);
+        for (unsigned i = 1u; i < nThreads; ++i) {
+            this->workers.emplace_back(
+                [this, i] {
+                    this->worker_loop(i);
+                }
+            );
+        }
+    }
+
+    thread_pool(const thread_pool &) = delete;
+    thread_pool &operator=(const thread_pool &) = delete;
+
+    ~thread_pool() {
+        {
+            std::lock_guard lock(this->m);
+            this->stopping = true;
+        }
+        this->startCv.notify_all();
+        // join here rather than in the member destructors: `workers` is destroyed
+        //   last, after the mutex and condition variables the workers still use
+        for (std::jthread &w : this->workers) {
+            w.join();
+        }
+    }
+
+    // number of threads that execute tasks, including the caller of run()
+    unsigned size() const noexcept {
+        return static_cast<unsigned>(this->workers.size()) + 1u;
+    }
+
+    template <typename Func>
+    void run(std::size_t nTasks, Func &&func) {
+        if (nTasks == 0uz) { return ; }
+
+        if (this->workers.empty() || nTasks == 1uz) {
+            for (std::size_t task { 0uz }; task < nTasks; ++task) {
+                func(task);
+            }
+            return ;
+        }
+
+        std::lock_guard runLock(this->runMutex);
+        {
+            std::lock_guard lock(this->m);
+            this->jobContext = static_cast<const void *>(&func);
+            this->jobInvoke = [](const void *context, std::size_t task) {
+                (*static_cast<std::remove_reference_t<Func> *>(const_cast<void *>(context)))(task);
+            };
+            this->jobTasks = nTasks;
+            this->nextTask.store(this->size(), std::memory_order_relaxed);
+            this->jobError = nullptr;
+            this->nFinished = 0uz;
+            ++(this->generation);
+        }
+        this->startCv.notify_all();
+
+        this->execute_tasks(0uz);
+
+        std::exception_ptr error;
+        {
+            // the workers still use `func` until they report back, even if a task threw
+            std::unique_lock lock(this->m);
+            this->doneCv.wait(
+                lock,
+                [this] {
+                    return this->nFinished == this->workers.size();
+                }
+            );
+            error = std::exchange(this->jobError, nullptr);
+        }
+        if (error) {
+            std::rethrow_exception(error);
+        }
+    }
+
+private:
+    // Runs the task pinned to thread `self`, then takes the shared ones
+    void execute_tasks(std::size_t self) noexcept {
+        if (self < this->jobTasks) {
+            this->execute_task(self);
+        }
+        for (;;) {
+            std::size_t task = this->nextTask.fetch_add(1uz, std::memory_order_relaxed);
+            if (task >= this->jobTasks) {
+                break;
+            }
+            this->execute_task(task);
+        }
+    }
+
+    void execute_task(std::size_t task) noexcept {
+        try {
+            this->jobInvoke(this->jobContext, task);
+        } catch (...) {
+            std::lock_guard lock(this->m);
+            if (!this->jobError) {
+                this->jobError = std::current_exception();
+            }
+        }
+    }
+
+    void worker_loop(std::size_t self) {
+        std::uint64_t seen { 0u };
+        for (;;) {
+            {
+                std::unique_lock lock(this->m);
+                this->startCv.wait(
+                    lock,
+                    [&] {
+                        return this->stopping || this->generation != seen;
+                    }
+                );
+                if (this->stopping) {
+                    return ;
+                }
+                seen = this->generation;
+            }
+
+            this->execute_tasks(self);
+
+            {
+                std::lock_guard lock(this->m);
+                ++(this->nFinished);
+            }
+            this->doneCv.notify_one();
+        }
+    }
+};
+
+// process-wide pool with one thread per hardware thread
+inline thread_pool &default_thread_pool() {
+    static thread_pool pool;
+    return pool;
+}
+
+
+// parallel_policy
+// Requests that an operation be split over a thread pool
+// Ranges shorter than `min_chunk` elements per thread are not worth waking workers for
+struct parallel_policy {
+    thread_pool *pool { nullptr }; // nullptr: default_thread_pool()
+    std::size_t min_chunk { 1uz << 16 };
+
+    thread_pool &get_pool() const {
+        return this->pool ? *this->pool : default_thread_pool();
+    }
+};
+
+inline constexpr parallel_policy par {};
+
+
+// Number of contiguous chunks [0, n) is split into under `policy`:
+//   at most one per thread, and none shorter than `min_chunk`
+inline std::size_t parallel_chunk_count(
+    const parallel_policy &policy,
+    std::size_t n
+) {
+    std::size_t minChunk = policy.min_chunk == 0uz ? 1uz : policy.min_chunk;
+    std::size_t nChunks = (n + minChunk - 1uz) / minChunk;
+    std::size_t nThreads = policy.get_pool().size();
+
+    return nChunks < nThreads ? nChunks : nThreads;
+}
+
+// [begin, end) of chunk `chunk` out of `nChunks` over [0, n)
+inline std::pair<std::size_t, std::size_t> parallel_chunk_bounds(
+    std::size_t n,
+    std::size_t nChunks,
+    std::size_t chunk
+) {
+    return { n * chunk / nChunks, n * (chunk + 1uz) / nChunks };
+}
+
+// Splits [0, n) into `nChunks` contiguous chunks (see parallel_chunk_count())
+//   and calls func(chunk, begin, end) for each chunk, one chunk per task, so with
+//   at most one chunk per thread chunk i runs on thread i of the pool
+template <typename Func>
+void parallel_for_chunks(
+    const parallel_policy &policy,
+    std::size_t n,
+    std::size_t nChunks,
+    Func &&func
+) {
+    if (n == 0uz) { return ; }
+
+    if (nChunks <= 1uz) {
+        func(0uz, 0uz, n);
+        return ;
+    }
+
+    policy.get_pool().run(
+        nChunks,
+        [&](std::size_t chunk) {
+            auto [begin, end] = parallel_chunk_bounds(n, nChunks, chunk);
+            func(chunk, begin, end);
+        }
+    );
+}
+
+// Splits [0, n) into one contiguous chunk per thread and calls func(begin, end)
+//   for each chunk; chunk i always runs on thread i, so the thread that first
+//   touches a block (and so decides the NUMA node of its pages) is the thread
+//   that gets that block in every later parallel_for over the same range
+template <typename Func>
+void parallel_for(
+    const parallel_policy &policy,
+    std::size_t n,
+    Func &&func
+) {
+    parallel_for_chunks(
+        policy,
+        n,
+        parallel_chunk_count(policy, n),
+        [&](std::size_t, std::size_t begin, std::size_t end) {
+            func(begin, end);
+        }
+    );
+}
+
+} // namespace zstl end
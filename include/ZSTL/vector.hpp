@@ -1,10 +1,18 @@
 #pragma once
 
 #include "memory_resource.hpp"
+#include "thread_pool.hpp" // zstl::parallel_policy, zstl::parallel_for_chunks
 
+#include <new>
+#include <memory>
+#include <span>
 #include <limits>
 #include <cstddef>
+#include <cstring>
+#include <utility>
 #include <iterator>
+#include <stdexcept>
+#include <type_traits>
 #include <initializer_list>
 
 
@@ -44,7 +52,7 @@ public:
         , nStored { 0uz }
     {}
 
-    constexpr explicit vector(const allocator_type &alloc = {}) noexcept
+    constexpr explicit vector(const allocator_type &alloc) noexcept
         : alloc(alloc)
     {}
 
@@ -95,7 +103,7 @@ public:
 
     constexpr vector(const vector &other)
         : alloc(other.alloc)
-        , nAlloc(other.nAlloc)
+        , nAlloc(other.nStored)
         , nStored(other.nStored)
     {
         if (this->nStored != 0uz) {
@@ -113,7 +121,7 @@ public:
 
     constexpr vector(
         const vector &other,
-        const allocator_type &alloc = allocator_type()
+        const allocator_type &alloc
     )
         : alloc(alloc)
     {
@@ -169,6 +177,30 @@ public:
         : vector(init.begin(), init.end(), alloc)
     {}
 
+    // Parallel construction: the range is split into one contiguous chunk per thread
+    //   of `policy`'s pool and chunk i is constructed by thread i (see parallel_for),
+    //   so the pages of a fresh allocation are first touched by the thread that gets
+    //   the same chunk in later parallel loops over the vector
+    vector(
+        const parallel_policy &policy,
+        size_type count,
+        const_reference value,
+        const allocator_type &alloc = allocator_type()
+    )
+        : alloc(alloc)
+    {
+        this->assign(policy, count, value);
+    }
+
+    vector(
+        const parallel_policy &policy,
+        const vector &other
+    )
+        : alloc(other.alloc)
+    {
+        this->assign(policy, other.begin(), other.end());
+    }
+
     constexpr vector &operator=(const vector &other) {
         if (this == &other) [[unlikely]] {
             return *this;
@@ -193,9 +225,9 @@ public:
         }
 
         if (this->alloc == other.alloc) {
-            zstd::swap(this->ptr, other.ptr);
-            zstd::swap(this->nAlloc, other.nAlloc);
-            zstd::swap(this->nStored, other.nStored);
+            std::swap(this->ptr, other.ptr);
+            std::swap(this->nAlloc, other.nAlloc);
+            std::swap(this->nStored, other.nStored);
         } else {
             clear();
             reserve(other.size());
@@ -256,6 +288,72 @@ public:
         this->assign(init.begin(), init.end());
     }
 
+    void assign(
+        const parallel_policy &policy,
+        size_type count,
+        const value_type &value
+    ) {
+        this->parallel_construct(
+            policy,
+            count,
+            [&value](pointer dst, size_type first, size_type last) {
+                std::uninitialized_fill(dst + first, dst + last, value);
+            }
+        );
+    }
+
+    template <std::random_access_iterator RandomIt>
+    void assign(
+        const parallel_policy &policy,
+        RandomIt first,
+        RandomIt last
+    ) {
+        this->parallel_construct(
+            policy,
+            static_cast<size_type>(last - first),
+            [first](pointer dst, size_type begin, size_type end) {
+                if constexpr (
+                    std::contiguous_iterator<RandomIt>
+                    && std::is_trivially_copyable_v<value_type>
+                    && std::is_same_v<std::iter_value_t<RandomIt>, value_type>
+                ) {
+                    std::memcpy(
+                        static_cast<void *>(dst + begin),
+                        std::to_address(first + begin),
+                        (end - begin) * sizeof(value_type)
+                    );
+                } else {
+                    std::uninitialized_copy(first + begin, first + end, dst + begin);
+                }
+            }
+        );
+    }
+
+    // Replaces the contents with op(*it) for every it in [first, last)
+    template <std::random_access_iterator RandomIt, class UnaryOp>
+    void assign_transformed(
+        const parallel_policy &policy,
+        RandomIt first,
+        RandomIt last,
+        UnaryOp op
+    ) {
+        this->parallel_construct(
+            policy,
+            static_cast<size_type>(last - first),
+            [first, &op](pointer dst, size_type begin, size_type end) {
+                size_type i = begin;
+                try {
+                    for (; i < end; ++i) {
+                        ::new (static_cast<void *>(dst + i)) value_type(op(first[i]));
+                    }
+                } catch (...) {
+                    std::destroy(dst + begin, dst + i);
+                    throw;
+                }
+            }
+        );
+    }
+
     constexpr allocator_type get_allocator() const noexcept {
         return this->alloc;
     }
@@ -431,7 +529,7 @@ public:
         const_reference value
     ) {
         // TODO
-        log::log_fatal("TODO");
+        throw std::logic_error("vector: not implemented");
     }
 
     constexpr iterator insert(
@@ -439,7 +537,7 @@ public:
         value_type &&value
     ) {
         // TODO
-        log::log_fatal("TODO");
+        throw std::logic_error("vector: not implemented");
     }
 
     constexpr iterator insert(
@@ -448,7 +546,7 @@ public:
         const_reference value
     ) {
         // TODO
-        log::log_fatal("TODO");
+        throw std::logic_error("vector: not implemented");
     }
 
     template <class InputIt>
@@ -464,7 +562,7 @@ public:
             }
             return begin() + firstOffset;
         } else {
-            log::log_fatal("TODO");
+            throw std::logic_error("vector: not implemented");
         }
     }
 
@@ -473,23 +571,23 @@ public:
         std::initializer_list<value_type> init
     ) {
         // TODO
-        log::log_fatal("TODO");
+        throw std::logic_error("vector: not implemented");
     }
 
     template <class... Args>
     constexpr iterator emplace(const_iterator pos, Args &&...args) {
         // TODO
-        log::log_fatal("TODO");
+        throw std::logic_error("vector: not implemented");
     }
 
     constexpr iterator erase(const_iterator pos) {
         // TODO
-        log::log_fatal("TODO");
+        throw std::logic_error("vector: not implemented");
     }
 
     constexpr iterator erase(const_iterator first, const_iterator last) {
         // TODO
-        log::log_fatal("TODO");
+        throw std::logic_error("vector: not implemented");
     }
 
     constexpr void push_back(const_reference value) {
@@ -570,12 +668,63 @@ public:
             this->reserve(count);
             for (size_type i = this->nStored; i != count; ++i) {
                 // std::construct_at(&this->ptr[i], value); // this->ptr[i] = value
-                this->alloc.construct(ptr + nStored, value);
+                this->alloc.construct(ptr + i, value);
             }
         }
         this->nStored = count;
     }
 
+    // Like resize(count), but new elements are default-initialized rather than
+    // value-initialized, so trivial types (char, int, POD records) are left
+    // uninitialized and can be filled by read()/memcpy() without a zeroing pass
+    constexpr void resize_for_overwrite(size_type count) {
+        if (count < this->nStored) {
+            for (size_type i = count; i != this->nStored; ++i) {
+                this->alloc.destroy(ptr + i);
+            }
+        } else if (count > this->nStored) {
+            this->reserve(count);
+            this->default_construct(this->ptr + this->nStored, count - this->nStored);
+        }
+        this->nStored = count;
+    }
+
+    // ref: https://en.cppreference.com/w/cpp/string/basic_string/resize_and_overwrite
+    // `op(data(), count)` writes the new contents into [data(), data() + count)
+    //   and returns the number of elements to keep (at most `count`); a larger
+    //   result throws std::length_error and leaves the `count` elements in place
+    template <class Operation>
+    constexpr void resize_and_overwrite(size_type count, Operation op) {
+        this->resize_for_overwrite(count);
+        size_type kept = static_cast<size_type>(
+            std::move(op)(this->ptr, count)
+        );
+        if (kept > count) [[unlikely]] {
+            throw std::length_error("vector::resize_and_overwrite");
+        }
+        this->resize_for_overwrite(kept);
+    }
+
+    // Appends `count` default-initialized elements and returns a span over them,
+    //   growing the capacity geometrically like push_back()
+    // Typical use is reading straight into the vector:
+    //   auto buf = v.append_uninitialized(4096uz);
+    //   auto n = ::read(fd, buf.data(), buf.size_bytes());
+    //   v.resize(v.size() - buf.size() + n);
+    constexpr std::span<value_type> append_uninitialized(size_type count) {
+        size_type required = this->nStored + count;
+        if (required > this->nAlloc) {
+            size_type grown = this->nAlloc == 0uz ? 4uz : 2uz * this->nAlloc;
+            this->reserve(grown < required ? required : grown);
+        }
+
+        pointer first = this->ptr + this->nStored;
+        this->default_construct(first, count);
+        this->nStored = required;
+
+        return std::span<value_type>(first, count);
+    }
+
     constexpr void swap(vector &other) noexcept {
         // CHECK(alloc == other.alloc);  // TODO: handle this
         std::swap(this->alloc, other.alloc);
@@ -583,6 +732,55 @@ public:
         std::swap(this->nAlloc, other.nAlloc);
         std::swap(this->nStored, other.nStored);
     }
+
+private:
+    // Clears, makes room for `count` elements and lets `construct(ptr, begin, end)`
+    //   build each chunk [begin, end) on the thread that owns it
+    // `construct` must leave nothing behind in its chunk when it throws; the chunks
+    //   built by the other threads are then destroyed and the vector is left empty
+    template <class Construct>
+    void parallel_construct(
+        const parallel_policy &policy,
+        size_type count,
+        Construct construct
+    ) {
+        this->clear();
+        this->reserve(count);
+
+        pointer dst = this->ptr;
+        size_type nChunks = parallel_chunk_count(policy, count);
+        // one flag per chunk, written only by the thread that builds it
+        std::unique_ptr<bool[]> built(new bool[nChunks > 0uz ? nChunks : 1uz] {});
+        try {
+            parallel_for_chunks(
+                policy,
+                count,
+                nChunks,
+                [dst, &construct, &built](size_type chunk, size_type begin, size_type end) {
+                    construct(dst, begin, end);
+                    built[chunk] = true;
+                }
+            );
+        } catch (...) {
+            for (size_type chunk { 0uz }; chunk < nChunks; ++chunk) {
+                if (built[chunk]) {
+                    auto [begin, end] = parallel_chunk_bounds(count, nChunks, chunk);
+                    std::destroy(dst + begin, dst + end);
+                }
+            }
+            throw;
+        }
+        this->nStored = count;
+    }
+
+    // default-initialization: a no-op for trivially default constructible types
+    constexpr void default_construct(pointer first, size_type count) {
+        if constexpr (!std::is_trivially_default_constructible_v<value_type>) {
+            for (size_type i { 0uz }; i < count; ++i) {
+                ::new (static_cast<void *>(first + i)) value_type;
+            }
+        }
+    }
 };
 
 } // namespace zstl end
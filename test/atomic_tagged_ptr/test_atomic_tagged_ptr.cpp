@@ -0,0 +1,177 @@
+// In this program, we check the generation counter of `zstl::atomic_tagged_ptr`:
+//   every successful store, exchange and compare_exchange bumps it, snapshots
+//   carry it, and get() hands back the plain tagged_ptr without it
+// A compare_exchange holding a snapshot from before an A -> B -> A swap must fail
+// Finally several threads pop and push the nodes of a Treiber stack over and
+//   over; at the end every node is on the stack exactly once
+
+#include <ZSTL/atomic_tagged_ptr.hpp>
+
+#include <atomic>
+#include <thread>
+#include <vector>
+#include <iostream>
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+
+
+struct node {
+    int value { 0 };
+    std::atomic<node *> next { nullptr };
+};
+
+struct leaf {
+    double weight { 0.0 };
+};
+
+using pointer_type = zstl::atomic_tagged_ptr<node, leaf>;
+using value_type = pointer_type::value_type;
+
+// a null pointer stays the untyped null of the tagged_ptr
+value_type wrap(node *p) {
+    return p ? value_type(p) : value_type(nullptr);
+}
+
+
+int main() {
+    node a { 1 }, b { 2 }, c { 3 };
+    leaf l { 0.5 };
+
+    {
+        // each successful write bumps the generation, a failed compare_exchange does not
+        pointer_type p;
+        assert(p.load_snapshot().generation() == 0u && p.load() == value_type(nullptr));
+
+        p.store(&a);
+        assert(p.load_snapshot().generation() == 1u && p.load().cast<node>() == &a);
+
+        [[maybe_unused]] value_type old = p.exchange(&l);
+        assert(old.cast<node>() == &a);
+        assert(p.load_snapshot().generation() == 2u && p.load().cast<leaf>() == &l);
+
+        pointer_type::snapshot s = p.load_snapshot();
+        [[maybe_unused]] bool swapped = p.compare_exchange_strong(s, &b);
+        assert(swapped && p.load_snapshot().generation() == 3u);
+
+        // `s` is now stale: the exchange fails and reloads it
+        swapped = p.compare_exchange_strong(s, &c);
+        assert(!swapped && s.generation() == 3u && s.get().cast<node>() == &b);
+        assert(p.load_snapshot().generation() == 3u);
+
+        // compare_exchange_weak may fail spuriously, but not forever
+        while (!p.compare_exchange_weak(s, &c)) {}
+        assert(p.load_snapshot().generation() == 4u && p.load().cast<node>() == &c);
+
+        // the constructor starts at generation 0
+        pointer_type q { &a };
+        assert(q.load_snapshot().generation() == 0u && q.load().cast<node>() == &a);
+        std::cout << "generation ok" << '\n';
+    }
+    {
+        // A -> B -> A between the load and the compare_exchange is seen
+        pointer_type p { &a };
+        pointer_type::snapshot s = p.load_snapshot();
+
+        p.store(&b);
+        p.store(&a);
+        // same pointer, same tag: only the generation tells them apart
+        assert(p.load() == s.get());
+
+        [[maybe_unused]] bool swapped = p.compare_exchange_strong(s, &c);
+        assert(!swapped && p.load().cast<node>() == &a);
+        assert(s.get().cast<node>() == &a && s.generation() == 2u);
+
+        // with the fresh snapshot it goes through
+        swapped = p.compare_exchange_strong(s, &c);
+        assert(swapped && p.load().cast<node>() == &c);
+        std::cout << "ABA ok" << '\n';
+    }
+    {
+        // get() strips the generation: the word is the plain tagged_ptr again
+        pointer_type p { &l };
+        for (int i = 0; i < 5; ++i) {
+            p.store(&l);
+        }
+        [[maybe_unused]] pointer_type::snapshot s = p.load_snapshot();
+        assert(s.generation() == 5u);
+        assert(s.get() == value_type(&l) && s.get().raw() == value_type(&l).raw());
+        assert(s.get().points_to_type<leaf>() && s.get().cast<leaf>() == &l);
+        assert(s.get().cast<node>() == nullptr);
+
+        // the counter wraps after 2^GENERATION_BITS writes without touching the pointer
+        for (std::uint64_t i { 0u }; i < (std::uint64_t { 1u } << pointer_type::GENERATION_BITS) - 5u; ++i) {
+            p.store(&l);
+        }
+        assert(p.load_snapshot().generation() == 0u && p.load().cast<leaf>() == &l);
+        std::cout << "snapshot ok" << '\n';
+    }
+    {
+        // a Treiber stack: threads keep popping a node and pushing it back, which
+        //   is exactly the ABA pattern, and no node may be lost or duplicated
+        static constexpr int N_NODES { 64 };
+        static constexpr int N_THREADS { 4 };
+        static constexpr int N_ROUNDS { 20000 };
+
+        std::vector<node> nodes(N_NODES);
+        pointer_type head;
+
+        auto push = [&head](node *n) {
+            pointer_type::snapshot s = head.load_snapshot(std::memory_order_relaxed);
+            do {
+                n->next.store(s.get().cast<node>(), std::memory_order_relaxed);
+            } while (!head.compare_exchange_weak(s, n, std::memory_order_release, std::memory_order_relaxed));
+        };
+        auto pop = [&head]() -> node * {
+            pointer_type::snapshot s = head.load_snapshot(std::memory_order_acquire);
+            while (node *top = s.get().cast<node>()) {
+                node *next = top->next.load(std::memory_order_relaxed);
+                if (head.compare_exchange_weak(s, wrap(next), std::memory_order_acquire, std::memory_order_acquire)) {
+                    return top;
+                }
+            }
+            return nullptr;
+        };
+
+        for (int i = 0; i < N_NODES; ++i) {
+            nodes[i].value = i;
+            push(&nodes[i]);
+        }
+
+        std::atomic<bool> emptyPop { false };
+        {
+            std::vector<std::jthread> threads;
+            for (int t = 0; t < N_THREADS; ++t) {
+                threads.emplace_back(
+                    [&] {
+                        for (int r = 0; r < N_ROUNDS; ++r) {
+                            node *n = pop();
+                            if (!n) {
+                                // at most N_THREADS nodes are out at once
+                                emptyPop = true;
+                                continue;
+                            }
+                            push(n);
+                        }
+                    }
+                );
+            }
+        }
+        assert(!emptyPop);
+
+        std::vector<int> seen(N_NODES, 0);
+        int length { 0 };
+        for (node *n = pop(); n; n = pop()) {
+            ++seen[n->value];
+            ++length;
+        }
+        assert(length == N_NODES);
+        for (int i = 0; i < N_NODES; ++i) {
+            assert(seen[i] == 1);
+        }
+        assert(head.load() == value_type(nullptr));
+        std::cout << "treiber stack ok" << std::endl;
+    }
+
+    return 0;
+}
@@ -0,0 +1,248 @@
+// In this program, we check `zstl::bit_vector` against a std::vector<bool>
+// The bulk operations and popcount are run through every kernel the CPU can execute
+//   (scalar, SSE2, AVX2, AVX-512, POPCNT and AVX-512 VPOPCNTDQ) over every word
+//   count from 0 to 64, and must agree with the scalar loops
+// rank1/select1 are checked at every position of vectors whose sizes and set bits
+//   sit on word (64), block (512) and superblock (4096) boundaries, and across
+//   several select samples (one every 4096 set bits)
+
+#include <ZSTL/bit_vector.hpp>
+
+#include <vector>
+#include <random>
+#include <iostream>
+#include <stdexcept>
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+
+
+using word_type = zstl::bit_vector::word_type;
+
+zstl::bit_vector from_bools(const std::vector<bool> &bits) {
+    zstl::bit_vector v;
+    for (bool b : bits) {
+        v.push_back(b);
+    }
+    return v;
+}
+
+// every rank and every select of `v`, which must hold the bits of `bits`
+void check_rank_select(zstl::bit_vector &v, const std::vector<bool> &bits) {
+    v.build_rank_select();
+
+    std::size_t ones { 0uz };
+    for (std::size_t pos { 0uz }; pos < bits.size(); ++pos) {
+        assert(v.rank1(pos) == ones);
+        assert(v.rank0(pos) == pos - ones);
+        if (bits[pos]) {
+            assert(v.select1(ones) == pos);
+            ++ones;
+        }
+    }
+    assert(v.rank1(bits.size()) == ones && v.count() == ones);
+
+    [[maybe_unused]] bool threw = false;
+    try {
+        static_cast<void>(v.select1(ones));
+    } catch (const std::out_of_range &) {
+        threw = true;
+    }
+    assert(threw);
+}
+
+template <zstl::detail::bit_vector::bitwise_op Op, typename Kernel>
+void check_bitwise_kernel(Kernel kernel, std::mt19937_64 &rng) {
+    namespace impl = zstl::detail::bit_vector;
+    for (std::size_t n { 0uz }; n <= 64uz; ++n) {
+        // one spare word in front for an unaligned start
+        std::vector<word_type> a(n + 1uz);
+        std::vector<word_type> b(n + 1uz);
+        for (std::size_t i { 0uz }; i <= n; ++i) {
+            a[i] = rng();
+            b[i] = rng();
+        }
+        for (std::size_t shift : { 0uz, 1uz }) {
+            if (shift > n) { continue; }
+            std::vector<word_type> expected(a.begin() + shift, a.end());
+            impl::bitwise_scalar<Op>(expected.data(), b.data() + shift, n + 1uz - shift);
+
+            std::vector<word_type> got(a.begin() + shift, a.end());
+            kernel(got.data(), b.data() + shift, n + 1uz - shift);
+            assert(got == expected);
+        }
+    }
+}
+
+template <zstl::detail::bit_vector::bitwise_op Op>
+void check_bitwise_levels(std::mt19937_64 &rng) {
+    namespace impl = zstl::detail::bit_vector;
+    check_bitwise_kernel<Op>(impl::bitwise_scalar<Op>, rng);
+#ifdef ZSTL_SIMD_X86
+    zstl::simd::level best = zstl::simd::detected_level();
+    if (best >= zstl::simd::level::sse2) {
+        check_bitwise_kernel<Op>(impl::bitwise_sse2<Op>, rng);
+    }
+    if (best >= zstl::simd::level::avx2) {
+        check_bitwise_kernel<Op>(impl::bitwise_avx2<Op>, rng);
+    }
+    if (best >= zstl::simd::level::avx512) {
+        check_bitwise_kernel<Op>(impl::bitwise_avx512<Op>, rng);
+    }
+#endif
+}
+
+template <typename Popcount>
+void check_popcount_kernel([[maybe_unused]] Popcount popcount, std::mt19937_64 &rng) {
+    namespace impl = zstl::detail::bit_vector;
+    // past 16 words the VPOPCNTDQ kernel runs its two accumulators
+    for (std::size_t n { 0uz }; n <= 64uz; ++n) {
+        std::vector<word_type> w(n + 1uz);
+        for (word_type &x : w) {
+            x = rng() & rng();
+        }
+        if (n > 0uz) {
+            w[n - 1uz] = ~word_type { 0u };
+        }
+        assert(popcount(w.data(), n) == impl::popcount_scalar(w.data(), n));
+        assert(popcount(w.data() + 1, n) == impl::popcount_scalar(w.data() + 1, n));
+    }
+}
+
+
+int main() {
+    namespace impl = zstl::detail::bit_vector;
+    std::mt19937_64 rng(99u);
+
+    {
+        // bulk operations at every level the CPU supports
+        check_bitwise_levels<impl::bitwise_op::and_>(rng);
+        check_bitwise_levels<impl::bitwise_op::or_>(rng);
+        check_bitwise_levels<impl::bitwise_op::xor_>(rng);
+        check_bitwise_levels<impl::bitwise_op::and_not>(rng);
+
+        // and through the public operators
+        for (std::size_t n : { 0uz, 1uz, 63uz, 64uz, 65uz, 1000uz, 4097uz }) {
+            std::vector<bool> x(n);
+            std::vector<bool> y(n);
+            for (std::size_t i { 0uz }; i < n; ++i) {
+                x[i] = rng() & 1u;
+                y[i] = rng() & 1u;
+            }
+            zstl::bit_vector a = from_bools(x);
+            zstl::bit_vector b = from_bools(y);
+            zstl::bit_vector andV = a;
+            zstl::bit_vector orV = a;
+            zstl::bit_vector xorV = a;
+            zstl::bit_vector andNotV = a;
+            andV &= b;
+            orV |= b;
+            xorV ^= b;
+            andNotV.and_not(b);
+            for (std::size_t i { 0uz }; i < n; ++i) {
+                assert(andV[i] == (x[i] && y[i]));
+                assert(orV[i] == (x[i] || y[i]));
+                assert(xorV[i] == (x[i] != y[i]));
+                assert(andNotV[i] == (x[i] && !y[i]));
+            }
+        }
+
+        zstl::bit_vector a(10uz);
+        zstl::bit_vector b(11uz);
+        [[maybe_unused]] bool threw = false;
+        try {
+            a &= b;
+        } catch (const std::invalid_argument &) {
+            threw = true;
+        }
+        assert(threw);
+        std::cout << "bitwise ok" << '\n';
+    }
+    {
+        check_popcount_kernel(impl::popcount, rng);
+#ifdef ZSTL_SIMD_X86
+        __builtin_cpu_init();
+        if (__builtin_cpu_supports("popcnt")) {
+            check_popcount_kernel(impl::popcount_popcnt, rng);
+        }
+        if (__builtin_cpu_supports("avx512vpopcntdq") && __builtin_cpu_supports("popcnt")) {
+            check_popcount_kernel(impl::popcount_avx512, rng);
+            std::cout << "popcount (with VPOPCNTDQ) ok" << '\n';
+        } else {
+            std::cout << "popcount ok (no VPOPCNTDQ on this CPU, that kernel is skipped)" << '\n';
+        }
+#else
+        std::cout << "popcount ok" << '\n';
+#endif
+    }
+    {
+        // resize fills, and keeps the bits past size() zero
+        zstl::bit_vector v(70uz, true);
+        assert(v.count() == 70uz && v.word_count() == 2uz);
+        assert(v.words()[1] == (word_type { 1u } << 6) - 1u);
+        v.resize(130uz, true);
+        assert(v.count() == 130uz);
+        v.resize(65uz);
+        assert(v.count() == 65uz && v.words()[1] == 1u);
+        v.resize(200uz, false);
+        assert(v.count() == 65uz && !v[199]);
+        std::cout << "resize ok" << '\n';
+    }
+    {
+        // sizes and set bits on word, block and superblock boundaries
+        for (std::size_t n : { 0uz, 1uz, 63uz, 64uz, 65uz, 511uz, 512uz, 513uz, 4095uz, 4096uz, 4097uz, 8193uz }) {
+            std::vector<bool> bits(n);
+            for (std::size_t i { 0uz }; i < n; ++i) {
+                bits[i] = i % 64uz == 0uz || i % 64uz == 63uz || i % 512uz == 511uz;
+            }
+            if (n > 0uz) {
+                bits[n - 1uz] = true;
+            }
+            zstl::bit_vector v = from_bools(bits);
+            check_rank_select(v, bits);
+        }
+
+        // all ones: several select samples, each at a superblock start
+        std::vector<bool> dense(3uz * 4096uz + 77uz, true);
+        zstl::bit_vector d = from_bools(dense);
+        check_rank_select(d, dense);
+
+        // one set bit per superblock, exactly at its start, and runs of empty superblocks
+        std::vector<bool> sparse(20uz * 4096uz);
+        for (std::size_t i { 0uz }; i < sparse.size(); i += 4096uz) {
+            sparse[i] = i < 5uz * 4096uz || i >= 15uz * 4096uz;
+        }
+        zstl::bit_vector s = from_bools(sparse);
+        check_rank_select(s, sparse);
+
+        // random densities
+        for (unsigned density : { 1u, 50u, 99u }) {
+            std::vector<bool> bits(50000uz);
+            for (std::size_t i { 0uz }; i < bits.size(); ++i) {
+                bits[i] = rng() % 100u < density;
+            }
+            zstl::bit_vector v = from_bools(bits);
+            check_rank_select(v, bits);
+        }
+        std::cout << "rank/select ok" << '\n';
+    }
+    {
+        // any modification drops the index
+        zstl::bit_vector v(100uz);
+        v.build_rank_select();
+        v.set(3uz);
+        assert(!v.has_rank_select());
+        [[maybe_unused]] bool threw = false;
+        try {
+            static_cast<void>(v.rank1(10uz));
+        } catch (const std::logic_error &) {
+            threw = true;
+        }
+        assert(threw);
+        v.build_rank_select();
+        assert(v.rank1(10uz) == 1uz && v.select1(0uz) == 3uz);
+        std::cout << "index invalidation ok" << std::endl;
+    }
+
+    return 0;
+}
@@ -0,0 +1,239 @@
+// In this program, we exercise `zstl::concurrent_vector` from several threads
+// Writers append with push_back and grow_by while readers index everything below
+//   size(), which must always be constructed; at the end every appended value
+//   is there exactly once
+// We also make a constructor throw: the appends after it are refused until
+//   clear(), and clear() destroys every element that was constructed
+
+#include <ZSTL/concurrent_vector.hpp>
+
+#include <atomic>
+#include <thread>
+#include <vector>
+#include <iostream>
+#include <stdexcept>
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+
+
+// an element that checks itself: `check` is derived from `value`, so a reader
+//   that sees a slot before its constructor finished finds a mismatch
+struct stamped {
+    std::uint64_t value { 0u };
+    std::uint64_t check { ~std::uint64_t { 0u } };
+
+    stamped(std::uint64_t value) : value(value), check(~value) {}
+
+    bool intact() const {
+        return this->check == ~this->value;
+    }
+};
+
+// counts live objects; constructing the value `poison` throws, and so does
+//   every copy once `copies` reaches 0
+struct fragile {
+    static inline std::atomic<int> live { 0 };
+    static inline int poison { -1 };
+    static inline int copies { -1 };
+
+    int value { 0 };
+
+    fragile(int value) : value(value) {
+        if (value == poison) {
+            throw std::runtime_error("fragile");
+        }
+        ++live;
+    }
+    fragile(const fragile &other) : value(other.value) {
+        if (value == poison || copies-- == 0) {
+            throw std::runtime_error("fragile");
+        }
+        ++live;
+    }
+    ~fragile() { --live; }
+};
+
+
+int main() {
+    static constexpr unsigned N_WRITERS { 4u };
+    static constexpr unsigned N_READERS { 2u };
+    static constexpr std::uint64_t N_PER_WRITER { 20000u };
+    static constexpr std::uint64_t BATCH { 7u };
+
+    {
+        // writers append (thread, sequence) pairs, half of them through grow_by,
+        //   while readers keep checking every index below size()
+        zstl::concurrent_vector<stamped, 8uz> v;
+        std::atomic<unsigned> writersDone { 0u };
+        std::atomic<bool> readerFailed { false };
+
+        std::vector<std::jthread> threads;
+        for (unsigned r = 0u; r < N_READERS; ++r) {
+            threads.emplace_back(
+                [&] {
+                    std::size_t seen { 0uz };
+                    while (writersDone.load() < N_WRITERS || seen < v.size()) {
+                        std::size_t n = v.size();
+                        // size() never goes back
+                        if (n < seen) {
+                            readerFailed = true;
+                        }
+                        for (std::size_t i = seen; i < n; ++i) {
+                            if (!v[i].intact()) {
+                                readerFailed = true;
+                            }
+                        }
+                        seen = n;
+                    }
+                }
+            );
+        }
+        for (unsigned w = 0u; w < N_WRITERS; ++w) {
+            threads.emplace_back(
+                [&, w] {
+                    std::uint64_t base = std::uint64_t { w } * N_PER_WRITER;
+                    std::uint64_t i { 0u };
+                    while (i < N_PER_WRITER) {
+                        if (w % 2u == 0u || N_PER_WRITER - i < BATCH) {
+                            [[maybe_unused]] stamped &e = v.push_back(stamped(base + i));
+                            assert(e.value == base + i);
+                            ++i;
+                        } else {
+                            [[maybe_unused]] std::size_t first = v.grow_by(BATCH, stamped(base + i));
+                            // the batch shares one value, its slots are contiguous
+                            for (std::size_t k { 0uz }; k < BATCH; ++k) {
+                                assert(v[first + k].value == base + i);
+                            }
+                            i += BATCH;
+                        }
+                    }
+                    ++writersDone;
+                }
+            );
+        }
+        threads.clear();
+
+        assert(!readerFailed);
+        assert(v.size() == N_WRITERS * N_PER_WRITER);
+
+        // every push_back value once, every grow_by value BATCH times
+        std::vector<unsigned> hits(N_WRITERS * N_PER_WRITER, 0u);
+        for (std::size_t i { 0uz }; i < v.size(); ++i) {
+            assert(v[i].intact());
+            ++hits[v.at(i).value];
+        }
+        for (unsigned w = 0u; w < N_WRITERS; ++w) {
+            std::uint64_t base = std::uint64_t { w } * N_PER_WRITER;
+            for (std::uint64_t i { 0u }; i < N_PER_WRITER; ++i) {
+                [[maybe_unused]] unsigned h = hits[base + i];
+                assert(h == 1u || (w % 2u == 1u && (h == BATCH || h == 0u)));
+            }
+        }
+
+        [[maybe_unused]] bool threw = false;
+        try {
+            static_cast<void>(v.at(v.size()));
+        } catch (const std::out_of_range &) {
+            threw = true;
+        }
+        assert(threw);
+        std::cout << "concurrent append ok" << '\n';
+    }
+    {
+        // a throwing constructor refuses later appends until clear()
+        {
+            zstl::concurrent_vector<fragile, 4uz> v;
+            for (int i = 0; i < 10; ++i) {
+                v.push_back(fragile(i));
+            }
+            assert(v.size() == 10uz && fragile::live == 10);
+
+            fragile::poison = 99;
+            [[maybe_unused]] bool threw = false;
+            try {
+                v.emplace_back(99);
+            } catch (const std::runtime_error &) {
+                threw = true;
+            }
+            assert(threw && v.size() == 10uz && fragile::live == 10);
+
+            // the hole cannot be published past, so appending is refused
+            //   instead of silently dropping elements
+            [[maybe_unused]] bool refused = false;
+            try {
+                v.emplace_back(11);
+            } catch (const std::runtime_error &) {
+                refused = true;
+            }
+            assert(refused && v.size() == 10uz && fragile::live == 10);
+            refused = false;
+            try {
+                static_cast<void>(v.grow_by(3uz, fragile(12)));
+            } catch (const std::runtime_error &) {
+                refused = true;
+            }
+            assert(refused && fragile::live == 10);
+
+            // clear() destroys the elements and makes the container usable again
+            v.clear();
+            assert(v.empty() && fragile::live == 0);
+            fragile::poison = -1;
+            v.emplace_back(1);
+            assert(v.size() == 1uz && v[0].value == 1 && fragile::live == 1);
+
+            // a grow_by that throws half way destroys the part it built
+            fragile::copies = 2;
+            threw = false;
+            try {
+                static_cast<void>(v.grow_by(3uz, fragile(4)));
+            } catch (const std::runtime_error &) {
+                threw = true;
+            }
+            fragile::copies = -1;
+            assert(threw && v.size() == 1uz && fragile::live == 1);
+
+            refused = false;
+            try {
+                v.emplace_back(2);
+            } catch (const std::runtime_error &) {
+                refused = true;
+            }
+            assert(refused && v.size() == 1uz);
+        }
+        assert(fragile::live == 0);
+
+        // appends racing with the failure are still constructed, and destroyed by clear()
+        {
+            zstl::concurrent_vector<fragile, 4uz> v;
+            fragile::poison = 500;
+            std::vector<std::jthread> threads;
+            for (int t = 0; t < 4; ++t) {
+                threads.emplace_back(
+                    [&v, t] {
+                        for (int i = 0; i < 200; ++i) {
+                            try {
+                                v.emplace_back(t * 200 + i);
+                            } catch (const std::runtime_error &) {
+                                // either the poisoned one or refused afterwards
+                            }
+                        }
+                    }
+                );
+            }
+            threads.clear();
+
+            assert(v.size() <= 799uz);
+            for (std::size_t i { 0uz }; i < v.size(); ++i) {
+                assert(v[i].value != 500);
+            }
+            v.clear();
+            assert(fragile::live == 0);
+            fragile::poison = -1;
+        }
+        assert(fragile::live == 0);
+        std::cout << "throwing constructor ok" << std::endl;
+    }
+
+    return 0;
+}
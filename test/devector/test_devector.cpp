@@ -0,0 +1,168 @@
+// In this program, we run `zstl::devector` through random sequences of pushes and
+//   pops at both ends and compare it with a std::deque after every step
+// The sequences are biased towards one end at a time so that the elements
+//   walk across the buffer and both the in-place recentering and the regrowth
+//   are hit many times, for a trivially copyable type (memmove) and for
+//   std::string (element-wise relocation)
+// We also check erase, resize, and that swap hands every buffer over together
+//   with the memory_resource it came from
+
+#include <ZSTL/devector.hpp>
+
+#include <deque>
+#include <string>
+#include <random>
+#include <iostream>
+#include <algorithm>
+#include <cassert>
+#include <cstddef>
+
+
+// counts the bytes it has handed out, so that a buffer freed through the wrong
+//   resource shows up
+class counting_resource : public zstl::pmr::memory_resource {
+public:
+    std::ptrdiff_t inUse { 0 };
+
+private:
+    void *do_allocate(std::size_t bytes, std::size_t alignment) override {
+        this->inUse += static_cast<std::ptrdiff_t>(bytes);
+        return zstl::pmr::new_delete_resource()->allocate(bytes, alignment);
+    }
+
+    void do_deallocate(void *p, std::size_t bytes, std::size_t alignment) override {
+        this->inUse -= static_cast<std::ptrdiff_t>(bytes);
+        zstl::pmr::new_delete_resource()->deallocate(p, bytes, alignment);
+    }
+
+    bool do_is_equal(const zstl::pmr::memory_resource &other) const noexcept override {
+        return this == &other;
+    }
+};
+
+template <typename T>
+void check_equal([[maybe_unused]] const zstl::devector<T> &v, const std::deque<T> &expected) {
+    assert(v.size() == expected.size() && v.empty() == expected.empty());
+    assert(std::equal(v.begin(), v.end(), expected.begin(), expected.end()));
+    if (!expected.empty()) {
+        assert(v.front() == expected.front() && v.back() == expected.back());
+    }
+    assert(v.front_free_capacity() + v.size() + v.back_free_capacity() == v.capacity());
+}
+
+template <typename T, typename Make>
+void random_churn(Make make, std::mt19937 &rng) {
+    zstl::devector<T> v;
+    std::deque<T> expected;
+    int counter = 0;
+
+    // percentages of push_back, push_front, pop_back, pop_front
+    const int phases[][4] {
+        { 70, 10, 10, 10 },   // grow at the back
+        { 10, 70, 10, 10 },   // grow at the front
+        { 45, 0, 0, 55 },     // sliding window to the right
+        { 0, 45, 55, 0 },     // sliding window to the left
+        { 25, 25, 25, 25 },
+        { 5, 5, 45, 45 }      // drain
+    };
+    for (int round = 0; round < 3; ++round) {
+        for (const auto &phase : phases) {
+            for (int i = 0; i < 3000; ++i) {
+                int r = static_cast<int>(rng() % 100u);
+                if (r < phase[0]) {
+                    v.push_back(make(counter));
+                    expected.push_back(make(counter));
+                    ++counter;
+                } else if (r < phase[0] + phase[1]) {
+                    v.push_front(make(counter));
+                    expected.push_front(make(counter));
+                    ++counter;
+                } else if (r < phase[0] + phase[1] + phase[2]) {
+                    if (!expected.empty()) {
+                        v.pop_back();
+                        expected.pop_back();
+                    }
+                } else if (!expected.empty()) {
+                    v.pop_front();
+                    expected.pop_front();
+                }
+                assert(v.size() == expected.size());
+                if (!expected.empty()) {
+                    assert(v.front() == expected.front() && v.back() == expected.back());
+                }
+            }
+            check_equal(v, expected);
+            if (!expected.empty()) {
+                [[maybe_unused]] std::size_t k = rng() % expected.size();
+                assert(v[k] == expected[k] && v.at(k) == expected[k]);
+            }
+        }
+    }
+
+    // erase near either end and in the middle
+    while (expected.size() > 3uz) {
+        std::size_t k = rng() % expected.size();
+        std::size_t count = std::min<std::size_t>(rng() % 4u, expected.size() - k);
+        [[maybe_unused]] auto it = v.erase(v.begin() + k, v.begin() + k + count);
+        expected.erase(expected.begin() + k, expected.begin() + k + count);
+        assert(it == v.begin() + k);
+        check_equal(v, expected);
+    }
+}
+
+
+int main() {
+    std::mt19937 rng(17u);
+
+    {
+        random_churn<int>([](int i) { return i; }, rng);
+        std::cout << "int vs std::deque ok" << '\n';
+    }
+    {
+        // long enough to defeat the small string optimization
+        random_churn<std::string>([](int i) { return std::string(20uz, 'x') + std::to_string(i); }, rng);
+        std::cout << "std::string vs std::deque ok" << '\n';
+    }
+    {
+        // resize at the back, with and without a value
+        zstl::devector<std::string> v { "a", "b" };
+        v.push_front("z");
+        v.resize(5uz, "y");
+        assert(v.size() == 5uz && v.front() == "z" && v[3] == "y" && v.back() == "y");
+        v.resize(1uz);
+        assert(v.size() == 1uz && v.front() == "z");
+        v.resize(3uz);
+        assert(v.size() == 3uz && v.back().empty());
+        std::cout << "resize ok" << '\n';
+    }
+    {
+        // swap exchanges the allocators with the buffers
+        counting_resource ra;
+        counting_resource rb;
+        {
+            zstl::devector<int> a { zstl::pmr::polymorphic_allocator<int>(&ra) };
+            zstl::devector<int> b { zstl::pmr::polymorphic_allocator<int>(&rb) };
+            for (int i = 0; i < 100; ++i) {
+                a.push_front(i);
+            }
+            b.push_back(-1);
+            [[maybe_unused]] std::ptrdiff_t aBytes = ra.inUse;
+            [[maybe_unused]] std::ptrdiff_t bBytes = rb.inUse;
+
+            a.swap(b);
+            assert(a.get_allocator().resource() == &rb && b.get_allocator().resource() == &ra);
+            assert(a.size() == 1uz && a.front() == -1);
+            assert(b.size() == 100uz && b.front() == 99 && b.back() == 0);
+
+            // growing each one allocates from the resource it now holds
+            for (int i = 0; i < 1000; ++i) {
+                a.push_back(i);
+            }
+            assert(ra.inUse == aBytes && rb.inUse > bBytes);
+        }
+        assert(ra.inUse == 0 && rb.inUse == 0);
+        std::cout << "swap ok" << std::endl;
+    }
+
+    return 0;
+}
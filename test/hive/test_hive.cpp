@@ -0,0 +1,212 @@
+// In this program, we run `zstl::hive` through long random sequences of inserts
+//   and erases and compare it with a std::multiset holding the same values
+// After every step the element count must match; every few hundred steps the
+//   contents are compared in full, walking forward and backward (which exercises
+//   the jumps over erased runs), and every element must still sit at the address
+//   it was inserted at
+// We also check erasing ranges, blocks going back to the memory_resource,
+//   get_iterator, copy/move and that no element is leaked or destroyed twice
+
+#include <ZSTL/hive.hpp>
+
+#include <set>
+#include <vector>
+#include <random>
+#include <iostream>
+#include <algorithm>
+#include <cassert>
+#include <cstddef>
+
+
+// counts live objects, so that leaks and double destruction show up
+struct tracked {
+    static inline int live { 0 };
+
+    int value { 0 };
+
+    tracked(int value) : value(value) { ++live; }
+    tracked(const tracked &other) : value(other.value) { ++live; }
+    ~tracked() { --live; }
+};
+
+using tracked_hive = zstl::hive<tracked>;
+
+// the hive holds exactly the values of `expected`, forward and backward
+void check_contents(const tracked_hive &h, [[maybe_unused]] const std::multiset<int> &expected) {
+    assert(h.size() == expected.size() && h.empty() == expected.empty());
+
+    std::vector<int> forward;
+    for (const tracked &x : h) {
+        forward.push_back(x.value);
+    }
+    assert(forward.size() == expected.size());
+
+    std::vector<int> backward;
+    for (auto it = h.end(); it != h.begin();) {
+        --it;
+        backward.push_back(it->value);
+    }
+    std::reverse(backward.begin(), backward.end());
+    assert(backward == forward);
+
+    std::sort(forward.begin(), forward.end());
+    assert(std::equal(forward.begin(), forward.end(), expected.begin(), expected.end()));
+}
+
+
+int main() {
+    std::mt19937 rng(31u);
+
+    {
+        // random churn: phases that grow, shrink to nothing and hover around a size
+        tracked_hive h;
+        std::multiset<int> expected;
+        // the address of every live element, with the value it must still hold
+        std::vector<std::pair<const tracked *, int>> live;
+
+        auto insertOne = [&] {
+            int value = static_cast<int>(rng() % 1000u);
+            auto it = h.emplace(value);
+            assert(it->value == value);
+            live.emplace_back(&*it, value);
+            expected.insert(value);
+        };
+        auto eraseOne = [&] {
+            std::size_t k = rng() % live.size();
+            auto [p, value] = live[k];
+            auto it = h.get_iterator(p);
+            assert(it != h.end() && &*it == p && it->value == value);
+            h.erase(it);
+            expected.erase(expected.find(value));
+            live[k] = live.back();
+            live.pop_back();
+        };
+
+        const int insertPercent[] { 90, 50, 10, 55, 0, 70, 45 };
+        std::size_t step { 0uz };
+        for (int percent : insertPercent) {
+            for (int i = 0; i < 6000; ++i, ++step) {
+                if (live.empty() || static_cast<int>(rng() % 100u) < percent) {
+                    insertOne();
+                } else {
+                    eraseOne();
+                }
+                assert(h.size() == expected.size());
+                if (step % 500uz == 0uz) {
+                    check_contents(h, expected);
+                    for ([[maybe_unused]] auto [p, value] : live) {
+                        assert(p->value == value);
+                    }
+                }
+            }
+            check_contents(h, expected);
+            if (live.empty()) {
+                // every block went back to the memory_resource
+                assert(h.block_count() == 0uz && h.capacity() == 0uz);
+            }
+        }
+        assert(tracked::live == static_cast<int>(expected.size()));
+    }
+    assert(tracked::live == 0);
+    std::cout << "random insert/erase ok" << '\n';
+
+    {
+        // erase every other element, then runs of every length, then refill the holes
+        tracked_hive h;
+        std::multiset<int> expected;
+        for (int i = 0; i < 1000; ++i) {
+            h.insert(tracked(i));
+            expected.insert(i);
+        }
+        [[maybe_unused]] std::size_t capacity = h.capacity();
+
+        for (auto it = h.begin(); it != h.end();) {
+            if (it->value % 2 == 1) {
+                expected.erase(it->value);
+                it = h.erase(it);
+            } else {
+                ++it;
+            }
+        }
+        check_contents(h, expected);
+
+        // runs of 1, 2, 3, ... erased slots merge with their neighbours
+        std::size_t runLength { 1uz };
+        for (auto it = h.begin(); it != h.end();) {
+            for (std::size_t k { 0uz }; k < runLength && it != h.end(); ++k) {
+                expected.erase(it->value);
+                it = h.erase(it);
+            }
+            if (it != h.end()) {
+                ++it;
+            }
+            ++runLength;
+        }
+        check_contents(h, expected);
+
+        // erased slots are reused before any new block
+        while (h.size() < 1000uz) {
+            int value = 5000 + static_cast<int>(h.size());
+            h.insert(tracked(value));
+            expected.insert(value);
+        }
+        assert(h.capacity() == capacity);
+        check_contents(h, expected);
+        std::cout << "erased runs ok" << '\n';
+    }
+    assert(tracked::live == 0);
+
+    {
+        // range erase, including up to end()
+        tracked_hive h;
+        std::multiset<int> expected;
+        for (int i = 0; i < 300; ++i) {
+            h.insert(tracked(i % 7));
+            expected.insert(i % 7);
+        }
+        auto first = std::next(h.begin(), 10);
+        auto last = std::next(h.begin(), 250);
+        for (auto it = first; it != last; ++it) {
+            expected.erase(expected.find(it->value));
+        }
+        [[maybe_unused]] auto after = h.erase(first, last);
+        assert(after == h.get_iterator(&*after));
+        check_contents(h, expected);
+
+        for (auto it = std::next(h.begin(), 5); it != h.end(); ++it) {
+            expected.erase(expected.find(it->value));
+        }
+        // end() moves when the tail block is released, so compare after erasing
+        [[maybe_unused]] auto afterAll = h.erase(std::next(h.begin(), 5), h.end());
+        assert(afterAll == h.end());
+        check_contents(h, expected);
+        std::cout << "range erase ok" << '\n';
+    }
+    assert(tracked::live == 0);
+
+    {
+        // copy makes independent elements, move steals the blocks
+        tracked_hive h { 1, 2, 3, 4, 5 };
+        h.erase(std::next(h.begin(), 2));
+        std::multiset<int> expected { 1, 2, 4, 5 };
+
+        tracked_hive copy(h);
+        check_contents(copy, expected);
+        assert(tracked::live == 8);
+
+        [[maybe_unused]] const tracked *p = &*h.begin();
+        tracked_hive stolen(std::move(h));
+        assert(h.empty() && h.begin() == h.end() && &*stolen.begin() == p);
+        check_contents(stolen, expected);
+
+        h.insert(tracked(9));
+        check_contents(h, { 9 });
+
+        copy.clear();
+        assert(copy.empty() && copy.capacity() == 0uz && tracked::live == 5);
+        std::cout << "copy/move/clear ok" << std::endl;
+    }
+    assert(tracked::live == 0);
+
+    return 0;
+}
@@ -0,0 +1,174 @@
+// In this program, we append rows to a `zstl::jagged_vector`, whole with
+//   push_back_row and element by element with a row_builder, and check the
+//   rows, the flattened storage and the row offsets
+// While a builder is open, build_row, push_back_row and clear must throw
+//   std::logic_error and leave the container as it was
+
+#include <ZSTL/jagged_vector.hpp>
+
+#include <span>
+#include <string>
+#include <iostream>
+#include <stdexcept>
+#include <type_traits>
+#include <cassert>
+#include <cstddef>
+
+
+using jagged_type = zstl::jagged_vector<int>;
+
+static_assert(!std::is_move_constructible_v<jagged_type::row_builder>);
+static_assert(!std::is_copy_constructible_v<jagged_type::row_builder>);
+
+bool row_is(std::span<const int> row, std::initializer_list<int> expected) {
+    if (row.size() != expected.size()) {
+        return false;
+    }
+    std::size_t i { 0uz };
+    for (int x : expected) {
+        if (row[i++] != x) {
+            return false;
+        }
+    }
+    return true;
+}
+
+
+int main() {
+    {
+        // push_back_row from a list, a span, an iterator range and an empty row
+        jagged_type v;
+        assert(v.empty() && v.total_size() == 0uz);
+
+        v.push_back_row({ 1, 2, 3 });
+        const int more[] = { 4, 5 };
+        v.push_back_row(std::span<const int>(more));
+        const std::string digits = "678";
+        v.push_back_row(digits.begin(), digits.end());
+        v.push_back_row({});
+
+        assert(v.size() == 4uz && v.total_size() == 8uz);
+        assert(row_is(v[0], { 1, 2, 3 }) && row_is(v[1], { 4, 5 }));
+        assert(row_is(v[2], { '6', '7', '8' }) && v.at(3).empty());
+        assert(row_is(v.flat(), { 1, 2, 3, 4, 5, '6', '7', '8' }));
+
+        std::span<const std::size_t> offsets = v.row_offsets();
+        [[maybe_unused]] const std::size_t expected[] = { 0uz, 3uz, 5uz, 8uz, 8uz };
+        assert(offsets.size() == 5uz);
+        for (std::size_t i { 0uz }; i < offsets.size(); ++i) {
+            assert(offsets[i] == expected[i]);
+        }
+
+        // rows are writable in place
+        v[1][0] = 40;
+        assert(v.flat()[3] == 40);
+
+        [[maybe_unused]] bool threw = false;
+        try {
+            static_cast<void>(v.at(4uz));
+        } catch (const std::out_of_range &) {
+            threw = true;
+        }
+        assert(threw);
+
+        // the initializer list constructor gives the same layout
+        const jagged_type w { { 1, 2, 3 }, { 4, 5 } };
+        assert(w.size() == 2uz && row_is(w.back(), { 4, 5 }));
+        std::cout << "push_back_row ok" << '\n';
+    }
+    {
+        // a builder adds its row on finish() or when it goes out of scope
+        jagged_type v { { 1 } };
+        {
+            jagged_type::row_builder b = v.build_row();
+            b.push_back(2);
+            int three = 3;
+            b.push_back(three);
+            b.emplace_back(4);
+            assert(b.size() == 3uz);
+
+            // not visible before it is finished
+            assert(v.size() == 1uz);
+            b.finish();
+            assert(b.size() == 0uz);
+            assert(v.size() == 2uz && row_is(v.back(), { 2, 3, 4 }));
+
+            // finishing twice adds nothing
+            b.finish();
+            assert(v.size() == 2uz);
+        }
+        {
+            jagged_type::row_builder b = v.build_row();
+            b.push_back(5);
+        }
+        assert(v.size() == 3uz && row_is(v.back(), { 5 }));
+
+        // an empty builder adds an empty row
+        v.build_row().finish();
+        assert(v.size() == 4uz && v.back().empty());
+        std::cout << "build_row ok" << '\n';
+    }
+    {
+        // with a builder open, the other ways to change the rows are refused
+        jagged_type v { { 1, 2 } };
+        {
+            jagged_type::row_builder b = v.build_row();
+            b.push_back(3);
+
+            [[maybe_unused]] bool threw = false;
+            try {
+                static_cast<void>(v.build_row());
+            } catch (const std::logic_error &) {
+                threw = true;
+            }
+            assert(threw);
+
+            threw = false;
+            try {
+                v.push_back_row({ 9 });
+            } catch (const std::logic_error &) {
+                threw = true;
+            }
+            assert(threw);
+
+            threw = false;
+            try {
+                v.clear();
+            } catch (const std::logic_error &) {
+                threw = true;
+            }
+            assert(threw);
+
+            // nothing was lost, and the open row is still being built
+            assert(v.size() == 1uz && row_is(v[0], { 1, 2 }));
+            b.push_back(4);
+        }
+        assert(v.size() == 2uz && row_is(v.back(), { 3, 4 }));
+
+        // once it is finished they work again
+        v.push_back_row({ 5 });
+        v.clear();
+        assert(v.empty() && v.total_size() == 0uz && v.row_offsets().size() == 1uz);
+        v.build_row().push_back(6);
+        assert(v.size() == 1uz && row_is(v[0], { 6 }));
+        std::cout << "open builder ok" << '\n';
+    }
+    {
+        // pop_back_row drops the last row and its elements
+        jagged_type v { { 1, 2 }, {}, { 3, 4, 5 } };
+        v.pop_back_row();
+        assert(v.size() == 2uz && v.total_size() == 2uz && v.back().empty());
+        v.pop_back_row();
+        assert(v.size() == 1uz && row_is(v.back(), { 1, 2 }));
+
+        // the freed space is reused by the next row
+        v.push_back_row({ 7 });
+        assert(v.size() == 2uz && row_is(v.flat(), { 1, 2, 7 }));
+        v.pop_back_row();
+        v.pop_back_row();
+        assert(v.empty() && v.total_size() == 0uz);
+        std::cout << "pop_back_row ok" << std::endl;
+    }
+
+    return 0;
+}
@@ -0,0 +1,193 @@
+// In this program, we exercise `zstl::mapped_vector`
+//   by writing files with `write_mapped_file` and mapping them back
+// We also damage the header of a valid file field by field and check that
+//   opening it throws instead of handing out a view past the end of the mapping
+
+#include <ZSTL/mapped_vector.hpp>
+
+#include <string>
+#include <vector>
+#include <fstream>
+#include <numeric>
+#include <algorithm>
+#include <iostream>
+#include <filesystem>
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+
+
+struct alignas(128) wide {
+    std::uint64_t id;
+    double weight;
+};
+
+// a file under the temp directory that is removed at the end of the scope
+struct temp_file {
+    std::string path;
+
+    explicit temp_file(const char *name)
+        : path((std::filesystem::temp_directory_path() / name).string())
+    {}
+
+    ~temp_file() {
+        std::filesystem::remove(this->path);
+    }
+};
+
+// overwrites the header of an existing file
+void patch_header(const std::string &path, const zstl::mapped_header &header) {
+    std::fstream f(path, std::ios::in | std::ios::out | std::ios::binary);
+    f.write(reinterpret_cast<const char *>(&header), sizeof(header));
+}
+
+zstl::mapped_header read_header(const std::string &path) {
+    zstl::mapped_header header;
+    std::ifstream f(path, std::ios::binary);
+    f.read(reinterpret_cast<char *>(&header), sizeof(header));
+    return header;
+}
+
+template <typename T>
+bool open_throws(const std::string &path) {
+    try {
+        zstl::mapped_vector<T> v(path.c_str());
+    } catch (const std::exception &) {
+        return true;
+    }
+    return false;
+}
+
+
+int main() {
+    {
+        // round trip
+        temp_file file("zstl_test_mapped_vector_ints.bin");
+        std::vector<int> data(100000);
+        std::iota(data.begin(), data.end(), -500);
+        zstl::write_mapped_file<int>(file.path.c_str(), data);
+
+        zstl::mapped_vector<int> v(file.path.c_str(), zstl::access_hint::sequential);
+        assert(v.size() == data.size() && !v.empty());
+        assert(v.front() == -500 && v.back() == 99499 && v[1000] == 500);
+        assert(std::equal(v.begin(), v.end(), data.begin()));
+        assert(*v.rbegin() == v.back());
+        assert(reinterpret_cast<std::uintptr_t>(v.data()) % 64u == 0u);
+
+        zstl::mapped_span<int> s = v;
+        assert(s.size() == v.size() && s.data() == v.data());
+
+        [[maybe_unused]] bool threw = false;
+        try {
+            static_cast<void>(v.at(data.size()));
+        } catch (const std::out_of_range &) {
+            threw = true;
+        }
+        assert(threw && v.at(0uz) == -500);
+        std::cout << "round trip ok" << '\n';
+    }
+    {
+        // empty files and over-aligned elements
+        temp_file file("zstl_test_mapped_vector_empty.bin");
+        zstl::write_mapped_file<double>(file.path.c_str(), {});
+        zstl::mapped_vector<double> empty(file.path.c_str());
+        assert(empty.empty() && empty.begin() == empty.end());
+
+        temp_file wideFile("zstl_test_mapped_vector_wide.bin");
+        std::vector<wide> records { { 1u, 0.5 }, { 2u, 1.5 }, { 3u, 2.5 } };
+        zstl::write_mapped_file<wide>(wideFile.path.c_str(), records);
+        zstl::mapped_vector<wide> v(wideFile.path.c_str());
+        assert(read_header(wideFile.path).data_offset == 128u);
+        assert(reinterpret_cast<std::uintptr_t>(v.data()) % alignof(wide) == 0u);
+        assert(v.size() == 3uz && v[2].id == 3u && v[2].weight == 2.5);
+        std::cout << "empty / over-aligned ok" << '\n';
+    }
+    {
+        // move leaves the source empty and keeps the mapping alive
+        temp_file file("zstl_test_mapped_vector_move.bin");
+        std::vector<std::int64_t> data { 7, 8, 9 };
+        zstl::write_mapped_file<std::int64_t>(file.path.c_str(), data);
+
+        zstl::mapped_vector<std::int64_t> a(file.path.c_str());
+        [[maybe_unused]] const std::int64_t *p = a.data();
+        zstl::mapped_vector<std::int64_t> b(std::move(a));
+        assert(a.empty() && a.data() == nullptr);
+        assert(b.data() == p && b[2] == 9);
+
+        zstl::mapped_vector<std::int64_t> c;
+        c = std::move(b);
+        assert(b.empty() && c.size() == 3uz && c[0] == 7);
+        std::cout << "move ok" << '\n';
+    }
+    {
+        // every damaged header is rejected
+        temp_file file("zstl_test_mapped_vector_bad.bin");
+        std::vector<std::uint32_t> data(16, 42u);
+        zstl::write_mapped_file<std::uint32_t>(file.path.c_str(), data);
+        const zstl::mapped_header good = read_header(file.path);
+        assert(!open_throws<std::uint32_t>(file.path));
+
+        // the element type does not match the file
+        assert(open_throws<std::uint64_t>(file.path));
+        assert(open_throws<wide>(file.path));
+
+        zstl::mapped_header h = good;
+        h.magic[0] = 'X';
+        patch_header(file.path, h);
+        assert(open_throws<std::uint32_t>(file.path));
+
+        h = good;
+        h.version = 2u;
+        patch_header(file.path, h);
+        assert(open_throws<std::uint32_t>(file.path));
+
+        // more elements than the file holds
+        h = good;
+        h.count = 17u;
+        patch_header(file.path, h);
+        assert(open_throws<std::uint32_t>(file.path));
+
+        h = good;
+        h.count = ~std::uint64_t { 0u };
+        patch_header(file.path, h);
+        assert(open_throws<std::uint32_t>(file.path));
+
+        // data past the end of the file
+        h = good;
+        h.data_offset = 1u << 20;
+        patch_header(file.path, h);
+        assert(open_throws<std::uint32_t>(file.path));
+
+        // data inside the header itself
+        h = good;
+        h.data_offset = 0u;
+        patch_header(file.path, h);
+        assert(open_throws<std::uint32_t>(file.path));
+
+        h = good;
+        h.data_offset = sizeof(zstl::mapped_header) - 4u;
+        patch_header(file.path, h);
+        assert(open_throws<std::uint32_t>(file.path));
+
+        patch_header(file.path, good);
+        assert(!open_throws<std::uint32_t>(file.path));
+
+        // shorter than a header, and missing
+        std::filesystem::resize_file(file.path, sizeof(zstl::mapped_header) - 1uz);
+        assert(open_throws<std::uint32_t>(file.path));
+        std::filesystem::remove(file.path);
+        assert(open_throws<std::uint32_t>(file.path));
+
+        // unwritable destination
+        [[maybe_unused]] bool threw = false;
+        try {
+            zstl::write_mapped_file<std::uint32_t>("/nonexistent-dir/zstl.bin", data);
+        } catch (const std::system_error &) {
+            threw = true;
+        }
+        assert(threw);
+        std::cout << "header validation ok" << std::endl;
+    }
+
+    return 0;
+}
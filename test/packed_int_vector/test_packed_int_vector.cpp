@@ -0,0 +1,201 @@
+// In this program, we check `zstl::packed_int_vector` against the values it was given
+// Blocks are built for every bit width from 0 to 64, both as frame-of-reference
+//   (unsorted) and as delta (non-decreasing) blocks, and decoded through every unpack
+//   kernel (scalar, SSE2, AVX2, AVX-512) with decode_block, copy_to and for_each_block,
+//   as well as read one value at a time, including the first and last value of
+//   every block and the values of the uncompressed tail
+
+#include <ZSTL/packed_int_vector.hpp>
+
+#include <span>
+#include <vector>
+#include <random>
+#include <algorithm>
+#include <iostream>
+#include <stdexcept>
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+
+
+using value_type = zstl::packed_int_vector::value_type;
+
+constexpr std::size_t BLOCK = zstl::packed_int_vector::BLOCK_SIZE;
+
+constexpr zstl::simd::level LEVELS[] {
+    zstl::simd::level::scalar,
+    zstl::simd::level::sse2,
+    zstl::simd::level::avx2,
+    zstl::simd::level::avx512
+};
+
+constexpr value_type low_mask(std::size_t width) {
+    return width == 64uz ? ~value_type { 0u } : (value_type { 1u } << width) - 1u;
+}
+
+// what sealing a block of `width` bits adds: 8 streams of `width` words and a header
+constexpr std::size_t packed_bytes(std::size_t width) {
+    return zstl::detail::packed_int_vector::STREAMS * width * sizeof(value_type)
+        + sizeof(zstl::detail::packed_int_vector::block_header);
+}
+
+// an unsorted block whose span needs exactly `width` bits
+std::vector<value_type> for_block(std::size_t width, std::mt19937_64 &rng) {
+    value_type base = width == 64uz ? 0u : rng() & ~low_mask(width) & 0x0fff'ffff'ffff'ffffu;
+    std::vector<value_type> v(BLOCK);
+    for (value_type &x : v) {
+        x = base + (rng() & low_mask(width));
+    }
+    // both ends of the range, out of order
+    v[1uz] = base + low_mask(width);
+    v[2uz] = base;
+    v[BLOCK - 1uz] = base + low_mask(width);
+    return v;
+}
+
+// a non-decreasing block whose largest step needs exactly `width` bits
+std::vector<value_type> delta_block(std::size_t width, std::mt19937_64 &rng) {
+    std::vector<value_type> v(BLOCK);
+    value_type x = rng() >> 8;
+    for (std::size_t i { 0uz }; i < BLOCK; ++i) {
+        value_type step = i == 0uz ? 0u : rng() & low_mask(width);
+        if (i == BLOCK - 1uz) {
+            step = low_mask(width);
+        }
+        x += step;
+        v[i] = x;
+    }
+    return v;
+}
+
+void check_against(const zstl::packed_int_vector &p, const std::vector<value_type> &expected) {
+    assert(p.size() == expected.size());
+    for (std::size_t i { 0uz }; i < expected.size(); ++i) {
+        assert(p[i] == expected[i]);
+    }
+    assert(p.at(expected.size() - 1uz) == expected.back());
+
+    std::vector<value_type> block(BLOCK);
+    std::vector<value_type> all(expected.size());
+    for (zstl::simd::level l : LEVELS) {
+        for (std::size_t b { 0uz }; b < p.block_count(); ++b) {
+            std::fill(block.begin(), block.end(), 0xdead'beefu);
+            p.decode_block(b, block, l);
+            assert(std::equal(block.begin(), block.end(), expected.begin() + static_cast<std::ptrdiff_t>(b * BLOCK)));
+        }
+
+        std::fill(all.begin(), all.end(), 0u);
+        p.copy_to(all, l);
+        assert(all == expected);
+
+        std::size_t next { 0uz };
+        p.for_each_block(
+            [&](std::span<const value_type> values) {
+                for ([[maybe_unused]] value_type x : values) {
+                    assert(x == expected[next]);
+                    ++next;
+                }
+            },
+            l
+        );
+        assert(next == expected.size());
+    }
+}
+
+
+int main() {
+    std::mt19937_64 rng(5u);
+
+    {
+        // one frame-of-reference block per width, packed one after the other
+        zstl::packed_int_vector p;
+        std::vector<value_type> expected;
+        for (std::size_t width { 0uz }; width <= 64uz; ++width) {
+            std::vector<value_type> block = for_block(width, rng);
+            [[maybe_unused]] std::size_t before = p.memory_bytes();
+            p.append(block);
+            expected.insert(expected.end(), block.begin(), block.end());
+            assert(p.memory_bytes() - before == packed_bytes(width));
+            assert(p.block_count() == width + 1uz);
+        }
+        check_against(p, expected);
+        std::cout << "frame of reference, widths 0 to 64 ok" << '\n';
+    }
+    {
+        // delta blocks: narrower than their frame of reference, decoded by prefix sum
+        zstl::packed_int_vector p;
+        std::vector<value_type> expected;
+        for (std::size_t width { 1uz }; width <= 48uz; ++width) {
+            std::vector<value_type> block = delta_block(width, rng);
+            [[maybe_unused]] std::size_t before = p.memory_bytes();
+            for (value_type x : block) {
+                p.push_back(x);
+            }
+            expected.insert(expected.end(), block.begin(), block.end());
+            // sealed at `width` bits per value, not at the bits of its span
+            assert(p.memory_bytes() - before == packed_bytes(width));
+        }
+        check_against(p, expected);
+        std::cout << "delta blocks ok" << '\n';
+    }
+    {
+        // mixed blocks, a constant block (width 0) and every tail length around a block edge
+        std::vector<value_type> values;
+        std::vector<value_type> a = delta_block(3uz, rng);
+        std::vector<value_type> b = for_block(17uz, rng);
+        values.insert(values.end(), a.begin(), a.end());
+        values.insert(values.end(), b.begin(), b.end());
+        values.insert(values.end(), BLOCK, value_type { 42u });
+
+        for (std::size_t extra : { 0uz, 1uz, 7uz, 8uz, 9uz, 63uz, 64uz, 65uz, BLOCK - 1uz }) {
+            std::vector<value_type> expected = values;
+            for (std::size_t i { 0uz }; i < extra; ++i) {
+                expected.push_back(rng());
+            }
+
+            // append() from an empty vector, and after a partial tail
+            zstl::packed_int_vector p;
+            p.append(expected);
+            assert(p.block_count() == expected.size() / BLOCK);
+            check_against(p, expected);
+
+            zstl::packed_int_vector q;
+            q.push_back(expected[0uz]);
+            q.append(std::span<const value_type>(expected).subspan(1uz));
+            check_against(q, expected);
+        }
+        std::cout << "mixed blocks and tails ok" << '\n';
+    }
+    {
+        zstl::packed_int_vector p;
+        p.append(for_block(5uz, rng));
+        std::vector<value_type> small(BLOCK - 1uz);
+        [[maybe_unused]] bool threw = false;
+        try {
+            p.decode_block(0uz, small);
+        } catch (const std::out_of_range &) {
+            threw = true;
+        }
+        assert(threw);
+
+        threw = false;
+        std::vector<value_type> block(BLOCK);
+        try {
+            p.decode_block(1uz, block);
+        } catch (const std::out_of_range &) {
+            threw = true;
+        }
+        assert(threw);
+
+        threw = false;
+        try {
+            static_cast<void>(p.at(BLOCK));
+        } catch (const std::out_of_range &) {
+            threw = true;
+        }
+        assert(threw);
+        std::cout << "bounds ok" << std::endl;
+    }
+
+    return 0;
+}
@@ -0,0 +1,151 @@
+// In this program, we check the parallel algorithms of `zstl` against their
+//   sequential counterparts in <algorithm> and <numeric>
+// Every size from 0 up to a few times the thread count is tried on pools of
+//   1 to 7 threads with `min_chunk` = 1, so there are fewer elements than threads,
+//   odd numbers of sorted runs to merge and chunks of a single element
+// The reductions and scans also run with string concatenation, which is
+//   associative but not commutative, so any reordering of the chunks shows up
+
+#include <ZSTL/parallel_algorithm.hpp>
+
+#include <string>
+#include <vector>
+#include <random>
+#include <numeric>
+#include <iostream>
+#include <algorithm>
+#include <functional>
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+
+
+std::vector<std::int64_t> random_ints(std::size_t n, std::mt19937_64 &rng, std::int64_t range) {
+    std::uniform_int_distribution<std::int64_t> dist(-range, range);
+    std::vector<std::int64_t> v(n);
+    for (auto &x : v) {
+        x = dist(rng);
+    }
+    return v;
+}
+
+std::vector<std::string> letters(std::size_t n) {
+    std::vector<std::string> v;
+    for (std::size_t i { 0uz }; i < n; ++i) {
+        v.push_back(std::string(1uz, static_cast<char>('a' + i % 26uz)));
+    }
+    return v;
+}
+
+
+int main() {
+    std::mt19937_64 rng(12345u);
+
+    {
+        // merge-path sort, including duplicates, a custom order and movable-only work
+        for (unsigned nThreads = 1u; nThreads <= 7u; ++nThreads) {
+            zstl::thread_pool pool(nThreads);
+            zstl::parallel_policy policy { &pool, 1uz };
+
+            for (std::size_t n { 0uz }; n <= 4uz * nThreads + 3uz; ++n) {
+                std::vector<std::int64_t> v = random_ints(n, rng, 5);
+                std::vector<std::int64_t> expected = v;
+                std::sort(expected.begin(), expected.end());
+                zstl::parallel_sort(policy, v);
+                assert(v == expected);
+
+                std::sort(expected.begin(), expected.end(), std::greater<> {});
+                zstl::parallel_sort(policy, v, std::greater<> {});
+                assert(v == expected);
+            }
+
+            // long strings are moved through the scratch buffer, not copied bitwise
+            std::vector<std::string> words;
+            for (std::size_t i { 0uz }; i < 101uz; ++i) {
+                words.push_back(std::string(40uz, 'x') + std::to_string(rng() % 50u));
+            }
+            std::vector<std::string> expectedWords = words;
+            std::sort(expectedWords.begin(), expectedWords.end());
+            zstl::parallel_sort(policy, words);
+            assert(words == expectedWords);
+
+            // a zstl::vector, large enough for several merge rounds
+            std::vector<std::int64_t> big = random_ints(10007uz, rng, 1000000);
+            zstl::vector<std::int64_t> zbig(big.begin(), big.end());
+            std::sort(big.begin(), big.end());
+            zstl::parallel_sort(policy, zbig);
+            assert(std::equal(zbig.begin(), zbig.end(), big.begin(), big.end()));
+        }
+        std::cout << "parallel_sort ok" << '\n';
+    }
+    {
+        // reduce: plus, and in-order string concatenation
+        for (unsigned nThreads = 1u; nThreads <= 7u; ++nThreads) {
+            zstl::thread_pool pool(nThreads);
+            [[maybe_unused]] zstl::parallel_policy policy { &pool, 1uz };
+
+            for (std::size_t n { 0uz }; n <= 4uz * nThreads + 3uz; ++n) {
+                std::vector<std::int64_t> v = random_ints(n, rng, 1000);
+                assert(zstl::parallel_reduce(policy, v, std::int64_t { 7 })
+                    == std::accumulate(v.begin(), v.end(), std::int64_t { 7 }));
+
+                std::vector<std::string> s = letters(n);
+                assert(zstl::parallel_reduce(policy, s, std::string(">"))
+                    == std::accumulate(s.begin(), s.end(), std::string(">")));
+            }
+        }
+        std::cout << "parallel_reduce ok" << '\n';
+    }
+    {
+        // inclusive and exclusive scans, into a separate output and in place
+        for (unsigned nThreads = 1u; nThreads <= 7u; ++nThreads) {
+            zstl::thread_pool pool(nThreads);
+            zstl::parallel_policy policy { &pool, 1uz };
+
+            for (std::size_t n { 0uz }; n <= 4uz * nThreads + 3uz; ++n) {
+                std::vector<std::int64_t> v = random_ints(n, rng, 1000);
+                std::vector<std::int64_t> expected(n);
+                std::vector<std::int64_t> out(n);
+
+                std::inclusive_scan(v.begin(), v.end(), expected.begin());
+                zstl::parallel_inclusive_scan(policy, v, out);
+                assert(out == expected);
+
+                std::exclusive_scan(v.begin(), v.end(), expected.begin(), std::int64_t { -3 });
+                zstl::parallel_exclusive_scan(policy, v, out, std::int64_t { -3 });
+                assert(out == expected);
+
+                // in == out
+                std::vector<std::int64_t> inPlace = v;
+                std::inclusive_scan(v.begin(), v.end(), expected.begin());
+                zstl::parallel_inclusive_scan(policy, inPlace, inPlace);
+                assert(inPlace == expected);
+
+                inPlace = v;
+                std::exclusive_scan(v.begin(), v.end(), expected.begin(), std::int64_t { 5 });
+                zstl::parallel_exclusive_scan(policy, inPlace, inPlace, std::int64_t { 5 });
+                assert(inPlace == expected);
+
+                // non-commutative: every prefix must come out in order
+                std::vector<std::string> s = letters(n);
+                std::vector<std::string> expectedS(n);
+                std::vector<std::string> outS(n);
+
+                std::inclusive_scan(s.begin(), s.end(), expectedS.begin());
+                zstl::parallel_inclusive_scan(policy, s, outS);
+                assert(outS == expectedS);
+
+                std::exclusive_scan(s.begin(), s.end(), expectedS.begin(), std::string("#"));
+                zstl::parallel_exclusive_scan(policy, s, outS, std::string("#"));
+                assert(outS == expectedS);
+
+                std::vector<std::string> inPlaceS = s;
+                zstl::parallel_exclusive_scan(policy, inPlaceS, inPlaceS, std::string("#"));
+                assert(inPlaceS == expectedS);
+            }
+        }
+        std::cout << "parallel scans ok" << std::endl;
+    }
+
+    return 0;
+}
@@ -0,0 +1,143 @@
+// In this program, we keep `Circle`/`RightTriangle`/`Rectangle` objects by value
+//   in a `zstl::poly_collection`, one contiguous segment per type
+// Elements are reached through 4-byte handles that stay valid while their
+//   segment grows; for_each and visit walk the segments in tag order
+
+#include <ZSTL/poly_collection.hpp>
+
+#include <vector>
+#include <utility>
+#include <iostream>
+#include <algorithm>
+#include <numbers>
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <type_traits>
+
+
+struct Circle {
+    double radius { 0.0 };
+
+    double get_area() const {
+        return std::numbers::pi * radius * radius;
+    }
+};
+
+struct RightTriangle {
+    double base { 0.0 };
+    double height { 0.0 };
+
+    double get_area() const {
+        return 0.5 * base * height;
+    }
+};
+
+struct Rectangle {
+    double width { 0.0 };
+    double height { 0.0 };
+
+    double get_area() const {
+        return width * height;
+    }
+};
+
+
+int main() {
+    {
+        // poly_collection: objects by value, one segment per type, reached by 4-byte handles
+        using collection = zstl::poly_collection<Circle, RightTriangle, Rectangle>;
+        static_assert(sizeof(collection::handle) == 4uz);
+        static_assert(collection::TAG_BITS == 2uz && collection::INDEX_BITS == 30uz);
+
+        collection shapes;
+        assert(shapes.empty());
+        std::vector<collection::handle> handles;
+        for (int i = 0; i < 30; ++i) {
+            double x = static_cast<double>(i);
+            switch (i % 3) {
+            case 0:
+                handles.push_back(shapes.emplace<Circle>(x));
+                break;
+            case 1:
+                handles.push_back(shapes.insert(RightTriangle { .base = x, .height = 2.0 }));
+                break;
+            default:
+                const Rectangle r { .width = x, .height = 3.0 };
+                handles.push_back(shapes.insert(r));
+                break;
+            }
+        }
+        assert(shapes.size() == 30uz && !shapes.empty());
+        assert(shapes.size<Circle>() == 10uz && shapes.size<Rectangle>() == 10uz);
+
+        // handles outlive the growth of their segment: tag and index stay put
+        for (int i = 0; i < 30; ++i) {
+            collection::handle h = handles[i];
+            assert(h.tag() == static_cast<std::uint64_t>(i % 3 + 1));
+            assert(h.index() == static_cast<std::size_t>(i / 3));
+
+            double x = static_cast<double>(i);
+            [[maybe_unused]] double expected = i % 3 == 0 ? std::numbers::pi * x * x : (i % 3 == 1 ? x : 3.0 * x);
+            assert(shapes.call(h, [](const auto *s) { return s->get_area(); }) == expected);
+
+            [[maybe_unused]] auto p = shapes.get(h);
+            assert(p.tag() == h.tag());
+            [[maybe_unused]] const collection &cshapes = shapes;
+            assert(cshapes.call(h, [](const auto *s) { return s->get_area(); }) == expected);
+        }
+        assert(shapes.cast<Circle>(handles[3])->radius == 3.0);
+        assert(shapes.cast<Rectangle>(handles[3]) == nullptr);
+        assert(shapes.get(handles[5]).ptr() == &shapes.segment<Rectangle>()[1]);
+
+        // calls through a non-const collection write into the element
+        shapes.call(handles[4], [](auto *s) { *s = {}; });
+        assert(shapes.cast<RightTriangle>(handles[4])->base == 0.0);
+
+        // the null handle
+        collection::handle null;
+        assert(null.tag() == 0u && null.index() == 0uz);
+        assert(shapes.get(null).tag() == 0u && shapes.get(null).ptr() == nullptr);
+        assert(shapes.cast<Circle>(null) == nullptr);
+
+        // for_each goes segment by segment, in tag order
+        std::vector<std::uint64_t> order;
+        double total = 0.0;
+        shapes.for_each(
+            [&](const auto *s) {
+                order.push_back(collection::get_type_tag<std::remove_cvref_t<decltype(*s)>>());
+                total += s->get_area();
+            }
+        );
+        assert(order.size() == 30uz && std::ranges::is_sorted(order));
+        double expectedTotal = 0.0;
+        for (collection::handle h : handles) {
+            expectedTotal += shapes.call(h, [](const auto *s) { return s->get_area(); });
+        }
+        assert(total == expectedTotal);
+
+        // reserving moves the segment, the handle still finds the element
+        shapes.reserve<Rectangle>(100uz);
+        assert(shapes.cast<Rectangle>(handles[5])->width == 5.0);
+
+        // visit skips empty segments and hands out spans of the real type
+        collection partial;
+        static_cast<void>(partial.emplace<Rectangle>(1.0, 2.0));
+        int visited = 0;
+        std::as_const(partial).visit(
+            [&](auto s) {
+                static_assert(std::is_const_v<typename decltype(s)::element_type>);
+                ++visited;
+                assert(s.size() == 1uz);
+            }
+        );
+        assert(visited == 1);
+        assert(partial.segment<Circle>().empty() && partial.segment<Rectangle>()[0].height == 2.0);
+
+        shapes.clear();
+        assert(shapes.empty() && shapes.size<Circle>() == 0uz);
+        std::cout << "poly_collection ok" << std::endl;
+    }
+
+    return 0;
+}
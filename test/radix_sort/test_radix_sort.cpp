@@ -0,0 +1,199 @@
+// In this program, we check `zstl::radix_sort` and `zstl::radix_sort_by_key`
+//   against std::sort / std::stable_sort
+// Covered: signed and unsigned integers of every width (the sign bit flip),
+//   floats and doubles including -0.0, infinities and NaNs of both signs,
+//   stability of records with equal keys, skipped passes, and the parallel
+//   overloads on pools of 1 to 5 threads with chunks down to one element
+
+#include <ZSTL/radix_sort.hpp>
+
+#include <bit>
+#include <cmath>
+#include <limits>
+#include <vector>
+#include <random>
+#include <iostream>
+#include <algorithm>
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+
+
+struct record {
+    std::int32_t key { 0 };
+    std::uint32_t seq { 0u };
+
+    friend bool operator==(const record &, const record &) = default;
+};
+
+template <typename T>
+std::vector<T> random_values(std::size_t n, std::mt19937_64 &rng) {
+    std::vector<T> v(n);
+    for (auto &x : v) {
+        if constexpr (std::is_floating_point_v<T>) {
+            x = static_cast<T>(std::uniform_real_distribution<double>(-1e6, 1e6)(rng));
+        } else {
+            x = static_cast<T>(rng());
+        }
+    }
+    return v;
+}
+
+template <typename T>
+void check_integers(std::mt19937_64 &rng, const zstl::parallel_policy *policy) {
+    const std::size_t sizes[] { 0uz, 1uz, 2uz, 3uz, 17uz, 1000uz, 4099uz };
+    for (std::size_t n : sizes) {
+        std::vector<T> v = random_values<T>(n, rng);
+        // the extremes of the type end up at the ends
+        if (n >= 2uz) {
+            v[0uz] = std::numeric_limits<T>::max();
+            v[n - 1uz] = std::numeric_limits<T>::min();
+        }
+        std::vector<T> expected = v;
+        std::sort(expected.begin(), expected.end());
+
+        if (policy) {
+            zstl::radix_sort(*policy, v);
+        } else {
+            zstl::radix_sort(v);
+        }
+        assert(v == expected);
+    }
+}
+
+// -NaN < -inf < ... < -0.0 < +0.0 < ... < +inf < +NaN, by sign and bit pattern
+template <typename T>
+void check_floats(std::mt19937_64 &rng, const zstl::parallel_policy *policy) {
+    constexpr T inf = std::numeric_limits<T>::infinity();
+    const T nan = std::numeric_limits<T>::quiet_NaN();
+
+    std::vector<T> v = random_values<T>(500uz, rng);
+    const T specials[] { -0.0, 0.0, -0.0, inf, -inf, nan, -nan, T(1), T(-1), std::numeric_limits<T>::denorm_min() };
+    for (std::size_t i { 0uz }; i < std::size(specials); ++i) {
+        v[i * 37uz] = specials[i];
+    }
+
+    if (policy) {
+        zstl::radix_sort(*policy, v);
+    } else {
+        zstl::radix_sort(v);
+    }
+
+    assert(std::isnan(v.front()) && std::signbit(v.front()));
+    assert(std::isnan(v.back()) && !std::signbit(v.back()));
+    assert(v[1uz] == -inf && v[v.size() - 2uz] == inf);
+
+    // the ordered values in between match std::sort, with -0.0 before +0.0
+    std::vector<T> middle(v.begin() + 1, v.end() - 1);
+    assert(std::is_sorted(middle.begin(), middle.end()));
+    [[maybe_unused]] auto zero = std::find(middle.begin(), middle.end(), T(0));
+    assert(zero + 2 < middle.end());
+    assert(std::signbit(zero[0]) && std::signbit(zero[1]) && !std::signbit(zero[2]));
+}
+
+
+int main() {
+    std::mt19937_64 rng(2024u);
+
+    {
+        // radix_key preserves order
+        static_assert(zstl::radix_key(std::int32_t { -1 }) < zstl::radix_key(std::int32_t { 0 }));
+        static_assert(zstl::radix_key(std::int8_t { -128 }) == 0u);
+        static_assert(zstl::radix_key(-2.0) < zstl::radix_key(-1.0));
+        static_assert(zstl::radix_key(-0.0) < zstl::radix_key(0.0));
+        static_assert(zstl::radix_key(0.0f) < zstl::radix_key(1e-45f));
+        std::cout << "radix_key ok" << '\n';
+    }
+    {
+        check_integers<std::int8_t>(rng, nullptr);
+        check_integers<std::int16_t>(rng, nullptr);
+        check_integers<std::int32_t>(rng, nullptr);
+        check_integers<std::int64_t>(rng, nullptr);
+        check_integers<std::uint8_t>(rng, nullptr);
+        check_integers<std::uint32_t>(rng, nullptr);
+        check_integers<std::uint64_t>(rng, nullptr);
+
+        // only the low byte varies: the other passes are skipped
+        std::vector<std::uint64_t> narrow(1000uz);
+        for (auto &x : narrow) {
+            x = (std::uint64_t { 0xabcd } << 40) | (rng() & 0xffu);
+        }
+        std::vector<std::uint64_t> expected = narrow;
+        std::sort(expected.begin(), expected.end());
+        zstl::radix_sort(narrow);
+        assert(narrow == expected);
+
+        // all equal
+        std::vector<std::int32_t> same(100uz, -7);
+        zstl::radix_sort(same);
+        assert(std::all_of(same.begin(), same.end(), [](std::int32_t x) { return x == -7; }));
+        std::cout << "integers ok" << '\n';
+    }
+    {
+        check_floats<float>(rng, nullptr);
+        check_floats<double>(rng, nullptr);
+        std::cout << "floats ok" << '\n';
+    }
+    {
+        // equal keys keep their input order, from a zstl::vector and a monotonic buffer
+        zstl::pmr::monotonic_buffer_resource buffer;
+        zstl::vector<record> records;
+        for (std::uint32_t i { 0u }; i < 5000u; ++i) {
+            records.push_back(record { static_cast<std::int32_t>(rng() % 41u) - 20, i });
+        }
+        std::vector<record> expected(records.begin(), records.end());
+        std::stable_sort(
+            expected.begin(),
+            expected.end(),
+            [](const record &a, const record &b) { return a.key < b.key; }
+        );
+
+        zstl::radix_sort_by_key(records, [](const record &r) { return r.key; }, &buffer);
+        assert(std::equal(records.begin(), records.end(), expected.begin(), expected.end()));
+        std::cout << "stability ok" << '\n';
+    }
+    {
+        // parallel overloads: same results, still stable
+        for (unsigned nThreads = 1u; nThreads <= 5u; ++nThreads) {
+            zstl::thread_pool pool(nThreads);
+            zstl::parallel_policy policy { &pool, 1uz };
+
+            check_integers<std::int16_t>(rng, &policy);
+            check_integers<std::int64_t>(rng, &policy);
+            check_integers<std::uint32_t>(rng, &policy);
+            check_floats<float>(rng, &policy);
+            check_floats<double>(rng, &policy);
+
+            for (std::size_t n { 0uz }; n <= 3uz * nThreads; ++n) {
+                std::vector<record> records;
+                for (std::uint32_t i { 0u }; i < n; ++i) {
+                    records.push_back(record { static_cast<std::int32_t>(rng() % 3u) - 1, i });
+                }
+                std::vector<record> expected = records;
+                std::stable_sort(
+                    expected.begin(),
+                    expected.end(),
+                    [](const record &a, const record &b) { return a.key < b.key; }
+                );
+                zstl::radix_sort_by_key(policy, records, [](const record &r) { return r.key; });
+                assert(records == expected);
+            }
+
+            std::vector<record> many;
+            for (std::uint32_t i { 0u }; i < 20000u; ++i) {
+                many.push_back(record { static_cast<std::int32_t>(rng() % 1000u) - 500, i });
+            }
+            std::vector<record> expected = many;
+            std::stable_sort(
+                expected.begin(),
+                expected.end(),
+                [](const record &a, const record &b) { return a.key < b.key; }
+            );
+            zstl::radix_sort_by_key(policy, many, [](const record &r) { return r.key; });
+            assert(many == expected);
+        }
+        std::cout << "parallel ok" << std::endl;
+    }
+
+    return 0;
+}
@@ -0,0 +1,184 @@
+// In this program, we exercise `zstl::segmented_vector`
+//   with a focus on what it exists for: element addresses stay valid while the
+//   container grows, since it appends segments instead of reallocating
+// We also walk the elements across segment boundaries with iterators, indices
+//   and `for_each_segment`, and check `shrink_to_fit` and the copy/move constructors
+
+#include <ZSTL/segmented_vector.hpp>
+
+#include <iostream>
+#include <string>
+#include <vector>
+#include <cassert>
+#include <cstddef>
+
+
+// counts live objects, so that leaks and double destruction show up
+struct tracked {
+    static inline int live { 0 };
+
+    int value { 0 };
+
+    tracked(int value) : value(value) { ++live; }
+    tracked(const tracked &other) : value(other.value) { ++live; }
+    ~tracked() { --live; }
+};
+
+
+int main() {
+    using small_vector = zstl::segmented_vector<int, 4uz>;
+
+    {
+        // segment k >= 1 holds 4 << (k - 1) elements: [0, 4) [4, 8) [8, 16) [16, 32) ...
+        static_assert(small_vector::segment_of(0uz) == 0uz);
+        static_assert(small_vector::segment_of(3uz) == 0uz);
+        static_assert(small_vector::segment_of(4uz) == 1uz);
+        static_assert(small_vector::segment_of(7uz) == 1uz);
+        static_assert(small_vector::segment_of(8uz) == 2uz);
+        static_assert(small_vector::segment_of(16uz) == 3uz);
+        static_assert(small_vector::segment_begin(3uz) == 16uz);
+        static_assert(small_vector::segment_size(3uz) == 16uz);
+        std::cout << "segment layout ok" << '\n';
+    }
+    {
+        // addresses taken early survive every later growth
+        small_vector v;
+        std::vector<const int *> addresses;
+        for (int i = 0; i < 1000; ++i) {
+            addresses.push_back(&v.emplace_back(i));
+        }
+        assert(v.size() == 1000uz);
+        for (int i = 0; i < 1000; ++i) {
+            assert(addresses[i] == &v[i]);
+            assert(*addresses[i] == i);
+        }
+        assert(&v.front() == addresses.front() && &v.back() == addresses.back());
+
+        // reserve adds segments but moves nothing either
+        v.reserve(100000uz);
+        assert(v.capacity() >= 100000uz);
+        assert(addresses[999] == &v[999] && v[999] == 999);
+        std::cout << "pointer stability ok" << '\n';
+    }
+    {
+        // iteration crosses segment boundaries in every direction
+        small_vector v;
+        for (int i = 0; i < 37; ++i) {
+            v.push_back(i);
+        }
+
+        int expected = 0;
+        for (int x : v) {
+            assert(x == expected);
+            ++expected;
+        }
+        assert(expected == 37);
+
+        auto it = v.end();
+        for (int i = 36; i >= 0; --i) {
+            --it;
+            assert(*it == i);
+        }
+        assert(it == v.begin());
+
+        // jumps land on the right element on either side of a boundary
+        for (std::ptrdiff_t i = 0; i < 37; ++i) {
+            assert(*(v.begin() + i) == i);
+            assert(v.begin()[i] == i);
+            assert(*(v.end() - (37 - i)) == i);
+        }
+        assert(v.end() - v.begin() == 37);
+
+        std::size_t spans { 0uz };
+        int next = 0;
+        const small_vector &cv = v;
+        cv.for_each_segment(
+            [&](std::span<const int> seg) {
+                ++spans;
+                for (int x : seg) {
+                    assert(x == next);
+                    ++next;
+                }
+            }
+        );
+        // [0, 4) [4, 8) [8, 16) [16, 32) [32, 37)
+        assert(spans == 5uz && spans == v.segment_count() && next == 37);
+        assert(v.segment(4uz).size() == 5uz);
+
+        bool threw = false;
+        try {
+            static_cast<void>(v.at(37uz));
+        } catch (const std::out_of_range &) {
+            threw = true;
+        }
+        assert(threw && v.at(36uz) == 36);
+        std::cout << "iteration across segments ok" << '\n';
+    }
+    {
+        // shrink_to_fit drops trailing empty segments and keeps the elements in place
+        small_vector v;
+        for (int i = 0; i < 10; ++i) {
+            v.push_back(i);
+        }
+        const int *first = &v[0];
+        const int *ninth = &v[9];
+        v.reserve(1000uz);
+        assert(v.capacity() >= 1000uz);
+
+        v.shrink_to_fit();
+        // 10 elements need segments [0, 4) [4, 8) [8, 16)
+        assert(v.capacity() == 16uz);
+        assert(&v[0] == first && &v[9] == ninth && v[9] == 9);
+
+        // popping back into an earlier segment lets shrink_to_fit release more
+        while (v.size() > 3uz) {
+            v.pop_back();
+        }
+        v.shrink_to_fit();
+        assert(v.capacity() == 4uz && &v[0] == first);
+
+        v.clear();
+        v.shrink_to_fit();
+        assert(v.capacity() == 0uz && v.empty());
+
+        // and the container still grows afterwards
+        v.push_back(42);
+        assert(v.size() == 1uz && v.front() == 42);
+        std::cout << "shrink_to_fit ok" << '\n';
+    }
+    {
+        // copy makes independent elements, move steals the segments
+        {
+            zstl::segmented_vector<tracked, 2uz> v;
+            for (int i = 0; i < 50; ++i) {
+                v.emplace_back(i);
+            }
+            assert(tracked::live == 50);
+
+            zstl::segmented_vector<tracked, 2uz> copy(v);
+            assert(tracked::live == 100);
+            assert(copy.size() == 50uz && copy[49].value == 49);
+            assert(&copy[0] != &v[0]);
+            copy[0].value = -1;
+            assert(v[0].value == 0);
+
+            const tracked *moved = &v[17];
+            zstl::segmented_vector<tracked, 2uz> stolen(std::move(v));
+            assert(tracked::live == 100);
+            assert(v.empty() && v.capacity() == 0uz);
+            assert(stolen.size() == 50uz && &stolen[17] == moved);
+
+            // the moved-from container is usable again
+            v.emplace_back(7);
+            assert(v.size() == 1uz && v[0].value == 7);
+        }
+        assert(tracked::live == 0);
+
+        zstl::segmented_vector<std::string> strs { "a", "b", "c" };
+        zstl::segmented_vector<std::string> strsCopy(strs);
+        assert(strsCopy.size() == 3uz && strsCopy[2] == "c");
+        std::cout << "copy/move ok" << std::endl;
+    }
+
+    return 0;
+}
@@ -0,0 +1,163 @@
+// In this program, we check every ISA level of `zstl::simd` against the scalar
+//   kernels: find, count, min, max and sum for int32_t, float and double
+// Every length from 0 to 64 is tried (so every tail length of the 16, 32 and 64 byte
+//   loops), plus a few longer ones, starting both at an aligned and at an unaligned
+//   address, with the searched value and the extremes placed at every position
+// Levels the CPU does not support fall back to the best one it does; all results
+//   must be the same either way. Values are small integers so float sums are exact
+
+#include <ZSTL/simd.hpp>
+
+#include <span>
+#include <cmath>
+#include <limits>
+#include <vector>
+#include <random>
+#include <iostream>
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+
+
+constexpr zstl::simd::level LEVELS[] {
+    zstl::simd::level::scalar,
+    zstl::simd::level::sse2,
+    zstl::simd::level::avx2,
+    zstl::simd::level::avx512
+};
+
+std::vector<std::size_t> lengths() {
+    std::vector<std::size_t> ns;
+    for (std::size_t n { 0uz }; n <= 64uz; ++n) {
+        ns.push_back(n);
+    }
+    for (std::size_t n : { 65uz, 127uz, 128uz, 129uz, 255uz, 1000uz, 4099uz }) {
+        ns.push_back(n);
+    }
+    return ns;
+}
+
+template <typename T>
+void check_all_levels(std::span<const T> data, T needle) {
+    namespace simd = zstl::simd;
+    [[maybe_unused]] const std::size_t find = simd::find(data, needle, simd::level::scalar);
+    [[maybe_unused]] const std::size_t count = simd::count(data, needle, simd::level::scalar);
+    [[maybe_unused]] const T min = simd::min(data, simd::level::scalar);
+    [[maybe_unused]] const T max = simd::max(data, simd::level::scalar);
+
+    for ([[maybe_unused]] simd::level l : LEVELS) {
+        assert(simd::find(data, needle, l) == find);
+        assert(simd::count(data, needle, l) == count);
+        assert(simd::min(data, l) == min);
+        assert(simd::max(data, l) == max);
+    }
+}
+
+template <typename T>
+void check_type(std::mt19937 &rng) {
+    namespace simd = zstl::simd;
+    std::uniform_int_distribution<int> dist(-20, 20);
+
+    // one spare element in front for the unaligned start
+    std::vector<T> storage(4100uz + 16uz);
+    for (std::size_t n : lengths()) {
+        for (std::size_t shift : { 0uz, 1uz }) {
+            std::span<T> data(storage.data() + shift, n);
+            for (T &x : data) {
+                x = static_cast<T>(dist(rng));
+            }
+
+            // the reference sum is a plain loop, independent of the kernels
+            simd::sum_type<T> expectedSum {};
+            for (T x : data) {
+                expectedSum += x;
+            }
+            for ([[maybe_unused]] simd::level l : LEVELS) {
+                assert(simd::sum(std::span<const T>(data), l) == expectedSum);
+            }
+            check_all_levels<T>(data, T(7));
+            check_all_levels<T>(data, T(1000));
+
+            // the needle and the extremes at every position of short ranges
+            if (n <= 64uz) {
+                for (std::size_t pos { 0uz }; pos < n; ++pos) {
+                    T saved = data[pos];
+                    data[pos] = T(99);
+                    assert(simd::find(std::span<const T>(data), T(99)) == pos);
+                    check_all_levels<T>(data, T(99));
+                    data[pos] = T(-99);
+                    assert(simd::min(std::span<const T>(data)) == T(-99));
+                    check_all_levels<T>(data, T(-99));
+                    data[pos] = saved;
+                }
+            }
+        }
+    }
+
+    // the identities of an empty range
+    std::span<const T> empty;
+    for ([[maybe_unused]] simd::level l : LEVELS) {
+        assert(simd::find(empty, T(0), l) == 0uz);
+        assert(simd::count(empty, T(0), l) == 0uz);
+        assert(simd::min(empty, l) == std::numeric_limits<T>::max());
+        assert(simd::max(empty, l) == std::numeric_limits<T>::lowest());
+        assert(simd::sum(empty, l) == simd::sum_type<T> {});
+    }
+}
+
+template <typename T>
+void check_nans() {
+    namespace simd = zstl::simd;
+    const T nan = std::numeric_limits<T>::quiet_NaN();
+
+    for (std::size_t n { 1uz }; n <= 64uz; ++n) {
+        std::vector<T> v(n, nan);
+        for ([[maybe_unused]] simd::level l : LEVELS) {
+            // never found, never counted, skipped by min/max
+            assert(simd::find(v, nan, l) == n);
+            assert(simd::count(v, nan, l) == 0uz);
+            assert(simd::min(v, l) == std::numeric_limits<T>::max());
+            assert(simd::max(v, l) == std::numeric_limits<T>::lowest());
+        }
+        v[n / 2uz] = T(-3);
+        v[n - 1uz] = T(5);
+        check_all_levels<T>(v, T(5));
+        for ([[maybe_unused]] simd::level l : LEVELS) {
+            assert(simd::max(v, l) == T(5));
+            // for n <= 2 the 5 overwrote the -3
+            assert(simd::min(v, l) == (n <= 2uz ? T(5) : T(-3)));
+            assert(std::isnan(simd::sum(v, l)) == (n >= 2uz));
+        }
+    }
+}
+
+
+int main() {
+    std::mt19937 rng(7u);
+
+    std::cout << "detected level: " << zstl::simd::level_name(zstl::simd::detected_level()) << '\n';
+    {
+        check_type<std::int32_t>(rng);
+        std::cout << "int32_t ok" << '\n';
+    }
+    {
+        check_type<float>(rng);
+        check_type<double>(rng);
+        std::cout << "float / double ok" << '\n';
+    }
+    {
+        check_nans<float>();
+        check_nans<double>();
+        std::cout << "NaN handling ok" << '\n';
+    }
+    {
+        // int32_t sums do not overflow: they are accumulated in int64_t
+        std::vector<std::int32_t> big(1000uz, std::numeric_limits<std::int32_t>::max());
+        for ([[maybe_unused]] zstl::simd::level l : LEVELS) {
+            assert(zstl::simd::sum(big, l) == 1000ll * std::numeric_limits<std::int32_t>::max());
+        }
+        std::cout << "int32_t sum width ok" << std::endl;
+    }
+
+    return 0;
+}
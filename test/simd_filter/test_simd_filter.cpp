@@ -0,0 +1,125 @@
+// In this program, we check `zstl::simd::filter_into` and `filter_indices_into`
+//   at every ISA level against a plain copy_if loop
+// Every comparison predicate and a generic lambda are run over every length from
+//   0 to 64 (all tail lengths of the 8 and 16 lane kernels) and a few longer ones,
+//   from an aligned and an unaligned start, appending to empty and non-empty
+//   destinations; float inputs contain NaNs, which only not_equal_to keeps
+
+#include <ZSTL/simd_filter.hpp>
+
+#include <span>
+#include <limits>
+#include <vector>
+#include <random>
+#include <iostream>
+#include <cassert>
+#include <cstddef>
+#include <cstring>
+#include <cstdint>
+
+
+constexpr zstl::simd::level LEVELS[] {
+    zstl::simd::level::scalar,
+    zstl::simd::level::sse2,
+    zstl::simd::level::avx2,
+    zstl::simd::level::avx512
+};
+
+template <typename T, typename Pred>
+void check_predicate(std::span<const T> src, Pred pred) {
+    namespace simd = zstl::simd;
+    using Index = simd::index_type<T>;
+
+    std::vector<T> expected;
+    std::vector<Index> expectedIndices;
+    for (std::size_t i { 0uz }; i < src.size(); ++i) {
+        if (pred(src[i])) {
+            expected.push_back(src[i]);
+            expectedIndices.push_back(static_cast<Index>(i));
+        }
+    }
+
+    for (simd::level l : LEVELS) {
+        for (std::size_t prefix : { 0uz, 3uz }) {
+            // what is already in the destination stays in front
+            zstl::vector<T> dst(prefix, T(-77));
+            std::size_t kept = simd::filter_into(src, dst, pred, l);
+            assert(kept == expected.size() && dst.size() == prefix + kept);
+            for (std::size_t i { 0uz }; i < prefix; ++i) {
+                assert(dst[i] == T(-77));
+            }
+            for (std::size_t i { 0uz }; i < kept; ++i) {
+                // compared bitwise, so a kept NaN matches too
+                assert(std::memcmp(&dst[prefix + i], &expected[i], sizeof(T)) == 0);
+            }
+
+            zstl::vector<Index> indices(prefix, Index(12345));
+            kept = simd::filter_indices_into(src, indices, pred, l);
+            assert(kept == expectedIndices.size() && indices.size() == prefix + kept);
+            for (std::size_t i { 0uz }; i < kept; ++i) {
+                assert(indices[prefix + i] == expectedIndices[i]);
+            }
+        }
+    }
+}
+
+template <typename T>
+void check_type(std::mt19937 &rng) {
+    namespace simd = zstl::simd;
+    std::uniform_int_distribution<int> dist(-10, 10);
+
+    std::vector<std::size_t> ns;
+    for (std::size_t n { 0uz }; n <= 64uz; ++n) {
+        ns.push_back(n);
+    }
+    for (std::size_t n : { 100uz, 257uz, 1000uz }) {
+        ns.push_back(n);
+    }
+
+    std::vector<T> storage(1001uz);
+    for (std::size_t n : ns) {
+        for (std::size_t shift : { 0uz, 1uz }) {
+            std::span<T> src(storage.data() + shift, n);
+            for (T &x : src) {
+                x = static_cast<T>(dist(rng));
+            }
+            if constexpr (std::is_floating_point_v<T>) {
+                for (std::size_t i = 5uz; i < n; i += 7uz) {
+                    src[i] = std::numeric_limits<T>::quiet_NaN();
+                }
+            }
+
+            std::span<const T> in(src);
+            check_predicate(in, simd::equal_to<T> { T(3) });
+            check_predicate(in, simd::not_equal_to<T> { T(3) });
+            check_predicate(in, simd::less<T> { T(-2) });
+            check_predicate(in, simd::less_equal<T> { T(-2) });
+            check_predicate(in, simd::greater<T> { T(4) });
+            check_predicate(in, simd::greater_equal<T> { T(4) });
+            check_predicate(in, simd::between<T> { T(-3), T(3) });
+            // all and nothing survive
+            check_predicate(in, simd::greater_equal<T> { T(-10) });
+            check_predicate(in, simd::greater<T> { T(10) });
+            // any other callable takes the scalar path
+            check_predicate(in, [](T x) { return x > T(0) && x != T(5); });
+        }
+    }
+}
+
+
+int main() {
+    std::mt19937 rng(11u);
+
+    std::cout << "detected level: " << zstl::simd::level_name(zstl::simd::detected_level()) << '\n';
+    {
+        check_type<std::int32_t>(rng);
+        std::cout << "int32_t ok" << '\n';
+    }
+    {
+        check_type<float>(rng);
+        check_type<double>(rng);
+        std::cout << "float / double ok" << std::endl;
+    }
+
+    return 0;
+}
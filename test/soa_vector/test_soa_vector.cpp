@@ -0,0 +1,286 @@
+// In this program, we check `zstl::soa_vector` row by row against a
+//   `zstl::vector` of the same tuples
+// We push through every overload, reserve, erase ranges, swap vectors with
+//   different resources and write through the proxy rows and the column spans
+// We also grow while the new row refers to an old one, and make a copy throw
+//   during growth: the vector is left as it was
+
+#include <ZSTL/soa_vector.hpp>
+#include <ZSTL/vector.hpp>
+
+#include <tuple>
+#include <string>
+#include <iostream>
+#include <stdexcept>
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+
+
+// counts the bytes it has handed out, so that a block freed through the wrong
+//   resource shows up
+class counting_resource : public zstl::pmr::memory_resource {
+public:
+    std::ptrdiff_t inUse { 0 };
+
+private:
+    void *do_allocate(std::size_t bytes, std::size_t alignment) override {
+        this->inUse += static_cast<std::ptrdiff_t>(bytes);
+        return zstl::pmr::new_delete_resource()->allocate(bytes, alignment);
+    }
+
+    void do_deallocate(void *p, std::size_t bytes, std::size_t alignment) override {
+        this->inUse -= static_cast<std::ptrdiff_t>(bytes);
+        zstl::pmr::new_delete_resource()->deallocate(p, bytes, alignment);
+    }
+
+    bool do_is_equal(const zstl::pmr::memory_resource &other) const noexcept override {
+        return this == &other;
+    }
+};
+
+// counts live objects; its move may throw, so soa_vector copies it on growth,
+//   and every copy throws once `copies` reaches 0
+struct fragile {
+    static inline int live { 0 };
+    static inline int copies { -1 };
+
+    int value { 0 };
+
+    fragile(int value) : value(value) { ++live; }
+    fragile(const fragile &other) : value(other.value) {
+        if (copies-- == 0) {
+            throw std::runtime_error("fragile");
+        }
+        ++live;
+    }
+    fragile(fragile &&other) noexcept(false) : value(other.value) { ++live; }
+    fragile &operator=(const fragile &) = default;
+    fragile &operator=(fragile &&) = default;
+    ~fragile() { --live; }
+};
+
+using soa_type = zstl::soa_vector<int, double, std::string>;
+using row_type = std::tuple<int, double, std::string>;
+
+// long enough to live on the heap, so a use after destroy is seen by ASan
+std::string name_of(int i) {
+    return "row number " + std::to_string(i) + " with a name past the small string buffer";
+}
+
+bool same(const soa_type &v, const zstl::vector<row_type> &expected) {
+    if (v.size() != expected.size()) {
+        return false;
+    }
+    for (std::size_t i { 0uz }; i < v.size(); ++i) {
+        if (v[i] != expected[i]) {
+            return false;
+        }
+    }
+    return true;
+}
+
+// zstl::vector has no erase yet: keep everything outside [first, last)
+void erase_rows(zstl::vector<row_type> &expected, std::size_t first, std::size_t last) {
+    zstl::vector<row_type> all(expected);
+    expected.clear();
+    for (std::size_t i { 0uz }; i < all.size(); ++i) {
+        if (i < first || i >= last) {
+            expected.push_back(all[i]);
+        }
+    }
+}
+
+template <std::size_t I>
+bool column_aligned(const soa_type &v) {
+    return reinterpret_cast<std::uintptr_t>(v.column_data<I>()) % soa_type::COLUMN_ALIGNMENT == 0u;
+}
+
+
+int main() {
+    {
+        // the three push_back overloads and emplace_back agree with the reference
+        soa_type v;
+        zstl::vector<row_type> expected;
+        for (int i = 0; i < 50; ++i) {
+            std::string name = name_of(i);
+            double w = i * 0.5;
+            switch (i % 4) {
+                case 0: v.push_back(i, w, name); break;
+                case 1: v.push_back(int(i), double(w), std::string(name)); break;
+                case 2: v.push_back(row_type(i, w, name)); break;
+                default: v.emplace_back(i, w, name.c_str()); break;
+            }
+            expected.push_back(row_type(i, w, name));
+        }
+        assert(same(v, expected));
+        assert(v.front() == expected[0] && v.back() == expected[49]);
+        assert(v.capacity() >= v.size());
+        assert(column_aligned<0>(v) && column_aligned<1>(v) && column_aligned<2>(v));
+
+        [[maybe_unused]] bool threw = false;
+        try {
+            static_cast<void>(v.at(v.size()));
+        } catch (const std::out_of_range &) {
+            threw = true;
+        }
+        assert(threw);
+
+        v.pop_back();
+        expected.pop_back();
+        assert(same(v, expected));
+        std::cout << "push_back ok" << '\n';
+    }
+    {
+        // reserve keeps the rows and the column alignment
+        soa_type v;
+        zstl::vector<row_type> expected;
+        for (int i = 0; i < 3; ++i) {
+            v.push_back(i, 1.0, name_of(i));
+            expected.push_back(row_type(i, 1.0, name_of(i)));
+        }
+        v.reserve(100uz);
+        assert(v.capacity() == 100uz);
+        assert(same(v, expected));
+        assert(column_aligned<0>(v) && column_aligned<1>(v) && column_aligned<2>(v));
+
+        // smaller requests are ignored
+        v.reserve(10uz);
+        assert(v.capacity() == 100uz);
+        std::cout << "reserve ok" << '\n';
+    }
+    {
+        // erase ranges at the front, the middle and the end
+        soa_type v;
+        zstl::vector<row_type> expected;
+        for (int i = 0; i < 40; ++i) {
+            v.push_back(i, i * 2.0, name_of(i));
+            expected.push_back(row_type(i, i * 2.0, name_of(i)));
+        }
+        const std::size_t ranges[][2] = { { 0uz, 3uz }, { 10uz, 17uz }, { 5uz, 5uz }, { 25uz, 30uz } };
+        for (const auto &r : ranges) {
+            [[maybe_unused]] std::size_t next = v.erase(r[0], r[1]);
+            assert(next == r[0]);
+            erase_rows(expected, r[0], r[1]);
+            assert(same(v, expected));
+        }
+        v.erase(0uz);
+        erase_rows(expected, 0uz, 1uz);
+        assert(same(v, expected));
+        std::cout << "erase ok" << '\n';
+    }
+    {
+        // proxy rows and column spans write into the same storage
+        soa_type v;
+        for (int i = 0; i < 10; ++i) {
+            v.push_back(i, 0.0, name_of(i));
+        }
+        auto [id, weight, name] = v[3];
+        id = 300;
+        weight = 3.5;
+        name = "renamed";
+        assert(v[3] == row_type(300, 3.5, "renamed"));
+
+        std::get<1>(v.at(4)) = 4.5;
+        for (double &w : v.column<1>()) {
+            w += 1.0;
+        }
+        assert(std::get<1>(v[3]) == 4.5 && std::get<1>(v[4]) == 5.5 && std::get<1>(v[0]) == 1.0);
+
+        [[maybe_unused]] const soa_type &cv = v;
+        assert(cv.column<0>().size() == 10uz && cv.column<0>()[3] == 300);
+        std::cout << "proxy rows ok" << '\n';
+    }
+    {
+        // swap exchanges the rows and the resources they were allocated from
+        counting_resource ra, rb;
+        {
+            soa_type a { &ra };
+            soa_type b { &rb };
+            zstl::vector<row_type> ea, eb;
+            for (int i = 0; i < 9; ++i) {
+                a.push_back(i, 1.0, name_of(i));
+                ea.push_back(row_type(i, 1.0, name_of(i)));
+            }
+            for (int i = 0; i < 2; ++i) {
+                b.push_back(-i, 2.0, name_of(-i));
+                eb.push_back(row_type(-i, 2.0, name_of(-i)));
+            }
+            a.swap(b);
+            assert(same(a, eb) && same(b, ea));
+            assert(a.get_allocator().resource() == &rb && b.get_allocator().resource() == &ra);
+
+            // growing after the swap allocates from the swapped-in resource
+            [[maybe_unused]] std::ptrdiff_t before = rb.inUse;
+            for (int i = 0; i < 20; ++i) {
+                a.push_back(i, 3.0, name_of(i));
+            }
+            assert(rb.inUse > before);
+        }
+        assert(ra.inUse == 0 && rb.inUse == 0);
+        std::cout << "swap ok" << '\n';
+    }
+    {
+        // the new row may come from the vector itself while it is full
+        soa_type v;
+        zstl::vector<row_type> expected;
+        for (int i = 0; i < 4; ++i) {
+            v.push_back(i, i * 1.5, name_of(i));
+            expected.push_back(row_type(i, i * 1.5, name_of(i)));
+        }
+        assert(v.size() == v.capacity());
+        {
+            auto [id, weight, name] = v[1];
+            v.emplace_back(id, weight, name);
+            row_type copy = expected[1];
+            expected.push_back(copy);
+        }
+        assert(same(v, expected));
+
+        while (v.size() != v.capacity()) {
+            v.push_back(7, 7.0, name_of(7));
+            expected.push_back(row_type(7, 7.0, name_of(7)));
+        }
+        const auto &[id, weight, name] = std::as_const(v)[0];
+        v.push_back(id, weight, name);
+        row_type copy = expected[0];
+        expected.push_back(copy);
+        assert(same(v, expected));
+        std::cout << "self reference ok" << '\n';
+    }
+    {
+        // a copy that throws during growth leaves the rows and the capacity as they were
+        counting_resource r;
+        {
+            zstl::soa_vector<int, fragile> v { &r };
+            for (int i = 0; i < 4; ++i) {
+                v.emplace_back(i, i);
+            }
+            assert(v.size() == v.capacity() && fragile::live == 4);
+            [[maybe_unused]] std::ptrdiff_t before = r.inUse;
+
+            for (int allowed = 0; allowed < 4; ++allowed) {
+                fragile::copies = allowed;
+                [[maybe_unused]] bool threw = false;
+                try {
+                    v.push_back(9, fragile(9));
+                } catch (const std::runtime_error &) {
+                    threw = true;
+                }
+                fragile::copies = -1;
+                assert(threw && v.size() == 4uz && v.capacity() == 4uz);
+                assert(fragile::live == 4 && r.inUse == before);
+                for (int i = 0; i < 4; ++i) {
+                    assert(std::get<0>(v[i]) == i && std::get<1>(v[i]).value == i);
+                }
+            }
+
+            v.push_back(4, fragile(4));
+            assert(v.size() == 5uz && fragile::live == 5 && std::get<1>(v[4]).value == 4);
+        }
+        assert(fragile::live == 0 && r.inUse == 0);
+        std::cout << "throwing copy ok" << std::endl;
+    }
+
+    return 0;
+}
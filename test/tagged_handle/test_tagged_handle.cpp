@@ -0,0 +1,203 @@
+// In this program, we exercise `zstl::tagged_handle` and `zstl::tagged_arena`
+// Handles are 4 bytes, tag plus offset in GRANULE units from the arena base, so
+//   we check the round trip through make/cast/call/get/raw, the null handle, and
+//   that an arena that is full refuses to allocate
+// A type aligned beyond BASE_ALIGNMENT needs an arena built with its alignment:
+//   we check that such an arena gives aligned objects and that a default one
+//   is refused instead of producing misaligned objects
+
+#include <ZSTL/tagged_handle.hpp>
+
+#include <new>
+#include <vector>
+#include <iostream>
+#include <stdexcept>
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+
+
+struct Circle {
+    double radius { 0.0 };
+
+    double get_area() const {
+        return 3.0 * radius * radius;
+    }
+};
+
+struct Square {
+    double side { 0.0 };
+
+    double get_area() const {
+        return side * side;
+    }
+};
+
+// aligned beyond tagged_arena::BASE_ALIGNMENT
+struct alignas(256) Page {
+    int id { 0 };
+
+    double get_area() const {
+        return static_cast<double>(id);
+    }
+};
+
+// counts the bytes handed out, checking that the region is returned with the
+//   size and alignment it was allocated with
+class counting_resource : public zstl::pmr::memory_resource {
+public:
+    std::ptrdiff_t inUse { 0 };
+    std::size_t lastAlignment { 0uz };
+
+private:
+    void *do_allocate(std::size_t bytes, std::size_t alignment) override {
+        this->inUse += static_cast<std::ptrdiff_t>(bytes);
+        this->lastAlignment = alignment;
+        return zstl::pmr::new_delete_resource()->allocate(bytes, alignment);
+    }
+
+    void do_deallocate(void *p, std::size_t bytes, std::size_t alignment) override {
+        assert(alignment == this->lastAlignment);
+        this->inUse -= static_cast<std::ptrdiff_t>(bytes);
+        zstl::pmr::new_delete_resource()->deallocate(p, bytes, alignment);
+    }
+
+    bool do_is_equal(const zstl::pmr::memory_resource &other) const noexcept override {
+        return this == &other;
+    }
+};
+
+
+int main() {
+    using shape = zstl::tagged_handle<Circle, Square>;
+    static_assert(sizeof(shape) == 4uz);
+    static_assert(shape::GRANULE == alignof(double));
+    static_assert(shape::TAG_BITS == 2uz && shape::OFFSET_BITS == 30uz);
+    static_assert(shape::max_arena_size() == (std::size_t { 1u } << 30) * alignof(double));
+
+    {
+        // make/cast/call/get round trip for every type
+        zstl::tagged_arena arena(1uz << 16);
+        assert(arena.alignment() == zstl::tagged_arena::BASE_ALIGNMENT);
+        assert(reinterpret_cast<std::uintptr_t>(arena.data()) % arena.alignment() == 0u);
+
+        std::vector<shape> handles;
+        for (int i = 0; i < 100; ++i) {
+            handles.push_back(
+                i % 2 == 0
+                    ? shape::make<Circle>(arena, static_cast<double>(i))
+                    : shape::make<Square>(arena, static_cast<double>(i))
+            );
+        }
+
+        for (int i = 0; i < 100; ++i) {
+            shape h = handles[i];
+            [[maybe_unused]] double x = static_cast<double>(i);
+            if (i % 2 == 0) {
+                assert(h.tag() == shape::get_type_tag<Circle>() && h.points_to_type<Circle>());
+                assert(h.cast<Circle>(arena)->radius == x && h.cast<Square>(arena) == nullptr);
+            } else {
+                assert(h.tag() == shape::get_type_tag<Square>() && h.points_to_type<Square>());
+                assert(h.cast<Square>(arena)->side == x && h.cast<Circle>(arena) == nullptr);
+            }
+            assert(arena.contains(h.ptr(arena)));
+
+            [[maybe_unused]] double area = h.call(arena, [](const auto *s) { return s->get_area(); });
+            assert(area == (i % 2 == 0 ? 3.0 * x * x : x * x));
+
+            // the 8-byte tagged_ptr points at the same object
+            [[maybe_unused]] shape::pointer p = h.get(arena);
+            assert(p.tag() == h.tag() && p.ptr() == h.ptr(arena));
+
+            // a handle rebuilt from the pointer, or from its raw word, is the same handle
+            if (i % 2 == 0) {
+                assert(shape(arena, h.cast<Circle>(arena)) == h);
+            } else {
+                assert(shape(arena, h.cast<Square>(arena)) == h);
+            }
+            assert(shape::from_raw(h.raw()) == h);
+        }
+
+        // a non-const arena hands out pointers that write into the object
+        handles[4].call(arena, [](auto *s) { *s = {}; });
+        handles[6].cast<Circle>(arena)->radius = -1.0;
+        [[maybe_unused]] const zstl::tagged_arena &carena = arena;
+        assert(handles[4].cast<Circle>(carena)->radius == 0.0);
+        assert(handles[6].cast<Circle>(carena)->radius == -1.0);
+        std::cout << "make/cast/call/get ok" << '\n';
+    }
+    {
+        // the null handle
+        zstl::tagged_arena arena(1024uz);
+        shape null;
+        [[maybe_unused]] shape alsoNull = nullptr;
+        assert(null == alsoNull && null.raw() == 0u && null.tag() == 0u);
+        assert(null.get(arena).tag() == 0u);
+        assert(null.cast<Circle>(arena) == nullptr && null.cast<Square>(arena) == nullptr);
+        std::cout << "null handle ok" << '\n';
+    }
+    {
+        // a full arena throws rather than growing
+        zstl::tagged_arena arena(4uz * sizeof(Circle));
+        for (int i = 0; i < 4; ++i) {
+            static_cast<void>(shape::make<Circle>(arena, 1.0));
+        }
+        [[maybe_unused]] bool threw = false;
+        try {
+            static_cast<void>(shape::make<Circle>(arena, 1.0));
+        } catch (const std::bad_alloc &) {
+            threw = true;
+        }
+        assert(threw);
+
+        // release forgets everything and the space is usable again
+        arena.release();
+        [[maybe_unused]] shape h = shape::make<Square>(arena, 2.0);
+        assert(h.cast<Square>(arena)->side == 2.0);
+        std::cout << "full arena ok" << '\n';
+    }
+    {
+        // an over-aligned type: GRANULE is its alignment and the arena base must match
+        using paged = zstl::tagged_handle<Circle, Page>;
+        static_assert(paged::GRANULE == alignof(Page));
+        static_assert(paged::GRANULE > zstl::tagged_arena::BASE_ALIGNMENT);
+
+        counting_resource r;
+        {
+            zstl::tagged_arena arena(1uz << 16, &r, paged::GRANULE);
+            assert(arena.alignment() == alignof(Page) && r.lastAlignment == alignof(Page));
+            assert(reinterpret_cast<std::uintptr_t>(arena.data()) % alignof(Page) == 0u);
+
+            std::vector<paged> handles;
+            for (int i = 0; i < 20; ++i) {
+                handles.push_back(paged::make<Circle>(arena, 1.0));
+                handles.push_back(paged::make<Page>(arena, i));
+            }
+            for (int i = 0; i < 20; ++i) {
+                [[maybe_unused]] const Page *page = handles[2 * i + 1].cast<Page>(arena);
+                assert(reinterpret_cast<std::uintptr_t>(page) % alignof(Page) == 0u);
+                assert(page->id == i);
+                assert(handles[2 * i].cast<Circle>(arena)->radius == 1.0);
+            }
+        }
+        // the region went back with the alignment it was allocated with
+        assert(r.inUse == 0);
+
+        // a smaller alignment than BASE_ALIGNMENT is rounded up
+        zstl::tagged_arena small(1024uz, zstl::pmr::get_default_resource(), 8uz);
+        assert(small.alignment() == zstl::tagged_arena::BASE_ALIGNMENT);
+
+        // an arena aligned only to BASE_ALIGNMENT is refused
+        zstl::tagged_arena arena(1uz << 16);
+        [[maybe_unused]] bool threw = false;
+        try {
+            static_cast<void>(paged::make<Page>(arena, 1));
+        } catch (const std::invalid_argument &) {
+            threw = true;
+        }
+        assert(threw);
+        std::cout << "over-aligned type ok" << std::endl;
+    }
+
+    return 0;
+}
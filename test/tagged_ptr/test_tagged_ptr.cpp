@@ -13,11 +13,22 @@
 //   without the storage overhead of virtual function pointers,
 //   which is stored for every pointer to an abstract base type
 
+// every call/call_likely in this program records its tag in zstl::dispatch_profile
+#define ZSTL_TAGGED_PTR_PROFILE
+
 #include <ZSTL/tagged_ptr.hpp>
+#include <ZSTL/tagged_ptr_prefetch.hpp>
 
+#include <array>
+#include <thread>
+#include <vector>
 #include <iostream>
 #include <numbers>
 #include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <stdexcept>
+#include <type_traits>
 
 
 // `Circle` class, which would traditionally inherit from `Shape`
@@ -109,6 +120,25 @@ struct Shape
 };
 
 
+// `Node<N>` types, to have more types than `call` handles with a switch
+template <int N>
+struct Node {
+    int id { N };
+};
+
+// Node<1> ... Node<10>: ten types, so `call` goes through the table of thunks
+using Node10 = zstl::tagged_ptr<
+    Node<1>, Node<2>, Node<3>, Node<4>, Node<5>,
+    Node<6>, Node<7>, Node<8>, Node<9>, Node<10>
+>;
+
+// `Aligned<N>` types, whose 16-byte alignment leaves 4 low bits of every pointer zero
+template <int N>
+struct alignas(16) Aligned {
+    int id { N };
+};
+
+
 int main() {
     // No need to handle `Shape` behind a pointer or reference,
     //   unlike if `Shape` was an abstract base class
@@ -182,6 +212,338 @@ int main() {
         std::cout << "the pointer value is " << my_shape2.ptr() << "\n\n";
     }
 
+    {
+        // More than SWITCH_DISPATCH_MAX types: `call` indexes a table of thunks by tag
+        static_assert(Node10::number_of_types() > zstl::detail::tagged_ptr::SWITCH_DISPATCH_MAX);
+
+        Node<1> n1;
+        Node<2> n2;
+        Node<3> n3;
+        Node<4> n4;
+        Node<5> n5;
+        Node<6> n6;
+        Node<7> n7;
+        Node<8> n8;
+        Node<9> n9;
+        Node<10> n10;
+        const Node10 nodes[] { &n1, &n2, &n3, &n4, &n5, &n6, &n7, &n8, &n9, &n10 };
+
+        for (int i = 0; i < 10; ++i) {
+            Node10 p = nodes[i];
+            assert(p.tag() == static_cast<std::uint64_t>(i + 1));
+
+            // every tag reaches the thunk of its own type, the last one included
+            [[maybe_unused]] int id = p.call(
+                [](auto ptr) {
+                    static_assert(!std::is_const_v<std::remove_pointer_t<decltype(ptr)>>);
+                    return ptr->id;
+                }
+            );
+            assert(id == i + 1);
+
+            // a const tagged_ptr hands out `const T *`
+            const Node10 &cp = p;
+            [[maybe_unused]] int constId = cp.call(
+                [](auto ptr) {
+                    static_assert(std::is_const_v<std::remove_pointer_t<decltype(ptr)>>);
+                    return ptr->id;
+                }
+            );
+            assert(constId == i + 1);
+        }
+
+        // the call writes through the pointer it was given
+        Node10 p = &n9;
+        p.call([](auto ptr) { ptr->id = -ptr->id; });
+        assert(n9.id == -9 && n8.id == 8 && n10.id == 10);
+        std::cout << "dispatch through the thunk table over " << Node10::number_of_types() << " types" << '\n';
+    }
+
+    {
+        // tag_low_bits: the tag lives in the alignment bits, the address is untouched
+        using low_ptr = zstl::basic_tagged_ptr<zstl::tag_low_bits, Aligned<1>, Aligned<2>, Aligned<3>>;
+        static_assert(low_ptr::LOW_TAG_BITS == 4uz && low_ptr::HIGH_TAG_BITS == 0uz);
+        static_assert(low_ptr::ADDRESS_BITS == 64uz);
+        static_assert(low_ptr::max_number_of_types() == 15uz);
+
+        Aligned<1> a1;
+        Aligned<2> a2;
+        Aligned<3> a3;
+        [[maybe_unused]] low_ptr p1 = &a1;
+        [[maybe_unused]] low_ptr p2 = &a2;
+        [[maybe_unused]] low_ptr p3 = &a3;
+        assert(p1.tag() == 1u && p2.tag() == 2u && p3.tag() == 3u);
+        assert(p1.ptr() == &a1 && p2.ptr() == &a2 && p3.ptr() == &a3);
+        assert(p2.cast<Aligned<2>>() == &a2 && p2.cast<Aligned<1>>() == nullptr);
+        assert(p3.call([](auto ptr) { return ptr->id; }) == 3);
+
+        low_ptr null;
+        assert(null.tag() == 0u && null.ptr() == nullptr && null.raw() == 0u);
+        assert(low_ptr::from_raw(p2.raw()) == p2);
+        std::cout << "tag_low_bits ok" << '\n';
+    }
+    {
+        // tag_hybrid_bits<3>: 2 alignment bits of a 4-byte aligned Node plus 3 high bits,
+        //   so tags above 3 spill into the high bits
+        using hybrid_ptr = zstl::basic_tagged_ptr<
+            zstl::tag_hybrid_bits<3uz>,
+            Node<1>, Node<2>, Node<3>, Node<4>, Node<5>,
+            Node<6>, Node<7>, Node<8>, Node<9>, Node<10>
+        >;
+        static_assert(hybrid_ptr::LOW_TAG_BITS == 2uz && hybrid_ptr::HIGH_TAG_BITS == 3uz);
+        static_assert(hybrid_ptr::ADDRESS_BITS == 61uz);
+        static_assert(hybrid_ptr::max_number_of_types() == 31uz);
+
+        Node<1> n1;
+        Node<2> n2;
+        Node<3> n3;
+        Node<4> n4;
+        Node<5> n5;
+        Node<6> n6;
+        Node<7> n7;
+        Node<8> n8;
+        Node<9> n9;
+        Node<10> n10;
+        const hybrid_ptr nodes[] { &n1, &n2, &n3, &n4, &n5, &n6, &n7, &n8, &n9, &n10 };
+        [[maybe_unused]] const void *addresses[] { &n1, &n2, &n3, &n4, &n5, &n6, &n7, &n8, &n9, &n10 };
+
+        for (int i = 0; i < 10; ++i) {
+            [[maybe_unused]] const hybrid_ptr &p = nodes[i];
+            assert(p.tag() == static_cast<std::uint64_t>(i + 1));
+            assert(p.ptr() == addresses[i]);
+            assert(p.call([](auto ptr) { return ptr->id; }) == i + 1);
+        }
+        assert(nodes[8].cast<Node<9>>() == &n9 && nodes[8].cast<Node<5>>() == nullptr);
+        std::cout << "tag_hybrid_bits ok" << '\n';
+    }
+    {
+        // A layout that leaves fewer address bits than the host uses throws on
+        //   construction, and the error can be caught
+        using wide_ptr = zstl::basic_tagged_ptr<zstl::tag_high_bits<12uz>, Node<1>>;
+        static_assert(wide_ptr::ADDRESS_BITS == 52uz);
+
+        Node<1> n;
+        [[maybe_unused]] bool threw = false;
+        try {
+            [[maybe_unused]] wide_ptr p = &n;
+            assert(p.ptr() == &n && p.tag() == 1u);
+        } catch (const std::runtime_error &) {
+            threw = true;
+        }
+        assert(threw == (zstl::user_address_bits() > wide_ptr::ADDRESS_BITS));
+
+        // nullptr never needs the check
+        [[maybe_unused]] wide_ptr null = nullptr;
+        assert(null.tag() == 0u);
+        std::cout << "address space check ok (" << zstl::user_address_bits() << "-bit user space)" << '\n';
+    }
+
+    {
+        // zstl::dispatch over three arguments of different type lists and layouts:
+        //   a Shape (derived from tagged_ptr), a Node10 and a tag_low_bits pointer
+        using pair_ptr = zstl::basic_tagged_ptr<zstl::tag_low_bits, Circle, Rectangle>;
+
+        auto identify = [](const auto *shape, auto *node, const auto *pair) {
+            // const arguments give `const T *`, non-const ones `T *`
+            static_assert(std::is_const_v<std::remove_pointer_t<decltype(shape)>>);
+            static_assert(!std::is_const_v<std::remove_pointer_t<decltype(node)>>);
+            std::size_t a = Shape::get_type_tag<std::remove_cvref_t<decltype(*shape)>>();
+            std::size_t c = pair_ptr::get_type_tag<std::remove_cvref_t<decltype(*pair)>>();
+            return a * 1000uz + static_cast<std::size_t>(node->id) * 10uz + c;
+        };
+
+        // the table is row-major in argument order: the last argument varies fastest
+        using table = zstl::detail::tagged_ptr::multi_call_table<
+            decltype(identify),
+            zstl::detail::tagged_ptr::slot_for_t<const Shape &>,
+            zstl::detail::tagged_ptr::slot_for_t<Node10 &>,
+            zstl::detail::tagged_ptr::slot_for_t<const pair_ptr &>
+        >;
+        static_assert(table::RANK == 3uz);
+        static_assert(table::SIZES == std::array { 3uz, 10uz, 2uz });
+        static_assert(table::STRIDES == std::array { 20uz, 2uz, 1uz });
+        static_assert(table::SIZE == 60uz && table::thunks.size() == 60uz);
+
+        Circle circle { .radius = 1.0 };
+        RightTriangle triangle { .base = 1.0, .height = 1.0 };
+        Rectangle rectangle { .width = 1.0, .height = 1.0 };
+        const Shape shapes[] { &circle, &triangle, &rectangle };
+        const pair_ptr pairs[] { &circle, &rectangle };
+
+        Node<1> n1;
+        Node<2> n2;
+        Node<3> n3;
+        Node<4> n4;
+        Node<5> n5;
+        Node<6> n6;
+        Node<7> n7;
+        Node<8> n8;
+        Node<9> n9;
+        Node<10> n10;
+        Node10 nodes[] { &n1, &n2, &n3, &n4, &n5, &n6, &n7, &n8, &n9, &n10 };
+
+        // every one of the 60 combinations reaches the thunk of its own types,
+        //   each pointer in its own position
+        for (std::size_t a { 0uz }; a < 3uz; ++a) {
+            for (std::size_t b { 0uz }; b < 10uz; ++b) {
+                for (std::size_t c { 0uz }; c < 2uz; ++c) {
+                    [[maybe_unused]] std::size_t got = zstl::dispatch(identify, shapes[a], nodes[b], pairs[c]);
+                    assert(got == (a + 1uz) * 1000uz + (b + 1uz) * 10uz + (c + 1uz));
+                }
+            }
+        }
+
+        // the pointers handed over are the objects themselves, and writes go through
+        zstl::dispatch(
+            [](const auto *shape, auto *node) {
+                static_cast<void>(shape);
+                node->id += 100;
+            },
+            shapes[2], nodes[6]
+        );
+        assert(n7.id == 107 && n6.id == 6 && n8.id == 8);
+        [[maybe_unused]] const void *seen = zstl::dispatch([](auto *node) -> const void * { return node; }, nodes[3]);
+        assert(seen == &n4);
+        std::cout << "multiple dispatch ok" << '\n';
+    }
+
+    {
+        // call_likely tests the likely types first and falls back to call for the rest,
+        //   both with the switch (Shape, 3 types) and the thunk table (Node10)
+        Circle circle { .radius = 1.0 };
+        RightTriangle triangle { .base = 2.0, .height = 3.0 };
+        Rectangle rectangle { .width = 2.0, .height = 5.0 };
+        const Shape shapes[] { &circle, &triangle, &rectangle };
+        for (const Shape &s : shapes) {
+            [[maybe_unused]] double area = s.call([](auto ptr) { return ptr->get_area(); });
+            assert(s.call_likely<Rectangle>([](auto ptr) { return ptr->get_area(); }) == area);
+            [[maybe_unused]] double likely = s.call_likely<Rectangle, Circle>([](auto ptr) { return ptr->get_area(); });
+            assert(likely == area);
+        }
+
+        Node<1> n1;
+        Node<2> n2;
+        Node<3> n3;
+        Node<4> n4;
+        Node<5> n5;
+        Node<6> n6;
+        Node<7> n7;
+        Node<8> n8;
+        Node<9> n9;
+        Node<10> n10;
+        Node10 nodes[] { &n1, &n2, &n3, &n4, &n5, &n6, &n7, &n8, &n9, &n10 };
+        for (int i = 0; i < 10; ++i) {
+            auto id = [](auto ptr) { return ptr->id; };
+            assert(nodes[i].call_likely<Node<7>>(id) == i + 1);
+            [[maybe_unused]] int likely = nodes[i].call_likely<Node<7>, Node<2>, Node<10>>(id);
+            assert(likely == i + 1);
+            [[maybe_unused]] const Node10 &cp = nodes[i];
+            assert(cp.call_likely<Node<1>>(id) == i + 1);
+        }
+        // the fallback hands out a writable pointer too
+        nodes[4].call_likely<Node<7>>([](auto ptr) { ptr->id = 50; });
+        assert(n5.id == 50);
+        std::cout << "call_likely ok" << '\n';
+    }
+    {
+        // dispatch_profile: counts()[tag], [0] for nullptr, summed over running and
+        //   exited threads; ranking() lists the tags hottest first
+        using profile = zstl::dispatch_profile<Circle, RightTriangle, Rectangle>;
+        static_assert(profile::N_TAGS == 4uz);
+        profile::reset();
+        assert(profile::counts() == (profile::counts_type { 0u, 0u, 0u, 0u }));
+
+        Circle circle { .radius = 1.0 };
+        RightTriangle triangle { .base = 2.0, .height = 3.0 };
+        Rectangle rectangle { .width = 2.0, .height = 5.0 };
+        const Shape c = &circle;
+        const Shape t = &triangle;
+        const Shape r = &rectangle;
+        auto area = [](auto ptr) { return ptr->get_area(); };
+
+        for (int i = 0; i < 5; ++i) {
+            static_cast<void>(r.call(area));
+        }
+        for (int i = 0; i < 3; ++i) {
+            static_cast<void>(c.call_likely<Rectangle>(area));
+        }
+        static_cast<void>(t.get_area());
+        assert(profile::counts() == (profile::counts_type { 0u, 3u, 1u, 5u }));
+        assert(profile::ranking() == (std::array { 3uz, 1uz, 2uz }));
+
+        // a thread that has exited still counts
+        std::thread worker(
+            [&]() {
+                for (int i = 0; i < 7; ++i) {
+                    static_cast<void>(t.call(area));
+                }
+            }
+        );
+        worker.join();
+        assert(profile::counts() == (profile::counts_type { 0u, 3u, 8u, 5u }));
+        assert(profile::ranking() == (std::array { 2uz, 3uz, 1uz }));
+
+        // ties keep tag order
+        profile::reset();
+        assert(profile::counts() == (profile::counts_type { 0u, 0u, 0u, 0u }));
+        assert(profile::ranking() == (std::array { 1uz, 2uz, 3uz }));
+
+        // another list of types has its own counters
+        static_cast<void>(c.call(area));
+        assert(profile::counts()[1] == 1u);
+        assert((zstl::dispatch_profile<Node<1>, Node<2>>::counts()[1] == 0u));
+        std::cout << "dispatch_profile ok" << '\n';
+    }
+
+    {
+        // for_each_prefetched/reduce_prefetched visit every element once, in order,
+        //   whatever the distance: 0, inside the range, equal to it or beyond it
+        Node<1> n1;
+        Node<2> n2;
+        Node<3> n3;
+        Node<4> n4;
+        Node<5> n5;
+        Node<6> n6;
+        Node<7> n7;
+        Node<8> n8;
+        Node<9> n9;
+        Node<10> n10;
+        std::vector<Node10> nodes;
+        for (int i = 0; i < 3; ++i) {
+            nodes.insert(nodes.end(), { &n1, &n2, &n3, &n4, &n5, &n6, &n7, &n8, &n9, &n10 });
+        }
+        const std::size_t n = nodes.size();
+        [[maybe_unused]] auto id = [](const auto *ptr) { return ptr->id; };
+
+        for (std::size_t distance : { 0uz, 1uz, 7uz, n - 1uz, n, n + 1uz, 1000uz }) {
+            std::vector<int> seen;
+            zstl::for_each_prefetched(nodes, [&](const auto *ptr) { seen.push_back(ptr->id); }, distance);
+            assert(seen.size() == n);
+            for (std::size_t i { 0uz }; i < n; ++i) {
+                assert(seen[i] == static_cast<int>(i % 10uz) + 1);
+            }
+            assert(zstl::reduce_prefetched(nodes, 0, id, distance) == 3 * 55);
+        }
+
+        // the default distance (32) is larger than this range as well
+        static_assert(zstl::DEFAULT_PREFETCH_DISTANCE > 30uz);
+        assert(zstl::reduce_prefetched(nodes, 100, id) == 100 + 3 * 55);
+
+        // an empty range calls nothing and returns init
+        std::vector<Node10> none;
+        for (std::size_t distance : { 0uz, 1uz, zstl::DEFAULT_PREFETCH_DISTANCE }) {
+            bool called = false;
+            zstl::for_each_prefetched(none, [&](const auto *) { called = true; }, distance);
+            assert(!called);
+            assert(zstl::reduce_prefetched(none, 42, id, distance) == 42);
+        }
+
+        // non-const elements give writable pointers; every node is in the range 3 times
+        zstl::for_each_prefetched(nodes, [](auto *ptr) { ptr->id *= 2; }, 4uz);
+        assert(n1.id == 8 && n10.id == 80);
+        std::cout << "prefetched traversal ok" << '\n';
+    }
+
     std::cout << "the size of Shape is " << sizeof(Shape) << " bytes"<< '\n';
     std::cout << "the size of Circle is " << sizeof(Circle) << " bytes"<< '\n';
     std::cout << "the size of RightTriangle is " << sizeof(RightTriangle) << " bytes" << '\n';
@@ -0,0 +1,216 @@
+// In this program, we group a mixed collection of `zstl::tagged_ptr` by type
+//   with `zstl::tagged_ptr_groups` and check that every group keeps input order,
+//   that positions<T>() maps each group back to the input and that null
+//   pointers are counted but never visited
+// Calling assign() again on a collection of the same shape must reuse the
+//   buffers, which we see through a counting memory resource
+
+#include <ZSTL/tagged_ptr_groups.hpp>
+
+#include <vector>
+#include <iostream>
+#include <cassert>
+#include <cstddef>
+
+
+struct Circle {
+    int id { 0 };
+};
+
+struct Square {
+    int id { 0 };
+};
+
+struct Triangle {
+    int id { 0 };
+};
+
+using shape_ptr = zstl::tagged_ptr<Circle, Square, Triangle>;
+using groups_type = zstl::tagged_ptr_groups<Circle, Square, Triangle>;
+
+// derived from the tagged_ptr, as the collections in test_tagged_ptr are
+struct Shape : shape_ptr {
+    using shape_ptr::shape_ptr;
+};
+
+// counts the allocations it serves and the bytes still handed out
+class counting_resource : public zstl::pmr::memory_resource {
+public:
+    std::size_t allocations { 0uz };
+    std::ptrdiff_t inUse { 0 };
+
+private:
+    void *do_allocate(std::size_t bytes, std::size_t alignment) override {
+        ++(this->allocations);
+        this->inUse += static_cast<std::ptrdiff_t>(bytes);
+        return zstl::pmr::new_delete_resource()->allocate(bytes, alignment);
+    }
+
+    void do_deallocate(void *p, std::size_t bytes, std::size_t alignment) override {
+        this->inUse -= static_cast<std::ptrdiff_t>(bytes);
+        zstl::pmr::new_delete_resource()->deallocate(p, bytes, alignment);
+    }
+
+    bool do_is_equal(const zstl::pmr::memory_resource &other) const noexcept override {
+        return this == &other;
+    }
+};
+
+// every group<T>()[k] is ptrs[positions<T>()[k]], the positions increase,
+//   and together with the nulls the groups cover the input
+template <typename T, typename Range>
+bool maps_back(const groups_type &groups, const Range &ptrs) {
+    std::span<const T *const> g = groups.group<T>();
+    std::span<const groups_type::position_type> pos = groups.positions<T>();
+    if (g.size() != pos.size()) {
+        return false;
+    }
+    for (std::size_t k { 0uz }; k < g.size(); ++k) {
+        if (ptrs[pos[k]].template cast<T>() != g[k]) {
+            return false;
+        }
+        if (k > 0uz && pos[k - 1uz] >= pos[k]) {
+            return false;
+        }
+    }
+    return true;
+}
+
+
+int main() {
+    std::vector<Circle> circles(20);
+    std::vector<Square> squares(20);
+    std::vector<Triangle> triangles(20);
+    for (int i = 0; i < 20; ++i) {
+        circles[i].id = i;
+        squares[i].id = 100 + i;
+        triangles[i].id = 200 + i;
+    }
+
+    // an irregular mix with null pointers at the ends and in between
+    std::vector<Shape> shapes;
+    shapes.push_back(nullptr);
+    for (int i = 0; i < 20; ++i) {
+        switch ((i * 7) % 5) {
+            case 0: shapes.push_back(&squares[i]); break;
+            case 1: shapes.push_back(nullptr); break;
+            case 2: shapes.push_back(&circles[i]); break;
+            default: shapes.push_back(&triangles[i]); break;
+        }
+    }
+    shapes.push_back(&circles[0]);
+    shapes.push_back(nullptr);
+
+    {
+        // null pointers are counted, not visited
+        groups_type groups(shapes);
+        std::size_t nulls { 0uz }, nCircles { 0uz }, nSquares { 0uz }, nTriangles { 0uz };
+        for (const Shape &s : shapes) {
+            nulls += s.ptr() == nullptr;
+            nCircles += s.points_to_type<Circle>();
+            nSquares += s.points_to_type<Square>();
+            nTriangles += s.points_to_type<Triangle>();
+        }
+        assert(groups.size() == shapes.size() && groups.null_count() == nulls);
+        assert(groups.group<Circle>().size() == nCircles);
+        assert(groups.group<Square>().size() == nSquares);
+        assert(groups.group<Triangle>().size() == nTriangles);
+
+        std::size_t visited { 0uz };
+        groups.for_each(
+            [&visited]([[maybe_unused]] const auto *p) {
+                assert(p != nullptr);
+                ++visited;
+            }
+        );
+        assert(visited == shapes.size() - nulls);
+
+        // a collection of nulls only
+        std::vector<shape_ptr> none(5uz, shape_ptr(nullptr));
+        groups.assign(none);
+        assert(groups.size() == 5uz && groups.null_count() == 5uz);
+        assert(groups.group<Circle>().empty() && groups.positions<Square>().empty());
+        visited = 0uz;
+        groups.visit([&visited](auto) { ++visited; });
+        assert(visited == 0uz);
+        std::cout << "null pointers ok" << '\n';
+    }
+    {
+        // positions<T>() maps every group back to its input order
+        groups_type groups(shapes);
+        assert((maps_back<Circle>(groups, shapes)));
+        assert((maps_back<Square>(groups, shapes)));
+        assert((maps_back<Triangle>(groups, shapes)));
+        assert(groups.null_count()
+            + groups.group<Circle>().size()
+            + groups.group<Square>().size()
+            + groups.group<Triangle>().size() == shapes.size());
+
+        // scattering through the positions rebuilds the ids of the input
+        std::vector<int> ids(shapes.size(), -1);
+        auto scatter = [&]<typename T>() {
+            std::span<const T *const> g = groups.group<T>();
+            std::span<const groups_type::position_type> pos = groups.positions<T>();
+            for (std::size_t k { 0uz }; k < g.size(); ++k) {
+                ids[pos[k]] = g[k]->id;
+            }
+        };
+        scatter.operator()<Circle>();
+        scatter.operator()<Square>();
+        scatter.operator()<Triangle>();
+        for (std::size_t i { 0uz }; i < shapes.size(); ++i) {
+            [[maybe_unused]] int expected { -1 };
+            if (const Circle *c = shapes[i].cast<Circle>()) {
+                expected = c->id;
+            } else if (const Square *q = shapes[i].cast<Square>()) {
+                expected = q->id;
+            } else if (const Triangle *t = shapes[i].cast<Triangle>()) {
+                expected = t->id;
+            }
+            assert(ids[i] == expected);
+        }
+        std::cout << "positions ok" << '\n';
+    }
+    {
+        // assign() again on a collection of the same shape allocates nothing
+        counting_resource r;
+        {
+            groups_type groups { zstl::pmr::polymorphic_allocator<std::byte>(&r) };
+            groups.assign(shapes);
+            [[maybe_unused]] std::size_t allocations = r.allocations;
+            assert(allocations > 0uz);
+
+            std::vector<Shape> reversed(shapes.rbegin(), shapes.rend());
+            groups.assign(reversed);
+            assert(r.allocations == allocations);
+            assert((maps_back<Circle>(groups, reversed)));
+            assert((maps_back<Triangle>(groups, reversed)));
+
+            // nor does a smaller one
+            std::vector<Shape> half(shapes.begin(), shapes.begin() + shapes.size() / 2);
+            groups.assign(half);
+            assert(r.allocations == allocations && groups.size() == half.size());
+            assert((maps_back<Square>(groups, half)));
+        }
+        assert(r.inUse == 0);
+        std::cout << "reassign ok" << '\n';
+    }
+    {
+        // for_each_grouped allocates from the default resource unless told otherwise
+        counting_resource r;
+        zstl::pmr::memory_resource *previous = zstl::pmr::set_default_resource(&r);
+        int sum { 0 };
+        zstl::for_each_grouped(shapes, [&sum](const auto *p) { sum += p->id; });
+        zstl::pmr::set_default_resource(previous);
+        assert(r.allocations > 0uz && r.inUse == 0);
+
+        counting_resource other;
+        int otherSum { 0 };
+        zstl::for_each_grouped(shapes, [&otherSum](const auto *p) { otherSum += p->id; }, &other);
+        assert(other.allocations > 0uz && otherSum == sum);
+        assert(r.allocations == other.allocations);
+        std::cout << "for_each_grouped ok" << std::endl;
+    }
+
+    return 0;
+}
@@ -0,0 +1,188 @@
+// In this program, we exercise `zstl::tagged_unique_ptr` and `zstl::tagged_shared_ptr`
+// The owned object is destroyed through its tag, so we count destructor calls
+//   per type, and check that an over-aligned type gets its alignment and that
+//   memory goes back to the resource it came from
+// For `tagged_shared_ptr` we also follow use_count across copies, self-assignment,
+//   moves and reset
+
+#include <ZSTL/tagged_unique_ptr.hpp>
+#include <ZSTL/tagged_shared_ptr.hpp>
+
+#include <iostream>
+#include <utility>
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+
+
+// counts live objects of each type, so that a destructor run through the wrong
+//   tag, a leak or a double destruction shows up
+template <int N>
+struct tracked {
+    static inline int live { 0 };
+
+    int value { N };
+
+    tracked() { ++live; }
+    explicit tracked(int value) : value(value) { ++live; }
+    ~tracked() { --live; }
+};
+
+// a type aligned beyond the header in front of it
+struct alignas(64) wide {
+    static inline int live { 0 };
+
+    int value { 0 };
+    std::byte payload[60] {};
+
+    wide() { ++live; }
+    ~wide() { --live; }
+};
+
+// counts the bytes and blocks handed out, checking that every block is returned
+//   with the size and alignment it was allocated with
+class counting_resource : public zstl::pmr::memory_resource {
+public:
+    std::ptrdiff_t inUse { 0 };
+    int blocks { 0 };
+
+private:
+    void *do_allocate(std::size_t bytes, std::size_t alignment) override {
+        this->inUse += static_cast<std::ptrdiff_t>(bytes);
+        ++this->blocks;
+        return zstl::pmr::new_delete_resource()->allocate(bytes, alignment);
+    }
+
+    void do_deallocate(void *p, std::size_t bytes, std::size_t alignment) override {
+        this->inUse -= static_cast<std::ptrdiff_t>(bytes);
+        --this->blocks;
+        zstl::pmr::new_delete_resource()->deallocate(p, bytes, alignment);
+    }
+
+    bool do_is_equal(const zstl::pmr::memory_resource &other) const noexcept override {
+        return this == &other;
+    }
+};
+
+
+int main() {
+    using unique = zstl::tagged_unique_ptr<tracked<1>, tracked<2>, wide>;
+    using shared = zstl::tagged_shared_ptr<tracked<1>, tracked<2>, wide>;
+
+    {
+        // the tag picks the destructor of the owned type and only that one
+        {
+            unique a = unique::make<tracked<1>>(10);
+            unique b = unique::make<tracked<2>>(20);
+            unique c = unique::make<tracked<2>>();
+            assert(tracked<1>::live == 1 && tracked<2>::live == 2);
+            assert(a.tag() == 1u && b.tag() == 2u && c.tag() == 2u);
+            assert(a.cast<tracked<1>>()->value == 10 && a.cast<tracked<2>>() == nullptr);
+            assert(b.call([](const auto *p) { return p->value; }) == 20);
+
+            b.reset();
+            assert(!b && b.tag() == 0u);
+            assert(tracked<1>::live == 1 && tracked<2>::live == 1);
+
+            // move transfers ownership, move-assign destroys the old object first
+            unique d(std::move(a));
+            assert(!a && d.points_to_type<tracked<1>>());
+            c = std::move(d);
+            assert(!d && c.points_to_type<tracked<1>>());
+            assert(tracked<1>::live == 1 && tracked<2>::live == 0);
+        }
+        assert(tracked<1>::live == 0 && tracked<2>::live == 0);
+        std::cout << "unique destruction per tag ok" << '\n';
+    }
+    {
+        // an over-aligned type lands on its alignment with the header still in front
+        counting_resource r;
+        {
+            unique w = unique::allocate<wide>(zstl::pmr::polymorphic_allocator<std::byte>(&r));
+            shared s = shared::allocate<wide>(zstl::pmr::polymorphic_allocator<std::byte>(&r));
+            assert(wide::live == 2 && r.blocks == 2);
+            assert(reinterpret_cast<std::uintptr_t>(w.cast<wide>()) % alignof(wide) == 0u);
+            assert(reinterpret_cast<std::uintptr_t>(s.cast<wide>()) % alignof(wide) == 0u);
+            assert(s.use_count() == 1uz);
+        }
+        assert(wide::live == 0);
+        assert(r.blocks == 0 && r.inUse == 0);
+        std::cout << "over-aligned type ok" << '\n';
+    }
+    {
+        // objects from allocate go back to their own resource, not to new/delete
+        counting_resource r1;
+        counting_resource r2;
+        {
+            unique a = unique::allocate<tracked<1>>(zstl::pmr::polymorphic_allocator<std::byte>(&r1), 1);
+            unique b = unique::allocate<tracked<2>>(zstl::pmr::polymorphic_allocator<std::byte>(&r2), 2);
+            shared c = shared::allocate<tracked<2>>(zstl::pmr::polymorphic_allocator<std::byte>(&r2), 3);
+            assert(r1.blocks == 1 && r2.blocks == 2);
+
+            // swapping owners does not swap where the objects return to
+            a.swap(b);
+            a.reset();
+            assert(r1.blocks == 1 && r2.blocks == 1);
+            c.reset();
+            assert(r2.blocks == 0 && r2.inUse == 0);
+            assert(tracked<1>::live == 1 && tracked<2>::live == 0);
+        }
+        assert(r1.blocks == 0 && r1.inUse == 0);
+        assert(tracked<1>::live == 0);
+
+        // make allocates from the default resource, and still frees into it
+        //   once another default is in place
+        zstl::pmr::memory_resource *previous = zstl::pmr::set_default_resource(&r1);
+        {
+            unique a = unique::make<tracked<1>>(4);
+            shared b = shared::make<tracked<2>>(5);
+            assert(r1.blocks == 2);
+            zstl::pmr::set_default_resource(previous);
+        }
+        assert(r1.blocks == 0 && r1.inUse == 0);
+        std::cout << "destruction through the allocating resource ok" << '\n';
+    }
+    {
+        // use_count follows copies, self-assignment, moves and reset
+        {
+            shared a = shared::make<tracked<2>>(7);
+            assert(a.use_count() == 1uz && tracked<2>::live == 1);
+
+            shared b(a);
+            shared c;
+            c = b;
+            assert(a.use_count() == 3uz && c.use_count() == 3uz);
+            assert(a.get() == b.get() && b.get() == c.get());
+
+            // self-assignment keeps the object and the count
+            shared &alias = c;
+            c = alias;
+            assert(c.use_count() == 3uz && tracked<2>::live == 1);
+            assert(c.cast<tracked<2>>()->value == 7);
+
+            // a move leaves the count alone and the source empty
+            shared d(std::move(c));
+            assert(!c && c.use_count() == 0uz && d.use_count() == 3uz);
+            shared e = shared::make<tracked<1>>();
+            e = std::move(d);
+            assert(!d && e.use_count() == 3uz && tracked<1>::live == 0);
+
+            // reset drops one owner; the last one destroys the object
+            a.reset();
+            assert(!a && e.use_count() == 2uz);
+            b.reset();
+            assert(e.use_count() == 1uz && tracked<2>::live == 1);
+            e.reset();
+            assert(tracked<2>::live == 0 && e.use_count() == 0uz);
+
+            // a null shared pointer copies to null
+            shared n = nullptr;
+            shared m(n);
+            assert(!m && m.use_count() == 0uz);
+        }
+        assert(tracked<1>::live == 0 && tracked<2>::live == 0);
+        std::cout << "shared use_count ok" << std::endl;
+    }
+
+    return 0;
+}
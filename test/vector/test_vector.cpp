@@ -0,0 +1,129 @@
+// In this program, we exercise `zstl::vector`
+//   with a focus on the APIs that avoid redundant initialization
+//   when the contents are about to be overwritten anyway (e.g. by `read()`)
+//   and on the parallel construction paths
+
+#include <ZSTL/vector.hpp>
+#include <ZSTL/thread_pool.hpp>
+
+#include <iostream>
+#include <cstring>
+#include <string>
+#include <cassert>
+#include <stdexcept>
+
+
+// `fake_read` stands in for `read()`/`pread()`:
+//   it writes at most `count` bytes into `buf` and returns how many it wrote
+static std::size_t fake_read(char *buf, std::size_t count) {
+    const char message[] = "hello, zstl";
+    std::size_t n = count < sizeof(message) - 1uz ? count : sizeof(message) - 1uz;
+    std::memcpy(buf, message, n);
+    return n;
+}
+
+
+int main() {
+    {
+        zstl::vector<int> v;
+        for (int i = 0; i < 10; ++i) {
+            v.push_back(i);
+        }
+        assert(v.size() == 10uz);
+        assert(v.front() == 0 && v.back() == 9);
+
+        v.resize(12uz, 7);
+        assert(v[10] == 7 && v[11] == 7);
+
+        zstl::vector<int> copy = v;
+        assert(copy.size() == v.size() && copy[11] == 7);
+        std::cout << "push_back/resize/copy ok" << '\n';
+    }
+    {
+        // `resize_for_overwrite` leaves trivial elements uninitialized
+        zstl::vector<char> buf;
+        buf.resize_for_overwrite(64uz);
+        assert(buf.size() == 64uz);
+        std::memset(buf.data(), 'x', buf.size());
+        buf.resize_for_overwrite(8uz);
+        assert(buf.size() == 8uz && buf.back() == 'x');
+        std::cout << "resize_for_overwrite ok" << '\n';
+    }
+    {
+        // `resize_and_overwrite` keeps only what the operation reports
+        zstl::vector<char> buf;
+        buf.resize_and_overwrite(
+            4096uz,
+            [](char *p, std::size_t n) {
+                return fake_read(p, n);
+            }
+        );
+        assert(std::string(buf.begin(), buf.end()) == "hello, zstl");
+
+        // reporting more than was asked for is refused
+        [[maybe_unused]] bool threw = false;
+        try {
+            buf.resize_and_overwrite(
+                16uz,
+                [](char *, std::size_t n) {
+                    return n + 1uz;
+                }
+            );
+        } catch (const std::length_error &) {
+            threw = true;
+        }
+        assert(threw && buf.size() == 16uz);
+        std::cout << "resize_and_overwrite ok" << '\n';
+    }
+    {
+        // `append_uninitialized` hands out fresh capacity after the current elements
+        zstl::vector<char> buf;
+        for (int i = 0; i < 3; ++i) {
+            auto chunk = buf.append_uninitialized(4uz);
+            assert(chunk.size() == 4uz);
+            std::size_t n = fake_read(chunk.data(), chunk.size_bytes());
+            buf.resize(buf.size() - chunk.size() + n);
+        }
+        assert(std::string(buf.begin(), buf.end()) == "hellhellhell");
+        assert(buf.capacity() >= buf.size());
+        std::cout << "append_uninitialized ok" << '\n';
+    }
+    {
+        // non-trivial element types are still default-constructed
+        zstl::vector<std::string> strs;
+        auto fresh = strs.append_uninitialized(3uz);
+        fresh[0] = "a";
+        fresh[2] = "c";
+        assert(strs.size() == 3uz && strs[1].empty() && strs[2] == "c");
+        std::cout << "append_uninitialized (non-trivial) ok" << '\n';
+    }
+    {
+        // parallel fill/copy/transform split the range over a thread pool
+        zstl::thread_pool pool(4u);
+        zstl::parallel_policy policy { .pool = &pool, .min_chunk = 16uz };
+
+        zstl::vector<int> filled(policy, 1000uz, 3);
+        assert(filled.size() == 1000uz && filled[0] == 3 && filled[999] == 3);
+
+        zstl::vector<int> copied(policy, filled);
+        assert(copied.size() == 1000uz && copied[500] == 3);
+
+        zstl::vector<std::string> strs(policy, 100uz, std::string("zstl"));
+        zstl::vector<std::string> strsCopy(policy, strs);
+        assert(strsCopy[99] == "zstl");
+
+        zstl::vector<int> squares;
+        squares.assign_transformed(
+            policy,
+            copied.begin(),
+            copied.end(),
+            [](int x) {
+                return x * x;
+            }
+        );
+        assert(squares.size() == 1000uz && squares[123] == 9);
+        std::cout << "parallel construction ok" << std::endl;
+    }
+
+    return 0;
+}